@@ -8,7 +8,8 @@
  *   - parray<T>: push_back, random access
  *   - pstring: assign, append
  *   - pstringview: intern (AVL lookup)
- *   - Multi-threaded allocator scaling
+ *   - Free-block policies: AvlFreeTree, SizeClassFreeTree, TlsfFreeTree under churn
+ *   - Multi-threaded allocator scaling (with and without per-thread caches)
  *   - Comparison: malloc/free baseline
  *
  * Build:
@@ -34,15 +35,37 @@
 
 // ─── Manager aliases with unique InstanceIds to avoid static-state conflicts ─
 
-using MgrAlloc   = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 100>;
-using MgrDealloc = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 101>;
-using MgrMixed   = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 102>;
-using MgrRealloc = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 103>;
-using MgrBatch   = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 104>;
-using MgrPmap    = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 105>;
-using MgrParray  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 107>;
-using MgrPstring = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 109>;
-using MgrMT      = pmm::PersistMemoryManager<pmm::PersistentDataConfig, 112>;
+using MgrAlloc    = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 100>;
+using MgrDealloc  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 101>;
+using MgrMixed    = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 102>;
+using MgrRealloc  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 103>;
+using MgrBatch    = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 104>;
+using MgrPmap     = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 105>;
+using MgrParray   = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 107>;
+using MgrPstring  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 109>;
+using MgrMT       = pmm::PersistMemoryManager<pmm::PersistentDataConfig, 112>;
+using MgrMTCached = pmm::PersistMemoryManager<pmm::PersistentDataCachedConfig, 113>;
+using MgrMTArena  = pmm::PersistMemoryManager<pmm::ArenaConfig<pmm::PersistentDataConfig, 8>, 114>;
+
+template <typename LockT>
+using LockPolicyConfig = pmm::BasicConfig<pmm::DefaultAddressTraits, LockT, 5, 4, 64, pmm::logging::NoLogging>;
+using MgrMTSpin        = pmm::PersistMemoryManager<LockPolicyConfig<pmm::config::SpinLock>, 120>;
+using MgrMTTicket      = pmm::PersistMemoryManager<LockPolicyConfig<pmm::config::TicketLock>, 121>;
+using MgrMTAdaptive    = pmm::PersistMemoryManager<LockPolicyConfig<pmm::config::AdaptiveLock>, 122>;
+using MgrGrowHeap      = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 123>;
+using MgrGrowReserved  = pmm::PersistMemoryManager<pmm::ReservedHeapConfig<pmm::CacheManagerConfig>, 124>;
+
+template <typename FreeTreeT>
+using FreeTreeConfig = pmm::BasicConfig<pmm::DefaultAddressTraits, pmm::config::NoLock, 5, 4, 64, pmm::logging::NoLogging,
+                                        FreeTreeT>;
+using MgrTreeAvl       = pmm::PersistMemoryManager<FreeTreeConfig<pmm::AvlFreeTree<>>, 115>;
+using MgrTreeSizeClass = pmm::PersistMemoryManager<FreeTreeConfig<pmm::SizeClassFreeTree<>>, 116>;
+using MgrTreeTlsf      = pmm::PersistMemoryManager<FreeTreeConfig<pmm::TlsfFreeTree<>>, 117>;
+using MgrTreeAddr      = pmm::PersistMemoryManager<FreeTreeConfig<pmm::AddressOrderedFreeTree<>>, 118>;
+using MgrPmapNoCheck   = pmm::PersistMemoryManager<
+    pmm::BasicConfig<pmm::DefaultAddressTraits, pmm::config::NoLock, 5, 4, 64, pmm::logging::NoLogging,
+                     pmm::AvlFreeTree<>, pmm::config::NoValidation>,
+    119>;
 
 static constexpr std::size_t HEAP_64MB = 64UL * 1024 * 1024;
 static constexpr std::size_t HEAP_32MB = 32UL * 1024 * 1024;
@@ -177,6 +200,132 @@ static void BM_AllocateBatch( benchmark::State& state )
 }
 BENCHMARK( BM_AllocateBatch )->Arg( 1000 )->Arg( 10000 )->Arg( 100000 );
 
+static void BM_AllocateBatchRun( benchmark::State& state )
+{
+    const auto N = static_cast<int>( state.range( 0 ) );
+    MgrBatch::create( HEAP_64MB );
+
+    std::vector<MgrBatch::pptr<std::uint8_t>> ptrs( N );
+
+    for ( auto _ : state )
+    {
+        MgrBatch::allocate_batch<std::uint8_t>( ptrs, 64 );
+
+        state.PauseTiming();
+        for ( int i = 0; i < N; i++ )
+        {
+            if ( !ptrs[i].is_null() )
+                MgrBatch::deallocate_typed( ptrs[i] );
+        }
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed( state.iterations() * N );
+    MgrBatch::destroy();
+}
+BENCHMARK( BM_AllocateBatchRun )->Arg( 1000 )->Arg( 10000 )->Arg( 100000 );
+
+static void BM_DeallocateBatchRun( benchmark::State& state )
+{
+    const auto N = static_cast<int>( state.range( 0 ) );
+    MgrBatch::create( HEAP_64MB );
+
+    std::vector<MgrBatch::pptr<std::uint8_t>> ptrs( N );
+
+    for ( auto _ : state )
+    {
+        state.PauseTiming();
+        for ( int i = 0; i < N; i++ )
+            ptrs[i] = MgrBatch::allocate_typed<std::uint8_t>( 64 );
+        state.ResumeTiming();
+
+        MgrBatch::deallocate_batch<std::uint8_t>( ptrs );
+    }
+
+    state.SetItemsProcessed( state.iterations() * N );
+    MgrBatch::destroy();
+}
+BENCHMARK( BM_DeallocateBatchRun )->Arg( 1000 )->Arg( 10000 )->Arg( 100000 );
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  Free-block policies: AVL best fit vs size-class lists vs TLSF vs first fit
+// ═════════════════════════════════════════════════════════════════════════════
+
+template <typename MgrT> static void BM_FreeTreeChurn( benchmark::State& state )
+{
+    const auto live_count = static_cast<std::size_t>( state.range( 0 ) );
+    MgrT::create( HEAP_64MB );
+
+    std::vector<typename MgrT::template pptr<std::uint8_t>> live( live_count );
+    std::uint32_t                                           seed = 2024U;
+    for ( auto& p : live )
+    {
+        seed = seed * 1103515245U + 12345U;
+        p    = MgrT::template allocate_typed<std::uint8_t>( 16 + ( seed >> 8 ) % 2048 );
+    }
+
+    auto churn = [&]()
+    {
+        seed       = seed * 1103515245U + 12345U;
+        auto& slot = live[( seed >> 4 ) % live_count];
+        MgrT::deallocate_typed( slot );
+        slot = MgrT::template allocate_typed<std::uint8_t>( 16 + ( seed >> 8 ) % 2048 );
+        return slot;
+    };
+    for ( std::size_t i = 0; i < 4 * live_count; i++ )
+        churn();
+
+    for ( auto _ : state )
+        benchmark::DoNotOptimize( churn() );
+
+    // Heap shape after churn: span = end of the highest live block (the touched
+    // working set), frag_pct = share of that span lost to free holes.
+    std::size_t free_seen = 0, holes = 0, span = 0;
+    MgrT::for_each_block(
+        [&]( const pmm::BlockView& v )
+        {
+            if ( !v.used )
+                free_seen += v.total_size;
+            else
+            {
+                holes = free_seen;
+                span  = static_cast<std::size_t>( v.offset ) + v.total_size;
+            }
+        } );
+    state.counters["frag_pct"] = span == 0 ? 0.0 : 100.0 * double( holes ) / double( span );
+    state.counters["span_mb"] = double( span ) / ( 1024.0 * 1024.0 );
+
+    for ( auto p : live )
+        MgrT::deallocate_typed( p );
+    MgrT::destroy();
+}
+BENCHMARK_TEMPLATE( BM_FreeTreeChurn, MgrTreeAvl )->Arg( 1000 )->Arg( 100000 );
+BENCHMARK_TEMPLATE( BM_FreeTreeChurn, MgrTreeSizeClass )->Arg( 1000 )->Arg( 100000 );
+BENCHMARK_TEMPLATE( BM_FreeTreeChurn, MgrTreeTlsf )->Arg( 1000 )->Arg( 100000 );
+BENCHMARK_TEMPLATE( BM_FreeTreeChurn, MgrTreeAddr )->Arg( 1000 )->Arg( 100000 );
+
+// Grows the image from 64 KB by allocating N 4 KB blocks. HeapStorage copies the
+// whole image on every growth step; ReservedHeapStorage commits pages in place.
+template <typename MgrT> static void BM_GrowImage( benchmark::State& state )
+{
+    std::vector<void*> ptrs( static_cast<std::size_t>( state.range( 0 ) ) );
+    for ( auto _ : state )
+    {
+        MgrT::create( 64 * 1024 );
+        for ( auto& p : ptrs )
+            p = MgrT::allocate( 4096 );
+        benchmark::DoNotOptimize( ptrs.data() );
+        state.PauseTiming();
+        for ( void* p : ptrs )
+            MgrT::deallocate( p );
+        MgrT::shrink_to_fit();
+        MgrT::destroy();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK_TEMPLATE( BM_GrowImage, MgrGrowHeap )->Arg( 1000 )->Arg( 16000 );
+BENCHMARK_TEMPLATE( BM_GrowImage, MgrGrowReserved )->Arg( 1000 )->Arg( 16000 );
+
 // ═════════════════════════════════════════════════════════════════════════════
 //  malloc/free baseline for comparison
 // ═════════════════════════════════════════════════════════════════════════════
@@ -244,12 +393,12 @@ static void BM_PmapInsert( benchmark::State& state )
 }
 BENCHMARK( BM_PmapInsert )->Arg( 100 )->Arg( 1000 )->Arg( 10000 );
 
-static void BM_PmapFind( benchmark::State& state )
+template <typename MgrT> static void pmap_find_loop( benchmark::State& state )
 {
     const auto N = static_cast<int>( state.range( 0 ) );
-    MgrPmap::create( HEAP_64MB );
+    MgrT::create( HEAP_64MB );
 
-    using MyMap = pmm::pmap<int, int, MgrPmap>;
+    using MyMap = pmm::pmap<int, int, MgrT>;
     MyMap map;
 
     for ( int i = 0; i < N; i++ )
@@ -264,10 +413,21 @@ static void BM_PmapFind( benchmark::State& state )
     }
 
     map.clear();
-    MgrPmap::destroy();
+    MgrT::destroy();
+}
+
+static void BM_PmapFind( benchmark::State& state )
+{
+    pmap_find_loop<MgrPmap>( state );
 }
 BENCHMARK( BM_PmapFind )->Arg( 100 )->Arg( 1000 )->Arg( 10000 );
 
+static void BM_PmapFindNoValidation( benchmark::State& state )
+{
+    pmap_find_loop<MgrPmapNoCheck>( state );
+}
+BENCHMARK( BM_PmapFindNoValidation )->Arg( 100 )->Arg( 1000 )->Arg( 10000 );
+
 static void BM_PmapErase( benchmark::State& state )
 {
     const auto N = static_cast<int>( state.range( 0 ) );
@@ -293,6 +453,29 @@ static void BM_PmapErase( benchmark::State& state )
 }
 BENCHMARK( BM_PmapErase )->Arg( 100 )->Arg( 1000 );
 
+static void BM_PmapClear( benchmark::State& state )
+{
+    const auto N = static_cast<int>( state.range( 0 ) );
+    MgrPmap::create( HEAP_64MB );
+
+    using MyMap = pmm::pmap<int, int, MgrPmap>;
+    MyMap map;
+
+    for ( auto _ : state )
+    {
+        state.PauseTiming();
+        for ( int i = 0; i < N; i++ )
+            map.insert( i, i );
+        state.ResumeTiming();
+
+        map.clear();
+    }
+
+    state.SetItemsProcessed( state.iterations() * N );
+    MgrPmap::destroy();
+}
+BENCHMARK( BM_PmapClear )->Arg( 1000 )->Arg( 10000 );
+
 // ═════════════════════════════════════════════════════════════════════════════
 //  parray benchmarks (contiguous storage, O(1) access)
 // ═════════════════════════════════════════════════════════════════════════════
@@ -453,3 +636,60 @@ static void BM_AllocateMT( benchmark::State& state )
         MgrMT::destroy();
 }
 BENCHMARK( BM_AllocateMT )->Threads( 1 )->Threads( 2 )->Threads( 4 )->Threads( 8 );
+
+static void BM_AllocateMTCached( benchmark::State& state )
+{
+    if ( state.thread_index() == 0 )
+        MgrMTCached::create( HEAP_64MB );
+
+    for ( auto _ : state )
+    {
+        auto p = MgrMTCached::allocate_typed<std::uint8_t>( 64 );
+        benchmark::DoNotOptimize( p );
+        if ( !p.is_null() )
+            MgrMTCached::deallocate_typed( p );
+    }
+
+    if ( state.thread_index() == 0 )
+        MgrMTCached::destroy();
+}
+BENCHMARK( BM_AllocateMTCached )->Threads( 1 )->Threads( 2 )->Threads( 4 )->Threads( 8 );
+
+static void BM_AllocateMTArena( benchmark::State& state )
+{
+    if ( state.thread_index() == 0 )
+        MgrMTArena::create( HEAP_64MB );
+
+    for ( auto _ : state )
+    {
+        auto p = MgrMTArena::allocate_typed<std::uint8_t>( 64 );
+        benchmark::DoNotOptimize( p );
+        if ( !p.is_null() )
+            MgrMTArena::deallocate_typed( p );
+    }
+
+    if ( state.thread_index() == 0 )
+        MgrMTArena::destroy();
+}
+BENCHMARK( BM_AllocateMTArena )->Threads( 1 )->Threads( 2 )->Threads( 4 )->Threads( 8 );
+
+// Same workload as BM_AllocateMT, one instantiation per lock policy.
+template <typename MgrT> static void BM_AllocateMTLock( benchmark::State& state )
+{
+    if ( state.thread_index() == 0 )
+        MgrT::create( HEAP_64MB );
+
+    for ( auto _ : state )
+    {
+        auto p = MgrT::template allocate_typed<std::uint8_t>( 64 );
+        benchmark::DoNotOptimize( p );
+        if ( !p.is_null() )
+            MgrT::deallocate_typed( p );
+    }
+
+    if ( state.thread_index() == 0 )
+        MgrT::destroy();
+}
+BENCHMARK_TEMPLATE( BM_AllocateMTLock, MgrMTSpin )->Threads( 1 )->Threads( 2 )->Threads( 4 )->Threads( 8 );
+BENCHMARK_TEMPLATE( BM_AllocateMTLock, MgrMTTicket )->Threads( 1 )->Threads( 2 )->Threads( 4 )->Threads( 8 );
+BENCHMARK_TEMPLATE( BM_AllocateMTLock, MgrMTAdaptive )->Threads( 1 )->Threads( 2 )->Threads( 4 )->Threads( 8 );
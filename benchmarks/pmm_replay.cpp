@@ -0,0 +1,219 @@
+/**
+ * @file pmm_replay.cpp
+ * @brief Replays an allocation trace recorded by pmm::logging::TraceLogging against a preset.
+ *
+ * Reports throughput, per-operation latency percentiles, peak image size and final fragmentation.
+ *
+ * Usage:
+ *   pmm_replay <trace-file> [preset] [initial-bytes]
+ *   pmm_replay --synthesize <trace-file> [ops]
+ *
+ * Presets: single (default), multi, multi-cached, industrial, industrial-cached, embedded, large-db.
+ *
+ * Build:
+ *   cmake -B build -DPMM_BUILD_BENCHMARKS=ON -DCMAKE_BUILD_TYPE=Release
+ *   cmake --build build --target pmm_replay
+ */
+
+#include "pmm/manager_configs.h"
+#include "pmm/persist_memory_manager.h"
+#include "pmm/trace_logging.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using pmm::logging::LatencyHistogram;
+using pmm::logging::TraceOp;
+using pmm::logging::TraceRecord;
+
+// ─── Replay ───────────────────────────────────────────────────────────────────
+
+struct ReplayReport
+{
+    LatencyHistogram latency[3]{};
+    std::size_t      peak_image    = 0;
+    std::size_t      missing       = 0;
+    std::size_t      failed        = 0;
+    double           seconds       = 0.0;
+    double           fragmentation = 0.0;
+};
+
+template <typename MgrT> bool replay( const std::vector<TraceRecord>& trace, std::size_t initial, ReplayReport& rep )
+{
+    using handle_pptr = typename MgrT::template pptr<std::uint8_t>;
+    if ( !MgrT::create( initial ) )
+        return false;
+    std::vector<handle_pptr> live;
+    std::vector<std::size_t> sizes;
+    auto                     start = std::chrono::steady_clock::now();
+    for ( const TraceRecord& r : trace )
+    {
+        if ( r.handle >= live.size() )
+        {
+            live.resize( static_cast<std::size_t>( r.handle ) + 1 );
+            sizes.resize( live.size(), 0 );
+        }
+        handle_pptr& p  = live[static_cast<std::size_t>( r.handle )];
+        auto         t0 = std::chrono::steady_clock::now();
+        switch ( r.op )
+        {
+        case TraceOp::Allocate:
+            p = MgrT::template allocate_typed<std::uint8_t>( r.size == 0 ? 1 : r.size );
+            break;
+        case TraceOp::Deallocate:
+            MgrT::template deallocate_typed<std::uint8_t>( p );
+            break;
+        case TraceOp::Realloc:
+            p = MgrT::template reallocate_typed<std::uint8_t>( p, sizes[r.handle], r.size == 0 ? 1 : r.size );
+            break;
+        default:
+            continue;
+        }
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - t0 );
+        rep.latency[static_cast<std::size_t>( r.op )].add( static_cast<std::uint64_t>( ns.count() ) );
+        if ( r.op == TraceOp::Deallocate )
+        {
+            rep.missing += p.is_null() ? 1 : 0;
+            p = handle_pptr();
+        }
+        else if ( p.is_null() )
+        {
+            ++rep.failed;
+        }
+        sizes[r.handle] = ( r.size == 0 ) ? 1 : r.size;
+        rep.peak_image  = ( MgrT::total_size() > rep.peak_image ) ? MgrT::total_size() : rep.peak_image;
+    }
+    rep.seconds       = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    rep.fragmentation = MgrT::memory_stats_detailed().external_fragmentation;
+    MgrT::destroy();
+    return true;
+}
+
+template <typename ConfigT>
+bool replay_preset( const std::vector<TraceRecord>& trace, std::size_t initial, ReplayReport& rep )
+{
+    return replay<pmm::PersistMemoryManager<ConfigT, 200>>( trace, initial, rep );
+}
+
+static bool replay_named( const std::string& preset, const std::vector<TraceRecord>& trace, std::size_t initial,
+                          ReplayReport& rep )
+{
+    if ( preset == "single" )
+        return replay_preset<pmm::CacheManagerConfig>( trace, initial, rep );
+    if ( preset == "multi" )
+        return replay_preset<pmm::PersistentDataConfig>( trace, initial, rep );
+    if ( preset == "multi-cached" )
+        return replay_preset<pmm::PersistentDataCachedConfig>( trace, initial, rep );
+    if ( preset == "industrial" )
+        return replay_preset<pmm::IndustrialDBConfig>( trace, initial, rep );
+    if ( preset == "industrial-cached" )
+        return replay_preset<pmm::IndustrialDBCachedConfig>( trace, initial, rep );
+    if ( preset == "embedded" )
+        return replay_preset<pmm::EmbeddedManagerConfig>( trace, initial, rep );
+    if ( preset == "large-db" )
+        return replay_preset<pmm::LargeDBConfig>( trace, initial, rep );
+    std::cerr << "unknown preset: " << preset << "\n";
+    return false;
+}
+
+// ─── Synthetic trace ──────────────────────────────────────────────────────────
+
+static bool synthesize( const char* path, std::size_t ops )
+{
+    using Mgr = pmm::PersistMemoryManager<
+        pmm::BasicConfig<pmm::DefaultAddressTraits, pmm::config::NoLock, 5, 4, 64, pmm::logging::TraceLogging>, 201>;
+    if ( !Mgr::create( 1024 * 1024 ) || !pmm::logging::TraceLogging::open( path ) )
+        return false;
+    std::mt19937                            rng( 42 );
+    std::vector<Mgr::pptr<std::uint8_t>>    live;
+    std::vector<std::size_t>                sizes;
+    std::uniform_int_distribution<unsigned> pick( 0, 99 );
+    for ( std::size_t i = 0; i < ops; ++i )
+    {
+        unsigned    roll = pick( rng );
+        std::size_t size = ( roll < 90 ) ? 8 + rng() % 248 : 256 + rng() % 16384;
+        if ( live.empty() || roll < 50 )
+        {
+            live.push_back( Mgr::allocate_typed<std::uint8_t>( size ) );
+            sizes.push_back( size );
+        }
+        else
+        {
+            std::size_t victim = rng() % live.size();
+            if ( roll < 60 )
+            {
+                live[victim]  = Mgr::reallocate_typed<std::uint8_t>( live[victim], sizes[victim], size );
+                sizes[victim] = size;
+                continue;
+            }
+            Mgr::deallocate_typed( live[victim] );
+            live[victim]  = live.back();
+            sizes[victim] = sizes.back();
+            live.pop_back();
+            sizes.pop_back();
+        }
+    }
+    std::cout << "recorded " << pmm::logging::TraceLogging::recorded() << " records to " << path << "\n";
+    bool ok = pmm::logging::TraceLogging::close();
+    Mgr::destroy();
+    return ok;
+}
+
+// ─── Report ───────────────────────────────────────────────────────────────────
+
+static void print_report( const std::string& preset, std::size_t records, const ReplayReport& rep )
+{
+    static const char* kOpNames[] = { "allocate", "deallocate", "realloc" };
+    std::cout << "preset:          " << preset << "\n";
+    std::cout << "records:         " << records << "\n";
+    std::cout << "elapsed:         " << rep.seconds * 1000.0 << " ms\n";
+    std::cout << "throughput:      " << ( rep.seconds > 0 ? static_cast<double>( records ) / rep.seconds : 0.0 )
+              << " ops/s\n";
+    for ( std::size_t op = 0; op < 3; ++op )
+    {
+        const LatencyHistogram& h = rep.latency[op];
+        if ( h.count == 0 )
+            continue;
+        std::cout << kOpNames[op] << " (" << h.count << "): p50 " << h.percentile( 0.5 ) << " ns, p90 "
+                  << h.percentile( 0.9 ) << " ns, p99 " << h.percentile( 0.99 ) << " ns, p99.9 "
+                  << h.percentile( 0.999 ) << " ns, max " << h.max_ns << " ns\n";
+    }
+    std::cout << "peak image:      " << rep.peak_image << " bytes\n";
+    std::cout << "fragmentation:   " << rep.fragmentation << "\n";
+    if ( rep.failed != 0 || rep.missing != 0 )
+        std::cout << "failed ops:      " << rep.failed << ", frees of unknown handles: " << rep.missing << "\n";
+}
+
+int main( int argc, char** argv )
+{
+    if ( argc >= 3 && std::strcmp( argv[1], "--synthesize" ) == 0 )
+    {
+        std::size_t ops = ( argc >= 4 ) ? std::strtoull( argv[3], nullptr, 10 ) : 100000;
+        return synthesize( argv[2], ops ) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if ( argc < 2 )
+    {
+        std::cerr << "usage: " << argv[0] << " <trace-file> [preset] [initial-bytes]\n"
+                  << "       " << argv[0] << " --synthesize <trace-file> [ops]\n";
+        return EXIT_FAILURE;
+    }
+    std::vector<TraceRecord> trace;
+    if ( !pmm::logging::read_trace_file( argv[1], trace ) )
+    {
+        std::cerr << "cannot read trace: " << argv[1] << "\n";
+        return EXIT_FAILURE;
+    }
+    std::string  preset  = ( argc >= 3 ) ? argv[2] : "single";
+    std::size_t  initial = ( argc >= 4 ) ? std::strtoull( argv[3], nullptr, 10 ) : 1024 * 1024;
+    ReplayReport rep;
+    if ( !replay_named( preset, trace, initial, rep ) )
+        return EXIT_FAILURE;
+    print_report( preset, trace.size(), rep );
+    return EXIT_SUCCESS;
+}
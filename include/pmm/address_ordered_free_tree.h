@@ -0,0 +1,275 @@
+#pragma once
+#include "pmm/arena_internals.h"
+#include "pmm/diagnostics.h"
+#include "pmm/free_block_tree.h"
+#include "pmm/types.h"
+#include "pmm/validation.h"
+#include <cstddef>
+#include <cstdint>
+namespace pmm
+{
+template <typename AT = DefaultAddressTraits>
+/*
+## pmm-addressorderedfreetree
+req: feat-002, fr-004, fr-013, qa-perf-001
+*/
+struct AddressOrderedFreeTree
+{
+    using address_traits                           = AT;
+    using index_type                               = typename AT::index_type;
+    using BlockState                               = BlockStateBase<AT>;
+    using BPPtr                                    = detail::BlockPPtr<AT>;
+    static constexpr const char* kForestDomainName = AvlFreeTree<AT>::kForestDomainName;
+    static constexpr size_t kSubtreeMaxOffset      = sizeof( Block<AT> ) + detail::block_tree_slot_bytes_v<AT>;
+    static_assert( AT::granule_size >= sizeof( index_type ), "" );
+    struct Table
+    {
+        index_type root;
+    };
+    static constexpr size_t kImageReserveBytes                         = sizeof( Table );
+    AddressOrderedFreeTree()                                           = delete;
+    AddressOrderedFreeTree( const AddressOrderedFreeTree& )            = delete;
+    AddressOrderedFreeTree& operator=( const AddressOrderedFreeTree& ) = delete;
+    static constexpr bool   tree_holds( index_type ) noexcept { return false; }
+    static void             reset( uint8_t* base, detail::ManagerHeader<AT>* hdr ) noexcept
+    {
+        (void)base;
+        table_of( hdr )->root = AT::no_block;
+    }
+    static void insert( uint8_t* base, detail::ManagerHeader<AT>* hdr, index_type blk_idx )
+    {
+        void*  blk = detail::block_at<AT>( base, blk_idx );
+        Table* t   = table_of( hdr );
+        BlockState::set_left_offset_of( blk, AT::no_block );
+        BlockState::set_right_offset_of( blk, AT::no_block );
+        BlockState::set_parent_offset_of( blk, AT::no_block );
+        BlockState::set_avl_height_of( blk, 1 );
+        set_subtree_max( blk, BlockState::get_weight( blk ) );
+        if ( t->root == AT::no_block )
+        {
+            t->root = blk_idx;
+            return;
+        }
+        index_type cur = t->root, parent = AT::no_block;
+        while ( cur != AT::no_block )
+        {
+            parent        = cur;
+            const void* n = detail::block_at<AT>( base, cur );
+            cur           = ( blk_idx < cur ) ? BlockState::get_left_offset( n ) : BlockState::get_right_offset( n );
+        }
+        BlockState::set_parent_offset_of( blk, parent );
+        if ( blk_idx < parent )
+            BlockState::set_left_offset_of( detail::block_at<AT>( base, parent ), blk_idx );
+        else
+            BlockState::set_right_offset_of( detail::block_at<AT>( base, parent ), blk_idx );
+        detail::avl_rebalance_up( BPPtr( base, parent ), t->root, UpdateNode{} );
+    }
+    static void remove( uint8_t* base, detail::ManagerHeader<AT>* hdr, index_type blk_idx )
+    {
+        void*      blk    = detail::block_at<AT>( base, blk_idx );
+        Table*     t      = table_of( hdr );
+        index_type parent = BlockState::get_parent_offset( blk );
+        index_type left   = BlockState::get_left_offset( blk );
+        index_type right  = BlockState::get_right_offset( blk );
+        index_type rebal  = parent;
+        if ( left == AT::no_block || right == AT::no_block )
+        {
+            index_type child = ( left != AT::no_block ) ? left : right;
+            if ( child != AT::no_block )
+                BlockState::set_parent_offset_of( detail::block_at<AT>( base, child ), parent );
+            set_child( base, t, parent, blk_idx, child );
+        }
+        else
+        {
+            index_type succ_idx = right;
+            for ( index_type l = right; l != AT::no_block; )
+            {
+                succ_idx = l;
+                l        = BlockState::get_left_offset( detail::block_at<AT>( base, l ) );
+            }
+            void*      succ_raw    = detail::block_at<AT>( base, succ_idx );
+            index_type succ_parent = BlockState::get_parent_offset( succ_raw );
+            index_type succ_right  = BlockState::get_right_offset( succ_raw );
+            rebal                  = succ_idx;
+            if ( succ_parent != blk_idx )
+            {
+                set_child( base, t, succ_parent, succ_idx, succ_right );
+                if ( succ_right != AT::no_block )
+                    BlockState::set_parent_offset_of( detail::block_at<AT>( base, succ_right ), succ_parent );
+                BlockState::set_right_offset_of( succ_raw, right );
+                BlockState::set_parent_offset_of( detail::block_at<AT>( base, right ), succ_idx );
+                rebal = succ_parent;
+            }
+            BlockState::set_left_offset_of( succ_raw, left );
+            BlockState::set_parent_offset_of( detail::block_at<AT>( base, left ), succ_idx );
+            BlockState::set_parent_offset_of( succ_raw, parent );
+            set_child( base, t, parent, blk_idx, succ_idx );
+        }
+        BlockState::reset_avl_fields_of( blk );
+        detail::avl_rebalance_up( BPPtr( base, rebal ), t->root, UpdateNode{} );
+    }
+/*
+### pmm-addressorderedfreetree-find_best_fit
+*/
+    static index_type find_best_fit( uint8_t* base, detail::ManagerHeader<AT>* hdr, index_type needed_granules )
+    {
+        index_type cur = table_of( hdr )->root;
+        if ( cur == AT::no_block || subtree_max( detail::block_at<AT>( base, cur ) ) < needed_granules )
+            return AT::no_block;
+        while ( cur != AT::no_block )
+        {
+            const void* node  = detail::block_at<AT>( base, cur );
+            index_type  left  = BlockState::get_left_offset( node );
+            index_type  right = BlockState::get_right_offset( node );
+            if ( left != AT::no_block && subtree_max( detail::block_at<AT>( base, left ) ) >= needed_granules )
+                cur = left;
+            else if ( BlockState::get_weight( node ) >= needed_granules )
+                return cur;
+            else
+                cur = right;
+        }
+        return AT::no_block;
+    }
+    static index_type largest_free( const uint8_t* base, const detail::ManagerHeader<AT>* hdr ) noexcept
+    {
+        index_type root = table_of( hdr )->root;
+        return ( root != AT::no_block ) ? subtree_max( detail::block_at<AT>( base, root ) ) : 0;
+    }
+    template <typename Fn>
+    static void for_each_listed( const uint8_t* base, const detail::ManagerHeader<AT>* hdr, Fn&& fn ) noexcept
+    {
+        size_t     limit = static_cast<size_t>( hdr->free_count );
+        index_type stack[2 * sizeof( index_type ) * 8];
+        size_t     depth = 0;
+        index_type cur   = table_of( hdr )->root;
+        while ( limit > 0 && ( cur != AT::no_block || depth > 0 ) )
+        {
+            if ( cur != AT::no_block )
+            {
+                if ( depth == sizeof( stack ) / sizeof( stack[0] ) ||
+                     !detail::validate_block_index<AT>( hdr->total_size, cur ) )
+                    return;
+                stack[depth++] = cur;
+                cur            = BlockState::get_left_offset( detail::block_at<AT>( base, cur ) );
+                continue;
+            }
+            cur = stack[--depth];
+            fn( cur );
+            --limit;
+            cur = BlockState::get_right_offset( detail::block_at<AT>( base, cur ) );
+        }
+    }
+    static void verify_lists( detail::ConstArenaView<AT> arena, VerifyResult& result ) noexcept
+    {
+        const uint8_t*                   base     = arena.base();
+        const detail::ManagerHeader<AT>* hdr      = arena.header();
+        size_t                           expected = 0;
+        (void)detail::for_each_physical_block<AT>( arena,
+                                                   [&]( index_type, const void* blk ) noexcept
+                                                   {
+                                                       if ( pmm::is_free( BlockState::get_node_type( blk ) ) )
+                                                           ++expected;
+                                                       return true;
+                                                   } );
+        size_t     visited  = 0;
+        index_type max_gran = 0;
+        (void)verify_node( base, hdr, table_of( hdr )->root, AT::no_block, 0, AT::no_block, expected, visited,
+                           max_gran, result );
+        if ( visited != expected )
+        {
+            result.add( ViolationType::FreeTreeStale, DiagnosticAction::NoAction, 0, static_cast<uint64_t>( expected ),
+                        static_cast<uint64_t>( visited ) );
+        }
+    }
+    static index_type subtree_max( const void* blk ) noexcept
+    {
+        return *reinterpret_cast<const index_type*>( static_cast<const uint8_t*>( blk ) + kSubtreeMaxOffset );
+    }
+
+  private:
+    struct UpdateNode
+    {
+        void operator()( BPPtr p ) const noexcept
+        {
+            detail::avl_update_height( p );
+            void*      blk = detail::block_at<AT>( p._base, p.offset() );
+            index_type m   = BlockState::get_weight( blk );
+            index_type l   = BlockState::get_left_offset( blk );
+            index_type r   = BlockState::get_right_offset( blk );
+            if ( l != AT::no_block && subtree_max( detail::block_at<AT>( p._base, l ) ) > m )
+                m = subtree_max( detail::block_at<AT>( p._base, l ) );
+            if ( r != AT::no_block && subtree_max( detail::block_at<AT>( p._base, r ) ) > m )
+                m = subtree_max( detail::block_at<AT>( p._base, r ) );
+            set_subtree_max( blk, m );
+        }
+    };
+    static void set_subtree_max( void* blk, index_type m ) noexcept
+    {
+        *reinterpret_cast<index_type*>( static_cast<uint8_t*>( blk ) + kSubtreeMaxOffset ) = m;
+    }
+    static void set_child( uint8_t* base, Table* t, index_type parent, index_type old_child, index_type new_child )
+    {
+        if ( parent == AT::no_block )
+        {
+            t->root = new_child;
+            return;
+        }
+        void* p = detail::block_at<AT>( base, parent );
+        if ( BlockState::get_left_offset( p ) == old_child )
+            BlockState::set_left_offset_of( p, new_child );
+        else
+            BlockState::set_right_offset_of( p, new_child );
+    }
+    static std::int16_t verify_node( const uint8_t* base, const detail::ManagerHeader<AT>* hdr, index_type node_idx,
+                                     index_type parent, index_type lower, index_type upper, size_t expected,
+                                     size_t& visited, index_type& max_gran, VerifyResult& result ) noexcept
+    {
+        max_gran = 0;
+        if ( node_idx == AT::no_block )
+            return 0;
+        if ( visited >= expected || !detail::validate_block_index<AT>( hdr->total_size, node_idx ) )
+        {
+            result.add( ViolationType::FreeTreeStale, DiagnosticAction::NoAction, static_cast<uint64_t>( node_idx ),
+                        static_cast<uint64_t>( expected ), static_cast<uint64_t>( visited ) );
+            return 0;
+        }
+        ++visited;
+        const void* node = detail::block_at<AT>( base, node_idx );
+        if ( !pmm::is_free( BlockState::get_node_type( node ) ) || BlockState::get_parent_offset( node ) != parent ||
+             node_idx < lower || node_idx >= upper )
+        {
+            result.add( ViolationType::FreeTreeStale, DiagnosticAction::NoAction, static_cast<uint64_t>( node_idx ),
+                        static_cast<uint64_t>( parent ),
+                        static_cast<uint64_t>( BlockState::get_parent_offset( node ) ) );
+            return 0;
+        }
+        index_type   left_max = 0, right_max = 0;
+        std::int16_t left_h  = verify_node( base, hdr, BlockState::get_left_offset( node ), node_idx, lower, node_idx,
+                                            expected, visited, left_max, result );
+        std::int16_t right_h = verify_node( base, hdr, BlockState::get_right_offset( node ), node_idx,
+                                            static_cast<index_type>( node_idx + 1 ), upper, expected, visited,
+                                            right_max, result );
+        max_gran             = BlockState::get_weight( node );
+        max_gran             = left_max > max_gran ? left_max : max_gran;
+        max_gran             = right_max > max_gran ? right_max : max_gran;
+        std::int16_t h       = static_cast<std::int16_t>( 1 + ( left_h > right_h ? left_h : right_h ) );
+        if ( BlockState::get_avl_height( node ) != h || left_h - right_h > 1 || right_h - left_h > 1 ||
+             subtree_max( node ) != max_gran )
+        {
+            result.add( ViolationType::FreeTreeStale, DiagnosticAction::NoAction, static_cast<uint64_t>( node_idx ),
+                        static_cast<uint64_t>( max_gran ), static_cast<uint64_t>( subtree_max( node ) ) );
+        }
+        return h;
+    }
+    static Table* table_of( detail::ManagerHeader<AT>* hdr ) noexcept
+    {
+        return reinterpret_cast<Table*>( detail::manager_header_reserve_at<AT>( hdr ) );
+    }
+    static const Table* table_of( const detail::ManagerHeader<AT>* hdr ) noexcept
+    {
+        return reinterpret_cast<const Table*>( detail::manager_header_reserve_at<AT>( hdr ) );
+    }
+};
+static_assert( FreeBlockTreePolicyForTraitsConcept<AddressOrderedFreeTree<DefaultAddressTraits>, DefaultAddressTraits>,
+               "" );
+}
@@ -41,4 +41,12 @@ template <typename IndexT, size_t GranuleSz> struct AddressTraits
 using SmallAddressTraits   = AddressTraits<uint16_t, 16>;
 using DefaultAddressTraits = AddressTraits<uint32_t, 16>;
 using LargeAddressTraits   = AddressTraits<uint64_t, 64>;
+/*
+## pmm-compactaddresstraits
+req: dr-001, qa-mem-001
+*/
+struct CompactAddressTraits : AddressTraits<uint32_t, 16>
+{
+    static constexpr bool compact_block_header = true;
+};
 }
@@ -32,7 +32,12 @@ class AllocatorPolicy
     AllocatorPolicy()                                    = delete;
     AllocatorPolicy( const AllocatorPolicy& )            = delete;
     AllocatorPolicy& operator=( const AllocatorPolicy& ) = delete;
-    static void*     allocate_from_block( Arena arena, index_type blk_idx, index_type data_gran )
+    static void      note_allocated( index_type data_gran, bool added ) noexcept
+    {
+        if constexpr ( requires { FT::note_allocated( data_gran, added ); } )
+            FT::note_allocated( data_gran, added );
+    }
+    static void* allocate_from_block( Arena arena, index_type blk_idx, index_type data_gran )
     {
         static constexpr index_type kBlkHdrGran = detail::kBlockHeaderGranules_t<AT>;
         if ( data_gran == 0 )
@@ -75,8 +80,104 @@ class AllocatorPolicy
         hdr->alloc_count++;
         hdr->free_count--;
         hdr->used_size += data_gran;
+        note_allocated( data_gran, true );
         return detail::user_ptr<AT>( detail::block_at<AT>( base, blk_idx ) );
     }
+    static index_type aligned_lead( const std::uint8_t* base, index_type blk_idx, size_t align ) noexcept
+    {
+        static constexpr index_type kBlkHdrGran = detail::kBlockHeaderGranules_t<AT>;
+        std::uintptr_t user = reinterpret_cast<std::uintptr_t>( base ) +
+                              ( static_cast<size_t>( blk_idx ) + kBlkHdrGran ) * AT::granule_size;
+        size_t         mis  = static_cast<size_t>( user & ( align - 1 ) );
+        size_t         step = align / AT::granule_size;
+        size_t         lead = ( mis == 0 ) ? 0 : ( align - mis ) / AT::granule_size;
+        if ( lead != 0 && lead <= kBlkHdrGran )
+            lead += ( ( kBlkHdrGran + 1 - lead + step - 1 ) / step ) * step;
+        return static_cast<index_type>( lead );
+    }
+    static void* allocate_aligned_from_block( Arena arena, index_type blk_idx, index_type data_gran, index_type lead )
+    {
+        static constexpr index_type kBlkHdrGran = detail::kBlockHeaderGranules_t<AT>;
+        if ( lead == 0 )
+            return allocate_from_block( arena, blk_idx, data_gran );
+        std::uint8_t*              base    = arena.base();
+        detail::ManagerHeader<AT>* hdr     = arena.header();
+        void*                      blk     = detail::block_at<AT>( base, blk_idx );
+        index_type                 total   = BlockState::get_weight( blk );
+        index_type                 next    = BlockState::get_next_offset( blk );
+        index_type                 new_idx = static_cast<index_type>( blk_idx + lead );
+        void*                      nb      = detail::block_at<AT>( base, new_idx );
+        FT::remove( base, hdr, blk_idx );
+        std::memset( nb, 0, sizeof( BlockT ) );
+        BlockState::init_fields( nb, blk_idx, next, 1, static_cast<index_type>( total - lead ), 0, NodeType::Free );
+        BlockState::set_weight_of( blk, lead );
+        BlockState::set_next_offset_of( blk, new_idx );
+        if ( next != AT::no_block )
+            BlockState::set_prev_offset_of( detail::block_at<AT>( base, next ), new_idx );
+        else
+            hdr->last_block_offset = new_idx;
+        hdr->block_count++;
+        hdr->free_count++;
+        hdr->used_size += kBlkHdrGran;
+        FT::insert( base, hdr, blk_idx );
+        FT::insert( base, hdr, new_idx );
+        return allocate_from_block( arena, new_idx, data_gran );
+    }
+    template <typename Fn>
+    static index_type allocate_run_from_block( Arena arena, index_type blk_idx, index_type data_gran, index_type count,
+                                               Fn&& emit )
+    {
+        static constexpr index_type kBlkHdrGran = detail::kBlockHeaderGranules_t<AT>;
+        std::uint8_t*               base        = arena.base();
+        detail::ManagerHeader<AT>*  hdr         = arena.header();
+        void*                       first       = detail::block_at<AT>( base, blk_idx );
+        index_type                  total       = BlockState::get_weight( first );
+        index_type                  step        = kBlkHdrGran + data_gran;
+        index_type                  fit         = total / step;
+        index_type                  n           = ( count < fit ) ? count : fit;
+        if ( n == 0 )
+            return 0;
+        index_type rem       = static_cast<index_type>( total - n * step );
+        bool       tail_free = rem >= kBlkHdrGran + 1;
+        index_type prev      = BlockState::get_prev_offset( first );
+        index_type next      = BlockState::get_next_offset( first );
+        index_type last_idx  = static_cast<index_type>( blk_idx + ( n - 1 ) * step );
+        index_type tail_idx  = static_cast<index_type>( blk_idx + n * step );
+        FT::remove( base, hdr, blk_idx );
+        for ( index_type i = 0; i < n; ++i )
+        {
+            index_type idx = static_cast<index_type>( blk_idx + i * step );
+            void*      blk = detail::block_at<AT>( base, idx );
+            index_type nxt = ( idx != last_idx ) ? static_cast<index_type>( idx + step ) : ( tail_free ? tail_idx : next );
+            std::memset( blk, 0, sizeof( BlockT ) );
+            BlockState::init_fields( blk, ( i == 0 ) ? prev : static_cast<index_type>( idx - step ), nxt, 0, data_gran,
+                                     idx, NodeType::Generic );
+        }
+        index_type end_idx = tail_free ? tail_idx : last_idx;
+        if ( tail_free )
+        {
+            void* tail = detail::block_at<AT>( base, tail_idx );
+            std::memset( tail, 0, sizeof( BlockT ) );
+            BlockState::init_fields( tail, last_idx, next, 1, rem, 0, NodeType::Free );
+        }
+        if ( next != AT::no_block )
+            BlockState::set_prev_offset_of( detail::block_at<AT>( base, next ), end_idx );
+        else
+            hdr->last_block_offset = end_idx;
+        index_type extra_hdrs = static_cast<index_type>( n - 1 + ( tail_free ? 1 : 0 ) );
+        hdr->block_count      = static_cast<index_type>( hdr->block_count + extra_hdrs );
+        hdr->free_count       = static_cast<index_type>( hdr->free_count + ( tail_free ? 1 : 0 ) - 1 );
+        hdr->alloc_count      = static_cast<index_type>( hdr->alloc_count + n );
+        hdr->used_size        = static_cast<index_type>( hdr->used_size + n * data_gran + extra_hdrs * kBlkHdrGran );
+        if ( tail_free )
+            FT::insert( base, hdr, tail_idx );
+        for ( index_type i = 0; i < n; ++i )
+        {
+            note_allocated( data_gran, true );
+            emit( detail::user_ptr<AT>( detail::block_at<AT>( base, static_cast<index_type>( blk_idx + i * step ) ) ) );
+        }
+        return n;
+    }
     static void coalesce( Arena arena, index_type blk_idx )
     {
         std::uint8_t*              base = arena.base();
@@ -132,15 +233,110 @@ class AllocatorPolicy
         (void)coalescing.finalize_coalesce();
         FT::insert( base, hdr, b_idx );
     }
-    static void rebuild_free_tree( Arena arena )
+    template <typename Next> static index_type release_sorted( Arena arena, index_type idx, index_type limit, Next&& next )
+    {
+        static constexpr index_type kBlkHdrGran = detail::kBlockHeaderGranules_t<AT>;
+        std::uint8_t*               base        = arena.base();
+        detail::ManagerHeader<AT>*  hdr         = arena.header();
+        auto                        mark_free   = [&]( index_type b ) noexcept
+        {
+            BlockT*    blk   = detail::block_at<AT>( base, b );
+            index_type freed = BlockState::get_weight( blk );
+            index_type total = detail::physical_block_total_granules<AT>( base, hdr, blk );
+            hdr->alloc_count--;
+            hdr->free_count++;
+            if ( hdr->used_size >= freed )
+                hdr->used_size -= freed;
+            note_allocated( freed, false );
+            return AllocatedBlock<AT>::cast_from_raw( blk ).mark_as_free( total ).begin_coalescing();
+        };
+        auto absorb = [&]() noexcept
+        {
+            hdr->block_count--;
+            hdr->free_count--;
+            if ( hdr->used_size >= kBlkHdrGran )
+                hdr->used_size -= kBlkHdrGran;
+        };
+        while ( idx != AT::no_block && idx < limit )
+        {
+            index_type          start = idx;
+            CoalescingBlock<AT> run   = mark_free( idx );
+            idx                       = next();
+            index_type prv            = run.prev_offset();
+            if ( prv != AT::no_block && pmm::is_free( BlockState::get_node_type( detail::block_at<AT>( base, prv ) ) ) )
+            {
+                index_type nxt      = run.next_offset();
+                BlockT*    next_blk = ( nxt != AT::no_block ) ? detail::block_at<AT>( base, nxt ) : nullptr;
+                FT::remove( base, hdr, prv );
+                run = run.coalesce_with_prev( detail::block_at<AT>( base, prv ), next_blk, prv, run.weight() );
+                if ( next_blk == nullptr )
+                    hdr->last_block_offset = prv;
+                start = prv;
+                absorb();
+            }
+            for ( index_type nxt = run.next_offset(); nxt != AT::no_block; nxt = run.next_offset() )
+            {
+                void* nxt_raw = detail::block_at<AT>( base, nxt );
+                if ( nxt == idx )
+                {
+                    (void)mark_free( nxt );
+                    idx = next();
+                }
+                else if ( pmm::is_free( BlockState::get_node_type( nxt_raw ) ) )
+                    FT::remove( base, hdr, nxt );
+                else
+                    break;
+                index_type nxt_next = BlockState::get_next_offset( nxt_raw );
+                BlockT* nxt_nxt_blk = ( nxt_next != AT::no_block ) ? detail::block_at<AT>( base, nxt_next ) : nullptr;
+                run.coalesce_with_next( nxt_raw, nxt_nxt_blk, start, BlockState::get_weight( nxt_raw ) );
+                if ( nxt_nxt_blk == nullptr )
+                    hdr->last_block_offset = start;
+                absorb();
+            }
+            (void)run.finalize_coalesce();
+            FT::insert( base, hdr, start );
+        }
+        return idx;
+    }
+    static index_type relocate_into_hole( Arena arena, index_type hole_idx )
+    {
+        std::uint8_t*              base      = arena.base();
+        detail::ManagerHeader<AT>* hdr       = arena.header();
+        void*                      hole      = detail::block_at<AT>( base, hole_idx );
+        index_type                 hole_gran = BlockState::get_weight( hole );
+        index_type                 prev      = BlockState::get_prev_offset( hole );
+        index_type                 blk_idx   = BlockState::get_next_offset( hole );
+        BlockT*                    blk       = detail::block_at<AT>( base, blk_idx );
+        index_type                 total     = detail::physical_block_total_granules<AT>( base, hdr, blk );
+        index_type                 next      = BlockState::get_next_offset( blk );
+        index_type                 free_idx  = static_cast<index_type>( hole_idx + total );
+        FT::remove( base, hdr, hole_idx );
+        std::memmove( hole, blk, static_cast<size_t>( total ) * AT::granule_size );
+        detail::note_dirty( hole, static_cast<size_t>( total ) * AT::granule_size );
+        BlockState::set_prev_offset_of( hole, prev );
+        BlockState::set_next_offset_of( hole, free_idx );
+        BlockState::set_root_offset_of( hole, hole_idx );
+        void* fb = detail::block_at<AT>( base, free_idx );
+        std::memset( fb, 0, sizeof( BlockT ) );
+        BlockState::init_fields( fb, hole_idx, next, 0, hole_gran, 0, NodeType::Free );
+        if ( next != AT::no_block )
+            BlockState::set_prev_offset_of( detail::block_at<AT>( base, next ), free_idx );
+        if ( hdr->last_block_offset == blk_idx )
+            hdr->last_block_offset = free_idx;
+        coalesce( arena, free_idx );
+        return total;
+    }
+    static void rebuild_free_tree( Arena arena, index_type limit = AT::no_block )
     {
         std::uint8_t*              base = arena.base();
         detail::ManagerHeader<AT>* hdr  = arena.header();
-        hdr->free_tree_root             = AT::no_block;
-        hdr->last_block_offset          = AT::no_block;
-        index_type last_seen            = AT::no_block;
-        auto       step                 = [&]( index_type idx, void* blk_ptr ) noexcept
+        detail::free_block_tree_reset<FT>( base, hdr );
+        hdr->last_block_offset = AT::no_block;
+        index_type last_seen   = AT::no_block;
+        auto       step        = [&]( index_type idx, void* blk_ptr ) noexcept
         {
+            if ( idx >= limit )
+                return detail::WalkControl::StopOk;
             BlockState::recover_state( blk_ptr, idx );
             if ( pmm::is_free( BlockState::get_node_type( blk_ptr ) ) )
             {
@@ -150,7 +346,7 @@ class AllocatorPolicy
                 FT::insert( base, hdr, idx );
             }
             last_seen = idx;
-            return true;
+            return detail::WalkControl::Continue;
         };
         (void)detail::for_each_physical_block_mut<AT>( arena, step );
         if ( last_seen != AT::no_block )
@@ -172,14 +368,16 @@ class AllocatorPolicy
         index_type block_count = 0, free_count = 0, alloc_count = 0, used_gran = 0;
         bool       walk_ok = true;
     };
-    static Counters accumulate_counters( ConstArena arena ) noexcept
+    static Counters accumulate_counters( ConstArena arena, index_type limit = AT::no_block ) noexcept
     {
         static constexpr index_type kBlkHdrGran = detail::kBlockHeaderGranules_t<AT>;
         Counters                    c;
         c.walk_ok = detail::for_each_physical_block<AT>(
             arena,
-            [&]( index_type, const void* blk_ptr ) noexcept
+            [&]( index_type idx, const void* blk_ptr ) noexcept
             {
+                if ( idx >= limit )
+                    return detail::WalkControl::StopOk;
                 ++c.block_count;
                 c.used_gran = static_cast<index_type>( c.used_gran + kBlkHdrGran );
                 if ( pmm::is_allocated( BlockState::get_node_type( blk_ptr ) ) )
@@ -191,13 +389,13 @@ class AllocatorPolicy
                 {
                     ++c.free_count;
                 }
-                return true;
+                return detail::WalkControl::Continue;
             } );
         return c;
     }
-    static void recompute_counters( Arena arena )
+    static void recompute_counters( Arena arena, index_type limit = AT::no_block )
     {
-        Counters                   c   = accumulate_counters( ConstArena{ arena.base(), arena.header() } );
+        Counters                   c   = accumulate_counters( ConstArena{ arena.base(), arena.header() }, limit );
         detail::ManagerHeader<AT>* hdr = arena.header();
         hdr->block_count               = c.block_count;
         hdr->free_count                = c.free_count;
@@ -226,9 +424,9 @@ class AllocatorPolicy
             result.add( ViolationType::HeaderCorruption, DiagnosticAction::NoAction );
         }
     }
-    static void verify_counters( ConstArena arena, VerifyResult& result ) noexcept
+    static void verify_counters( ConstArena arena, VerifyResult& result, index_type limit = AT::no_block ) noexcept
     {
-        Counters c = accumulate_counters( arena );
+        Counters c = accumulate_counters( arena, limit );
         if ( !c.walk_ok )
         {
             result.add( ViolationType::HeaderCorruption, DiagnosticAction::NoAction );
@@ -270,24 +468,28 @@ class AllocatorPolicy
             result.add( ViolationType::HeaderCorruption, DiagnosticAction::NoAction );
         }
     }
-    static void verify_free_tree( ConstArena arena, VerifyResult& result ) noexcept
+    static void verify_free_tree( ConstArena arena, VerifyResult& result, index_type limit = AT::no_block ) noexcept
     {
         const std::uint8_t*              base           = arena.base();
         const detail::ManagerHeader<AT>* hdr            = arena.header();
         std::size_t                      expected_count = 0;
-        const bool                       walk_ok =
-            detail::for_each_physical_block<AT>( arena,
-                                                 [&]( index_type, const void* blk_ptr ) noexcept
-                                                 {
-                                                     if ( pmm::is_free( BlockState::get_node_type( blk_ptr ) ) )
-                                                         ++expected_count;
-                                                     return true;
-                                                 } );
+        const bool                       walk_ok        = detail::for_each_physical_block<AT>(
+            arena,
+            [&]( index_type idx, const void* blk_ptr ) noexcept
+            {
+                if ( idx >= limit )
+                    return detail::WalkControl::StopOk;
+                if ( held_by_tree( blk_ptr ) )
+                    ++expected_count;
+                return detail::WalkControl::Continue;
+            } );
         if ( !walk_ok )
         {
             result.add( ViolationType::HeaderCorruption, DiagnosticAction::NoAction );
             return;
         }
+        if constexpr ( requires { FT::verify_lists( arena, result ); } )
+            FT::verify_lists( arena, result );
         const bool root_present = ( hdr->free_tree_root != AT::no_block );
         if ( expected_count == 0 )
         {
@@ -325,13 +527,15 @@ class AllocatorPolicy
             arena,
             [&]( index_type idx, const void* blk_ptr ) noexcept
             {
-                if ( pmm::is_free( BlockState::get_node_type( blk_ptr ) ) &&
+                if ( idx >= limit )
+                    return detail::WalkControl::StopOk;
+                if ( held_by_tree( blk_ptr ) &&
                      !free_tree_contains( base, hdr, hdr->free_tree_root, idx, expected_count ) )
                 {
                     result.add( ViolationType::FreeTreeStale, DiagnosticAction::NoAction, static_cast<uint64_t>( idx ),
                                 1, 0 );
                 }
-                return true;
+                return detail::WalkControl::Continue;
             } );
         if ( visited_count != expected_count )
         {
@@ -339,6 +543,14 @@ class AllocatorPolicy
                         static_cast<uint64_t>( expected_count ), static_cast<uint64_t>( visited_count ) );
         }
     }
+    static bool held_by_tree( const void* blk_ptr ) noexcept
+    {
+        if ( !pmm::is_free( BlockState::get_node_type( blk_ptr ) ) )
+            return false;
+        if constexpr ( requires { FT::tree_holds( index_type{} ); } )
+            return FT::tree_holds( BlockState::get_weight( blk_ptr ) );
+        return true;
+    }
     static index_type free_tree_block_granules( const std::uint8_t* base, const detail::ManagerHeader<AT>* hdr,
                                                 index_type block_idx ) noexcept
     {
@@ -461,6 +673,8 @@ class AllocatorPolicy
             BlockState::set_weight_of( blk_raw, new_data_gran );
             hdr->used_size -= ( old_data_gran - new_data_gran );
         }
+        note_allocated( old_data_gran, false );
+        note_allocated( new_data_gran, true );
     }
     static bool realloc_grow( Arena arena, index_type blk_idx, void* blk_raw, index_type old_data_gran,
                               index_type new_data_gran ) noexcept
@@ -486,6 +700,7 @@ class AllocatorPolicy
         else
             hdr->last_block_offset = blk_idx;
         std::memset( next_blk, 0, sizeof( BlockT ) );
+        detail::note_dirty( next_blk, sizeof( BlockT ) );
         hdr->block_count--;
         hdr->free_count--;
         if ( hdr->used_size >= kBlkHdrGran )
@@ -510,6 +725,8 @@ class AllocatorPolicy
         }
         BlockState::set_weight_of( blk_raw, new_data_gran );
         hdr->used_size += ( new_data_gran - old_data_gran );
+        note_allocated( old_data_gran, false );
+        note_allocated( new_data_gran, true );
         return true;
     }
 
@@ -0,0 +1,290 @@
+#pragma once
+#include "pmm/arena_internals.h"
+#include "pmm/block.h"
+#include "pmm/block_state.h"
+#include "pmm/layout.h"
+#include "pmm/types.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+namespace pmm::detail
+{
+template <typename ManagerT>
+/*
+### pmm-detail-arenaops
+req: qa-thread-001, qa-perf-001
+*/
+struct ArenaOps
+{
+    using address_traits = typename ManagerT::address_traits;
+    using index_type     = typename address_traits::index_type;
+    using thread_policy  = typename ManagerT::thread_policy;
+    using heap_stats     = typename ManagerT::heap_stats;
+    using allocator      = typename ManagerT::allocator;
+    using layout_ops     = ManagerLayoutOps<typename ManagerT::layout_access>;
+    using BlockState     = BlockStateBase<address_traits>;
+    using Header         = ManagerHeader<address_traits>;
+    static constexpr size_t kCount = ManagerT::kArenaCount;
+    static inline typename thread_policy::mutex_type _locks[kCount]{};
+    static inline std::atomic<size_t>                _next{ 0 };
+    static Header*                                   header( uint8_t* base, size_t a ) noexcept
+    {
+        return reinterpret_cast<Header*>( manager_header_reserve_at<address_traits>( ManagerT::get_header( base ) ) ) +
+               a;
+    }
+    static const Header* header_c( const uint8_t* base, size_t a ) noexcept
+    {
+        return reinterpret_cast<const Header*>(
+                   manager_header_reserve_at<address_traits>( ManagerT::get_header_c( base ) ) ) +
+               a;
+    }
+    static size_t arena_of( const uint8_t* base, index_type idx ) noexcept
+    {
+        size_t a = kCount - 1;
+        while ( a > 0 && idx < header_c( base, a )->first_block_offset )
+            --a;
+        return a;
+    }
+    static index_type limit( const uint8_t* base, size_t a ) noexcept
+    {
+        return ( a + 1 < kCount ) ? header_c( base, a + 1 )->first_block_offset : address_traits::no_block;
+    }
+    static index_type limit_of( const uint8_t* base, index_type idx ) noexcept
+    {
+        if constexpr ( ManagerT::kArenaMode )
+            return limit( base, arena_of( base, idx ) );
+        (void)base;
+        (void)idx;
+        return address_traits::no_block;
+    }
+    static Header* owning_header( uint8_t* base, index_type idx ) noexcept
+    {
+        if constexpr ( ManagerT::kArenaMode )
+            return header( base, arena_of( base, idx ) );
+        (void)idx;
+        return ManagerT::get_header( base );
+    }
+    static Header* local_header( uint8_t* base ) noexcept
+    {
+        if constexpr ( ManagerT::kArenaMode )
+            return header( base, thread_arena() );
+        return ManagerT::get_header( base );
+    }
+    static size_t thread_arena() noexcept
+    {
+        static thread_local size_t slot = _next.fetch_add( 1, std::memory_order_relaxed ) % kCount;
+        return slot;
+    }
+    static void* fit_unlocked( index_type data_gran, size_t align, bool by_offset ) noexcept
+    {
+        uint8_t* base  = ManagerT::_backend.base_ptr();
+        size_t   first = thread_arena();
+        for ( size_t i = 0; i < kCount; ++i )
+        {
+            void* raw = ManagerT::fit_in_unlocked( base, header( base, ( first + i ) % kCount ), data_gran, align,
+                                                   by_offset );
+            if ( raw != nullptr )
+                return raw;
+        }
+        return nullptr;
+    }
+    static void sync_header_unlocked() noexcept
+    {
+        uint8_t*   base   = ManagerT::_backend.base_ptr();
+        Header*    hdr    = ManagerT::get_header( base );
+        index_type blocks = 1, frees = 0, allocs = 1;
+        index_type used   = ManagerT::kBlockHdrGranules + ManagerT::kMgrHdrGranules;
+        for ( size_t a = 0; a < kCount; ++a )
+        {
+            const Header* sub = header_c( base, a );
+            blocks            = static_cast<index_type>( blocks + sub->block_count );
+            frees             = static_cast<index_type>( frees + sub->free_count );
+            allocs            = static_cast<index_type>( allocs + sub->alloc_count );
+            used              = static_cast<index_type>( used + sub->used_size );
+        }
+        hdr->block_count       = blocks;
+        hdr->free_count        = frees;
+        hdr->alloc_count       = allocs;
+        hdr->used_size         = used;
+        hdr->last_block_offset = header_c( base, kCount - 1 )->last_block_offset;
+    }
+    static void rebuild_unlocked() noexcept
+    {
+        uint8_t* base = ManagerT::_backend.base_ptr();
+        Header*  hdr  = ManagerT::get_header( base );
+        free_block_tree_reset<heap_stats>( base, hdr );
+        for ( size_t a = 0; a < kCount; ++a )
+        {
+            Header*    sub   = header( base, a );
+            index_type first = sub->first_block_offset;
+            std::memset( sub, 0, sizeof( Header ) );
+            sub->total_size         = hdr->total_size;
+            sub->first_block_offset = first;
+            ArenaView<address_traits> arena{ base, sub };
+            allocator::rebuild_free_tree( arena, limit( base, a ) );
+            allocator::recompute_counters( arena, limit( base, a ) );
+        }
+        sync_header_unlocked();
+    }
+    static bool partition_unlocked() noexcept
+    {
+        static constexpr index_type kMinRegion = 2 * ( ManagerT::kBlockHdrGranules + 1 );
+        uint8_t*                    base       = ManagerT::_backend.base_ptr();
+        size_t                      bytes      = ManagerT::get_header( base )->total_size;
+        index_type                  first      = ManagerT::kFreeBlkIdxLayout;
+        index_type                  total      = static_cast<index_type>( bytes / address_traits::granule_size );
+        index_type                  span       = static_cast<index_type>( ( total - first ) / kCount );
+        if ( span < kMinRegion )
+            return false;
+        header( base, 0 )->first_block_offset = first;
+        index_type prev                       = first;
+        for ( size_t a = 1; a < kCount; ++a )
+        {
+            index_type fence     = static_cast<index_type>( first + a * span );
+            index_type next      = static_cast<index_type>( fence + ManagerT::kBlockHdrGranules + 1 );
+            void*      fence_blk = block_at<address_traits>( base, fence );
+            void*      next_blk  = block_at<address_traits>( base, next );
+            std::memset( fence_blk, 0, sizeof( Block<address_traits> ) );
+            BlockState::init_fields( fence_blk, prev, next, 0, 1, fence, pmm::NodeType::ReadOnlyLocked );
+            std::memset( next_blk, 0, sizeof( Block<address_traits> ) );
+            BlockState::init_fields( next_blk, fence, address_traits::no_block, 0, 0, 0, pmm::NodeType::Free );
+            BlockState::set_next_offset_of( block_at<address_traits>( base, prev ), fence );
+            header( base, a )->first_block_offset = fence;
+            prev                                  = next;
+        }
+        rebuild_unlocked();
+        return true;
+    }
+    static bool layout_valid( const uint8_t* base ) noexcept
+    {
+        const Header* hdr  = ManagerT::get_header_c( base );
+        index_type    prev = 0;
+        for ( size_t a = 0; a < kCount; ++a )
+        {
+            const Header* sub   = header_c( base, a );
+            index_type    first = sub->first_block_offset;
+            if ( sub->total_size != hdr->total_size )
+                return false;
+            if ( a == 0 )
+            {
+                if ( first != ManagerT::kFreeBlkIdxLayout )
+                    return false;
+            }
+            else if ( first <= prev || !validate_block_index<address_traits>( hdr->total_size, first ) ||
+                      BlockState::get_node_type( block_at<address_traits>( base, first ) ) !=
+                          pmm::NodeType::ReadOnlyLocked )
+            {
+                return false;
+            }
+            prev = first;
+        }
+        return true;
+    }
+    static bool expand_unlocked( index_type data_gran ) noexcept
+    {
+        uint8_t* base = ManagerT::_backend.base_ptr();
+        Header*  hdr  = ManagerT::get_header( base );
+        Header*  last = header( base, kCount - 1 );
+        sync_header_unlocked();
+        index_type tail = hdr->last_block_offset;
+        if ( tail != address_traits::no_block &&
+             pmm::is_free( BlockState::get_node_type( block_at<address_traits>( base, tail ) ) ) )
+        {
+            heap_stats::remove( base, last, tail );
+            heap_stats::insert( base, hdr, tail );
+        }
+        index_type blocks = hdr->block_count, frees = hdr->free_count, used = hdr->used_size;
+        bool       ok     = layout_ops::do_expand( ManagerT::_backend, ManagerT::_initialized, data_gran );
+        base              = ManagerT::_backend.base_ptr();
+        hdr               = ManagerT::get_header( base );
+        last              = header( base, kCount - 1 );
+        for ( size_t a = 0; a < kCount; ++a )
+            header( base, a )->total_size = hdr->total_size;
+        last->block_count       = static_cast<index_type>( last->block_count + ( hdr->block_count - blocks ) );
+        last->free_count        = static_cast<index_type>( last->free_count + ( hdr->free_count - frees ) );
+        last->used_size         = static_cast<index_type>( last->used_size + ( hdr->used_size - used ) );
+        last->last_block_offset = hdr->last_block_offset;
+        tail                    = hdr->free_tree_root;
+        if ( tail != address_traits::no_block )
+        {
+            heap_stats::remove( base, hdr, tail );
+            heap_stats::insert( base, last, tail );
+        }
+        return ok;
+    }
+    static bool shrink_unlocked( size_t target_size ) noexcept
+    {
+        uint8_t* base = ManagerT::_backend.base_ptr();
+        Header*  hdr  = ManagerT::get_header( base );
+        Header*  last = header( base, kCount - 1 );
+        sync_header_unlocked();
+        index_type tail = hdr->last_block_offset;
+        if ( tail == address_traits::no_block ||
+             !pmm::is_free( BlockState::get_node_type( block_at<address_traits>( base, tail ) ) ) )
+            return false;
+        if ( BlockState::get_prev_offset( block_at<address_traits>( base, tail ) ) == last->first_block_offset )
+            target_size = std::max( target_size, static_cast<size_t>( tail ) * address_traits::granule_size + 1 );
+        heap_stats::remove( base, last, tail );
+        heap_stats::insert( base, hdr, tail );
+        index_type blocks = hdr->block_count, frees = hdr->free_count, used = hdr->used_size;
+        bool       ok     = layout_ops::do_shrink( ManagerT::_backend, ManagerT::_initialized, target_size );
+        base              = ManagerT::_backend.base_ptr();
+        hdr               = ManagerT::get_header( base );
+        last              = header( base, kCount - 1 );
+        for ( size_t a = 0; a < kCount; ++a )
+            header( base, a )->total_size = hdr->total_size;
+        last->block_count       = static_cast<index_type>( last->block_count - ( blocks - hdr->block_count ) );
+        last->free_count        = static_cast<index_type>( last->free_count - ( frees - hdr->free_count ) );
+        last->used_size         = static_cast<index_type>( last->used_size - ( used - hdr->used_size ) );
+        last->last_block_offset = hdr->last_block_offset;
+        tail                    = hdr->free_tree_root;
+        if ( tail != address_traits::no_block )
+        {
+            heap_stats::remove( base, hdr, tail );
+            heap_stats::insert( base, last, tail );
+        }
+        return ok;
+    }
+    template <typename Fn> static bool try_allocate( index_type data_gran, Fn& emit ) noexcept
+    {
+        typename thread_policy::shared_lock_type lock( ManagerT::_mutex );
+        if ( !ManagerT::writable_unlocked() )
+            return false;
+        uint8_t* base  = ManagerT::_backend.base_ptr();
+        size_t   first = thread_arena();
+        for ( size_t i = 0; i < kCount; ++i )
+        {
+            size_t                             a = ( first + i ) % kCount;
+            typename ManagerT::write_lock_type arena_lock( _locks[a] );
+            void*                              raw = ManagerT::fit_in_unlocked( base, header( base, a ), data_gran, 0 );
+            if ( raw != nullptr )
+            {
+                ManagerT::_last_error = PmmError::Ok;
+                emit( raw );
+                return true;
+            }
+        }
+        return false;
+    }
+    static size_t deallocate( void* ptr ) noexcept
+    {
+        typename thread_policy::shared_lock_type lock( ManagerT::_mutex );
+        if ( !ManagerT::_initialized || ptr == nullptr )
+            return 0;
+        pmm::Block<address_traits>* blk = ManagerT::find_block_from_user_ptr( ptr );
+        if ( blk == nullptr )
+            return 0;
+        uint8_t*                           base    = ManagerT::_backend.base_ptr();
+        index_type                         blk_idx = block_idx_t<address_traits>( base, blk );
+        size_t                             a       = arena_of( base, blk_idx );
+        typename ManagerT::write_lock_type arena_lock( _locks[a] );
+        if ( !ManagerT::deallocatable_block( blk ) )
+            return 0;
+        size_t bytes = ManagerT::granted_bytes_unlocked( ptr );
+        ManagerT::release_block( ArenaView<address_traits>{ base, header( base, a ) }, blk_idx );
+        return ManagerT::note_deallocate_unlocked( ptr, bytes );
+    }
+};
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "pmm/block.h"
 #include "pmm/block_state.h"
+#include "pmm/dirty_tracking.h"
 #include "pmm/types.h"
 #include <cassert>
 #include <concepts>
@@ -15,6 +16,11 @@ template <typename PPtr> static constexpr auto pptr_no_block() noexcept
 {
     return PPtr::manager_type::address_traits::no_block;
 }
+template <typename FieldT, typename ValueT> static void avl_store( FieldT& field, ValueT value ) noexcept
+{
+    field = static_cast<FieldT>( value );
+    note_dirty( &field, sizeof( FieldT ) );
+}
 template <typename PPtr> static PPtr pptr_make( PPtr, typename PPtr::index_type idx ) noexcept
 {
     return PPtr( idx );
@@ -36,18 +42,18 @@ template <typename PPtr> static PPtr pptr_get_parent( PPtr p ) noexcept
 }
 template <typename PPtr> static void pptr_set_left( PPtr p, PPtr child ) noexcept
 {
-    auto idx                  = child.is_null() ? pptr_no_block<PPtr>() : child.offset();
-    p.tree_node_unchecked().left_offset = idx;
+    auto idx = child.is_null() ? pptr_no_block<PPtr>() : child.offset();
+    avl_store( p.tree_node_unchecked().left_offset, idx );
 }
 template <typename PPtr> static void pptr_set_right( PPtr p, PPtr child ) noexcept
 {
-    auto idx                   = child.is_null() ? pptr_no_block<PPtr>() : child.offset();
-    p.tree_node_unchecked().right_offset = idx;
+    auto idx = child.is_null() ? pptr_no_block<PPtr>() : child.offset();
+    avl_store( p.tree_node_unchecked().right_offset, idx );
 }
 template <typename PPtr> static void pptr_set_parent( PPtr p, PPtr parent ) noexcept
 {
-    auto idx                    = parent.is_null() ? pptr_no_block<PPtr>() : parent.offset();
-    p.tree_node_unchecked().parent_offset = idx;
+    auto idx = parent.is_null() ? pptr_no_block<PPtr>() : parent.offset();
+    avl_store( p.tree_node_unchecked().parent_offset, idx );
 }
 template <typename PPtr> static std::int16_t avl_height( PPtr p ) noexcept
 {
@@ -64,7 +70,7 @@ template <typename PPtr> static void avl_update_height( PPtr p ) noexcept
     std::int16_t h  = static_cast<std::int16_t>( 1 + ( lh > rh ? lh : rh ) );
     assert( h >= 0 );
     assert( h <= static_cast<std::int16_t>( ( std::numeric_limits<std::uint8_t>::max )() ) );
-    p.tree_node_unchecked().avl_height = static_cast<std::uint8_t>( h );
+    avl_store( p.tree_node_unchecked().avl_height, h );
 }
 template <typename PPtr> static std::int16_t avl_balance_factor( PPtr p ) noexcept
 {
@@ -79,7 +85,7 @@ static void avl_set_child( PPtr parent, PPtr old_child, PPtr new_child, IndexTyp
 {
     if ( parent.is_null() )
     {
-        root_idx = new_child.offset();
+        avl_store( root_idx, new_child.offset() );
         return;
     }
     PPtr left_of_parent = pptr_get_left( parent );
@@ -279,11 +285,11 @@ template <typename PPtr> static PPtr avl_inorder_successor( PPtr cur ) noexcept
 }
 template <typename PPtr> static void avl_init_node( PPtr p ) noexcept
 {
-    auto& tn         = p.tree_node_unchecked();
-    tn.left_offset   = pptr_no_block<PPtr>();
-    tn.right_offset  = pptr_no_block<PPtr>();
-    tn.parent_offset = pptr_no_block<PPtr>();
-    tn.avl_height    = static_cast<std::int16_t>( 1 );
+    auto&& tn = p.tree_node_unchecked();
+    avl_store( tn.left_offset, pptr_no_block<PPtr>() );
+    avl_store( tn.right_offset, pptr_no_block<PPtr>() );
+    avl_store( tn.parent_offset, pptr_no_block<PPtr>() );
+    avl_store( tn.avl_height, 1 );
 }
 template <typename PPtr> static size_t avl_subtree_count( PPtr p ) noexcept
 {
@@ -315,8 +321,8 @@ static void avl_insert( PPtr new_node, IndexType& root_idx, GoLeftFn&& go_left,
         pptr_set_left( new_node, PPtr() );
         pptr_set_right( new_node, PPtr() );
         pptr_set_parent( new_node, PPtr() );
-        new_node.tree_node_unchecked().avl_height = static_cast<std::int16_t>( 1 );
-        root_idx                        = new_node.offset();
+        avl_store( new_node.tree_node_unchecked().avl_height, 1 );
+        avl_store( root_idx, new_node.offset() );
         return;
     }
     PPtr cur( root_idx );
@@ -404,7 +410,7 @@ template <ForestDomainDescriptor Domain> struct ForestDomainOps : ForestDomainVi
         index_type* root = root_index_ptr();
         if ( root == nullptr )
             return false;
-        *root = static_cast<index_type>( 0 );
+        avl_store( *root, 0 );
         return true;
     }
     void insert( node_pptr new_node ) noexcept
@@ -440,9 +446,9 @@ template <typename AT> struct BlockPPtr
     index_type       offset() const noexcept { return _idx; }
     bool             operator==( const BlockPPtr& other ) const noexcept { return _idx == other._idx; }
     bool             operator!=( const BlockPPtr& other ) const noexcept { return _idx != other._idx; }
-    BlockHeader<AT>& tree_node_unchecked() const noexcept
+    decltype( auto ) tree_node_unchecked() const noexcept
     {
-        return *block_header_at<AT>( block_at<AT>( _base, _idx ) );
+        return BlockStateBase<AT>::tree_node_of( block_at<AT>( _base, _idx ) );
     }
 };
 template <typename AT> static BlockPPtr<AT> pptr_make( BlockPPtr<AT> source, typename AT::index_type idx ) noexcept
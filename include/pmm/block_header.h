@@ -159,7 +159,40 @@ template <typename AT> struct BlockHeaderStorageImpl<AT, 0>
     std::uint8_t avl_height;
     NodeType     node_type;
 };
-template <typename AT> using BlockHeaderStorage = BlockHeaderStorageImpl<AT, block_header_trailer_pad_v<AT>>;
+template <typename AT> inline constexpr bool compact_block_header_v = false;
+template <typename AT>
+    requires requires { AT::compact_block_header; }
+inline constexpr bool compact_block_header_v<AT> = AT::compact_block_header;
+template <typename AT> struct CompactBlockHeaderStorage
+{
+    using index_type = typename AT::index_type;
+    index_type    weight;
+    index_type    prev_offset;
+    index_type    next_offset;
+    std::uint16_t root_tag;
+    std::uint8_t  avl_height;
+    NodeType      node_type;
+};
+template <typename AT> struct BlockTreeSlot
+{
+    using index_type = typename AT::index_type;
+    index_type left_offset;
+    index_type right_offset;
+    index_type parent_offset;
+};
+template <typename AT> struct BlockTreeNodeRef
+{
+    using index_type = typename AT::index_type;
+    index_type&   left_offset;
+    index_type&   right_offset;
+    index_type&   parent_offset;
+    std::uint8_t& avl_height;
+};
+template <typename AT>
+using BlockHeaderStorage = std::conditional_t<compact_block_header_v<AT>, CompactBlockHeaderStorage<AT>,
+                                              BlockHeaderStorageImpl<AT, block_header_trailer_pad_v<AT>>>;
+template <typename AT>
+inline constexpr std::size_t block_tree_slot_bytes_v = compact_block_header_v<AT> ? sizeof( BlockTreeSlot<AT> ) : 0;
 }
 /*
 ## pmm-blockheader
@@ -184,8 +217,9 @@ template <typename AT> struct BlockLayoutContract
     static_assert( AT::granule_size >= alignof( H ) );
     static_assert( ( AT::granule_size % alignof( H ) ) == 0 );
     static_assert( ( sizeof( H ) % AT::granule_size ) == 0 );
-    static constexpr std::size_t tree_slot_size = offsetof( H, prev_offset );
-    static constexpr std::size_t layout_size    = sizeof( H );
+    static constexpr std::size_t tree_slot_size =
+        detail::compact_block_header_v<AT> ? sizeof( detail::BlockTreeSlot<AT> ) : offsetof( H, prev_offset );
+    static constexpr std::size_t layout_size = sizeof( H );
 };
 static_assert( std::is_standard_layout_v<BlockHeader<DefaultAddressTraits>> );
 static_assert( std::is_trivially_copyable_v<BlockHeader<DefaultAddressTraits>> );
@@ -204,6 +238,11 @@ static_assert( offsetof( BlockHeader<DefaultAddressTraits>, node_type ) ==
 static_assert( ( sizeof( BlockHeader<SmallAddressTraits> ) % SmallAddressTraits::granule_size ) == 0 );
 static_assert( ( sizeof( BlockHeader<DefaultAddressTraits> ) % DefaultAddressTraits::granule_size ) == 0 );
 static_assert( ( sizeof( BlockHeader<LargeAddressTraits> ) % LargeAddressTraits::granule_size ) == 0 );
+static_assert( sizeof( BlockHeader<CompactAddressTraits> ) == 16 );
+static_assert( offsetof( BlockHeader<CompactAddressTraits>, node_type ) ==
+               sizeof( BlockHeader<CompactAddressTraits> ) - 1 );
+static_assert( detail::block_tree_slot_bytes_v<CompactAddressTraits> + sizeof( CompactAddressTraits::index_type ) <=
+               CompactAddressTraits::granule_size );
 namespace detail
 {
 template <typename AT> inline BlockHeader<AT>* block_header_at( void* raw ) noexcept
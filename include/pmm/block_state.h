@@ -3,6 +3,7 @@
 #include "pmm/block.h"
 #include "pmm/block_header.h"
 #include "pmm/diagnostics.h"
+#include "pmm/dirty_tracking.h"
 #include <cassert>
 #include <cstdint>
 #include <cstring>
@@ -26,14 +27,52 @@ template <typename AT> class BlockStateBase
     using address_traits = AT;
     using index_type     = typename AT::index_type;
     using Header         = BlockHeader<AT>;
-    BlockStateBase()     = delete;
+    using TreeSlot       = detail::BlockTreeSlot<AT>;
+    static constexpr bool kCompactHeader = detail::compact_block_header_v<AT>;
+    BlockStateBase()                     = delete;
     static Header*       header_of( void* raw_blk ) noexcept { return detail::block_header_at<AT>( raw_blk ); }
     static const Header* header_of( const void* raw_blk ) noexcept { return detail::block_header_at<AT>( raw_blk ); }
+/*
+### pmm-blockstatebase-tree_slot_of
+req: dr-001, qa-mem-001
+*/
+    static TreeSlot* tree_slot_of( void* raw_blk ) noexcept
+    {
+        return const_cast<TreeSlot*>( tree_slot_of( static_cast<const void*>( raw_blk ) ) );
+    }
+    static const TreeSlot* tree_slot_of( const void* raw_blk ) noexcept
+    {
+        static_assert( kCompactHeader, "" );
+        const uint8_t* payload = static_cast<const uint8_t*>( raw_blk ) + sizeof( Header );
+        if ( !pmm::is_free( header_of( raw_blk )->node_type ) )
+            payload += AT::granules_to_bytes( header_of( raw_blk )->weight ) - sizeof( TreeSlot );
+        return reinterpret_cast<const TreeSlot*>( payload );
+    }
+    static decltype( auto ) tree_node_of( void* raw_blk ) noexcept
+    {
+        if constexpr ( kCompactHeader )
+        {
+            TreeSlot* slot = tree_slot_of( raw_blk );
+            return detail::BlockTreeNodeRef<AT>{ slot->left_offset, slot->right_offset, slot->parent_offset,
+                                                  header_of( raw_blk )->avl_height };
+        }
+        else
+        {
+            return static_cast<Header&>( *header_of( raw_blk ) );
+        }
+    }
+    static constexpr index_type root_offset_for( index_type own_idx ) noexcept
+    {
+        if constexpr ( kCompactHeader )
+            return static_cast<index_type>( static_cast<std::uint16_t>( own_idx ) );
+        else
+            return own_idx;
+    }
     static bool is_free_raw( const void* raw_blk ) noexcept { return pmm::is_free( header_of( raw_blk )->node_type ); }
     static bool is_allocated_raw( const void* raw_blk, index_type own_idx ) noexcept
     {
-        const Header* h = header_of( raw_blk );
-        return pmm::is_allocated( h->node_type ) && h->root_offset == own_idx;
+        return pmm::is_allocated( header_of( raw_blk )->node_type ) &&
+               get_root_offset( raw_blk ) == root_offset_for( own_idx );
     }
 /*
 ### pmm-blockstatebase-recover_state
@@ -41,10 +80,10 @@ template <typename AT> class BlockStateBase
     static void recover_state( void* raw_blk, index_type own_idx ) noexcept
     {
         Header* h = header_of( raw_blk );
-        if ( pmm::is_allocated( h->node_type ) && h->root_offset != own_idx )
-            h->root_offset = own_idx;
-        if ( pmm::is_free( h->node_type ) && h->root_offset != 0 )
-            h->root_offset = 0;
+        if ( pmm::is_allocated( h->node_type ) && get_root_offset( h ) != root_offset_for( own_idx ) )
+            set_root_offset_of( h, own_idx );
+        if ( pmm::is_free( h->node_type ) && get_root_offset( h ) != 0 )
+            set_root_offset_of( h, 0 );
     }
 /*
 ### pmm-blockstatebase-verify_state
@@ -52,62 +91,148 @@ template <typename AT> class BlockStateBase
     static void verify_state( const void* raw_blk, index_type own_idx, VerifyResult& result ) noexcept
     {
         const Header* h = header_of( raw_blk );
-        if ( pmm::is_allocated( h->node_type ) && h->root_offset != own_idx )
+        if ( pmm::is_allocated( h->node_type ) && get_root_offset( h ) != root_offset_for( own_idx ) )
         {
             result.add( ViolationType::BlockStateInconsistent, DiagnosticAction::NoAction,
-                        static_cast<uint64_t>( own_idx ), static_cast<uint64_t>( own_idx ),
-                        static_cast<uint64_t>( h->root_offset ) );
+                        static_cast<uint64_t>( own_idx ), static_cast<uint64_t>( root_offset_for( own_idx ) ),
+                        static_cast<uint64_t>( get_root_offset( h ) ) );
         }
-        if ( pmm::is_free( h->node_type ) && h->root_offset != 0 )
+        if ( pmm::is_free( h->node_type ) && get_root_offset( h ) != 0 )
         {
             result.add( ViolationType::BlockStateInconsistent, DiagnosticAction::NoAction,
-                        static_cast<uint64_t>( own_idx ), 0, static_cast<uint64_t>( h->root_offset ) );
+                        static_cast<uint64_t>( own_idx ), 0, static_cast<uint64_t>( get_root_offset( h ) ) );
         }
     }
     static void reset_avl_fields_of( void* raw_blk ) noexcept
     {
-        Header* h        = header_of( raw_blk );
-        h->left_offset   = AT::no_block;
-        h->right_offset  = AT::no_block;
-        h->parent_offset = AT::no_block;
-        h->avl_height    = 0;
+        set_tree_links_of( raw_blk, AT::no_block, AT::no_block, AT::no_block );
+        header_to_write( raw_blk )->avl_height = 0;
+    }
+    static void set_tree_links_of( void* raw_blk, index_type left, index_type right, index_type parent ) noexcept
+    {
+        if constexpr ( kCompactHeader )
+        {
+            if ( !pmm::is_free( header_of( raw_blk )->node_type ) )
+                return;
+            TreeSlot* slot      = tree_slot_to_write( raw_blk );
+            slot->left_offset   = left;
+            slot->right_offset  = right;
+            slot->parent_offset = parent;
+        }
+        else
+        {
+            Header* h        = header_to_write( raw_blk );
+            h->left_offset   = left;
+            h->right_offset  = right;
+            h->parent_offset = parent;
+        }
     }
     static void repair_prev_offset( void* raw_blk, index_type prev_idx ) noexcept
     {
-        header_of( raw_blk )->prev_offset = prev_idx;
+        header_to_write( raw_blk )->prev_offset = prev_idx;
     }
     static index_type   get_prev_offset( const void* raw_blk ) noexcept { return header_of( raw_blk )->prev_offset; }
     static index_type   get_next_offset( const void* raw_blk ) noexcept { return header_of( raw_blk )->next_offset; }
     static index_type   get_weight( const void* raw_blk ) noexcept { return header_of( raw_blk )->weight; }
-    static index_type   get_left_offset( const void* b ) noexcept { return header_of( b )->left_offset; }
-    static index_type   get_right_offset( const void* b ) noexcept { return header_of( b )->right_offset; }
-    static index_type   get_parent_offset( const void* b ) noexcept { return header_of( b )->parent_offset; }
-    static index_type   get_root_offset( const void* b ) noexcept { return header_of( b )->root_offset; }
+    static index_type   get_left_offset( const void* b ) noexcept
+    {
+        if constexpr ( kCompactHeader )
+            return tree_slot_of( b )->left_offset;
+        else
+            return header_of( b )->left_offset;
+    }
+    static index_type get_right_offset( const void* b ) noexcept
+    {
+        if constexpr ( kCompactHeader )
+            return tree_slot_of( b )->right_offset;
+        else
+            return header_of( b )->right_offset;
+    }
+    static index_type get_parent_offset( const void* b ) noexcept
+    {
+        if constexpr ( kCompactHeader )
+            return tree_slot_of( b )->parent_offset;
+        else
+            return header_of( b )->parent_offset;
+    }
+    static index_type get_root_offset( const void* b ) noexcept
+    {
+        if constexpr ( kCompactHeader )
+            return header_of( b )->root_tag;
+        else
+            return header_of( b )->root_offset;
+    }
     static std::uint8_t get_avl_height( const void* raw_blk ) noexcept { return header_of( raw_blk )->avl_height; }
     static NodeType     get_node_type( const void* raw_blk ) noexcept { return header_of( raw_blk )->node_type; }
     static void init_fields( void* raw_blk, index_type prev_idx, index_type next_idx, std::uint8_t avl_height_val,
                              index_type weight_val, index_type root_offset_val, NodeType node_type_val ) noexcept
     {
-        Header* h        = header_of( raw_blk );
-        h->prev_offset   = prev_idx;
-        h->next_offset   = next_idx;
-        h->left_offset   = AT::no_block;
-        h->right_offset  = AT::no_block;
-        h->parent_offset = AT::no_block;
-        h->avl_height    = avl_height_val;
-        h->weight        = weight_val;
-        h->root_offset   = root_offset_val;
-        h->node_type     = node_type_val;
-    }
-    static void set_next_offset_of( void* b, index_type v ) noexcept { header_of( b )->next_offset = v; }
-    static void set_prev_offset_of( void* b, index_type v ) noexcept { header_of( b )->prev_offset = v; }
-    static void set_left_offset_of( void* b, index_type v ) noexcept { header_of( b )->left_offset = v; }
-    static void set_right_offset_of( void* b, index_type v ) noexcept { header_of( b )->right_offset = v; }
-    static void set_parent_offset_of( void* b, index_type v ) noexcept { header_of( b )->parent_offset = v; }
-    static void set_weight_of( void* b, index_type v ) noexcept { header_of( b )->weight = v; }
-    static void set_root_offset_of( void* b, index_type v ) noexcept { header_of( b )->root_offset = v; }
-    static void set_avl_height_of( void* b, std::uint8_t v ) noexcept { header_of( b )->avl_height = v; }
-    static void set_node_type_of( void* b, NodeType v ) noexcept { header_of( b )->node_type = v; }
+        Header* h      = header_to_write( raw_blk );
+        h->prev_offset = prev_idx;
+        h->next_offset = next_idx;
+        h->avl_height  = avl_height_val;
+        h->weight      = weight_val;
+        h->node_type   = node_type_val;
+        set_root_offset_of( h, root_offset_val );
+        set_tree_links_of( h, AT::no_block, AT::no_block, AT::no_block );
+    }
+    static void set_next_offset_of( void* b, index_type v ) noexcept { header_to_write( b )->next_offset = v; }
+    static void set_prev_offset_of( void* b, index_type v ) noexcept { header_to_write( b )->prev_offset = v; }
+    static void set_left_offset_of( void* b, index_type v ) noexcept
+    {
+        if constexpr ( kCompactHeader )
+        {
+            if ( pmm::is_free( header_of( b )->node_type ) )
+                tree_slot_to_write( b )->left_offset = v;
+        }
+        else
+            header_to_write( b )->left_offset = v;
+    }
+    static void set_right_offset_of( void* b, index_type v ) noexcept
+    {
+        if constexpr ( kCompactHeader )
+        {
+            if ( pmm::is_free( header_of( b )->node_type ) )
+                tree_slot_to_write( b )->right_offset = v;
+        }
+        else
+            header_to_write( b )->right_offset = v;
+    }
+    static void set_parent_offset_of( void* b, index_type v ) noexcept
+    {
+        if constexpr ( kCompactHeader )
+        {
+            if ( pmm::is_free( header_of( b )->node_type ) )
+                tree_slot_to_write( b )->parent_offset = v;
+        }
+        else
+            header_to_write( b )->parent_offset = v;
+    }
+    static void set_weight_of( void* b, index_type v ) noexcept { header_to_write( b )->weight = v; }
+    static void set_root_offset_of( void* b, index_type v ) noexcept
+    {
+        if constexpr ( kCompactHeader )
+            header_to_write( b )->root_tag = static_cast<std::uint16_t>( v );
+        else
+            header_to_write( b )->root_offset = v;
+    }
+    static void set_avl_height_of( void* b, std::uint8_t v ) noexcept { header_to_write( b )->avl_height = v; }
+    static void set_node_type_of( void* b, NodeType v ) noexcept { header_to_write( b )->node_type = v; }
+/*
+### pmm-blockstatebase-header_to_write
+req: qa-mem-001
+*/
+    static Header* header_to_write( void* raw_blk ) noexcept
+    {
+        detail::note_dirty( raw_blk, sizeof( Header ) );
+        return header_of( raw_blk );
+    }
+    static TreeSlot* tree_slot_to_write( void* raw_blk ) noexcept
+    {
+        TreeSlot* slot = tree_slot_of( raw_blk );
+        detail::note_dirty( slot, sizeof( TreeSlot ) );
+        return slot;
+    }
 };
 /*
 ## pmm-freeblock
@@ -126,10 +251,10 @@ template <typename AT> class FreeBlock
     index_type    weight() const noexcept { return h_->weight; }
     index_type    prev_offset() const noexcept { return h_->prev_offset; }
     index_type    next_offset() const noexcept { return h_->next_offset; }
-    index_type    left_offset() const noexcept { return h_->left_offset; }
-    index_type    right_offset() const noexcept { return h_->right_offset; }
-    index_type    parent_offset() const noexcept { return h_->parent_offset; }
-    index_type    root_offset() const noexcept { return h_->root_offset; }
+    index_type    left_offset() const noexcept { return Base::get_left_offset( h_ ); }
+    index_type    right_offset() const noexcept { return Base::get_right_offset( h_ ); }
+    index_type    parent_offset() const noexcept { return Base::get_parent_offset( h_ ); }
+    index_type    root_offset() const noexcept { return Base::get_root_offset( h_ ); }
     std::uint8_t  avl_height() const noexcept { return h_->avl_height; }
     NodeType      node_type() const noexcept { return h_->node_type; }
     bool          is_free() const noexcept { return pmm::is_free( h_->node_type ); }
@@ -189,7 +314,7 @@ template <typename AT> class FreeBlockRemovedAVL
     index_type                 weight() const noexcept { return h_->weight; }
     index_type                 prev_offset() const noexcept { return h_->prev_offset; }
     index_type                 next_offset() const noexcept { return h_->next_offset; }
-    index_type                 root_offset() const noexcept { return h_->root_offset; }
+    index_type                 root_offset() const noexcept { return BlockStateBase<AT>::get_root_offset( h_ ); }
     static FreeBlockRemovedAVL cast_from_raw( void* raw ) noexcept
     {
         return FreeBlockRemovedAVL( *detail::block_header_at<AT>( raw ) );
@@ -223,22 +348,14 @@ template <typename AT> class SplittingBlock
                                index_type new_block_total_granules ) noexcept
     {
         std::memset( new_blk_ptr, 0, sizeof( BlockHeader<AT> ) );
-        Header* nh        = detail::block_header_at<AT>( new_blk_ptr );
-        nh->prev_offset   = own_idx;
-        nh->next_offset   = h_->next_offset;
-        nh->left_offset   = AT::no_block;
-        nh->right_offset  = AT::no_block;
-        nh->parent_offset = AT::no_block;
-        nh->avl_height    = 1;
-        nh->weight        = new_block_total_granules;
-        nh->root_offset   = 0;
-        nh->node_type     = NodeType::Free;
+        BlockStateBase<AT>::init_fields( new_blk_ptr, own_idx, h_->next_offset, 1, new_block_total_granules, 0,
+                                         NodeType::Free );
     }
     void link_new_block( void* old_next_blk, index_type new_idx ) noexcept
     {
         if ( old_next_blk != nullptr )
-            detail::block_header_at<AT>( old_next_blk )->prev_offset = new_idx;
-        h_->next_offset = new_idx;
+            BlockStateBase<AT>::set_prev_offset_of( old_next_blk, new_idx );
+        BlockStateBase<AT>::set_next_offset_of( h_, new_idx );
     }
     AllocatedBlock<AT> finalize_split( index_type data_granules, index_type own_idx ) noexcept;
 
@@ -259,7 +376,7 @@ template <typename AT> class AllocatedBlock
     Header&       header() noexcept { return *h_; }
     const Header& header() const noexcept { return *h_; }
     index_type    weight() const noexcept { return h_->weight; }
-    index_type    root_offset() const noexcept { return h_->root_offset; }
+    index_type    root_offset() const noexcept { return BlockStateBase<AT>::get_root_offset( h_ ); }
     NodeType      node_type() const noexcept { return h_->node_type; }
 /*
 ### pmm-allocatedblock-cast_from_raw
@@ -297,7 +414,7 @@ template <typename AT> class AllocatedBlock
 */
     bool verify_invariants( index_type own_idx ) const noexcept
     {
-        return pmm::is_allocated( h_->node_type ) && h_->root_offset == own_idx;
+        return BlockStateBase<AT>::is_allocated_raw( h_, own_idx );
     }
     void*       user_ptr() noexcept { return reinterpret_cast<uint8_t*>( h_ ) + sizeof( Header ); }
     const void* user_ptr() const noexcept { return reinterpret_cast<const uint8_t*>( h_ ) + sizeof( Header ); }
@@ -320,7 +437,7 @@ template <typename AT> class FreeBlockNotInAVL
     Header&                  header() noexcept { return *h_; }
     const Header&            header() const noexcept { return *h_; }
     index_type               weight() const noexcept { return h_->weight; }
-    index_type               root_offset() const noexcept { return h_->root_offset; }
+    index_type               root_offset() const noexcept { return BlockStateBase<AT>::get_root_offset( h_ ); }
     static FreeBlockNotInAVL cast_from_raw( void* raw ) noexcept
     {
         return FreeBlockNotInAVL( *detail::block_header_at<AT>( raw ) );
@@ -328,7 +445,7 @@ template <typename AT> class FreeBlockNotInAVL
     CoalescingBlock<AT> begin_coalescing() noexcept;
     FreeBlock<AT>       insert_to_avl() noexcept
     {
-        h_->avl_height = 1;
+        BlockStateBase<AT>::set_avl_height_of( h_, 1 );
         return FreeBlock<AT>( *h_ );
     }
 
@@ -358,28 +475,28 @@ template <typename AT> class CoalescingBlock
     void coalesce_with_next( void* next_blk, void* next_next_blk, index_type own_idx,
                              index_type next_block_granules ) noexcept
     {
-        Header* nx      = detail::block_header_at<AT>( next_blk );
-        h_->next_offset = nx->next_offset;
+        const Header* nx = detail::block_header_at<AT>( static_cast<const void*>( next_blk ) );
+        BlockStateBase<AT>::set_next_offset_of( h_, nx->next_offset );
         if ( next_next_blk != nullptr )
-            detail::block_header_at<AT>( next_next_blk )->prev_offset = own_idx;
-        std::memset( next_blk, 0, sizeof( Header ) );
-        h_->weight = static_cast<index_type>( h_->weight + next_block_granules );
+            BlockStateBase<AT>::set_prev_offset_of( next_next_blk, own_idx );
+        std::memset( BlockStateBase<AT>::header_to_write( next_blk ), 0, sizeof( Header ) );
+        BlockStateBase<AT>::set_weight_of( h_, static_cast<index_type>( h_->weight + next_block_granules ) );
     }
     CoalescingBlock coalesce_with_prev( void* prev_blk, void* next_blk, index_type prev_idx,
                                         index_type self_block_granules ) noexcept
     {
-        Header* prev      = detail::block_header_at<AT>( prev_blk );
-        prev->next_offset = h_->next_offset;
+        Header* prev = detail::block_header_at<AT>( prev_blk );
+        BlockStateBase<AT>::set_next_offset_of( prev, h_->next_offset );
         if ( next_blk != nullptr )
-            detail::block_header_at<AT>( next_blk )->prev_offset = prev_idx;
-        std::memset( h_, 0, sizeof( Header ) );
-        prev->weight = static_cast<index_type>( prev->weight + self_block_granules );
+            BlockStateBase<AT>::set_prev_offset_of( next_blk, prev_idx );
+        std::memset( BlockStateBase<AT>::header_to_write( h_ ), 0, sizeof( Header ) );
+        BlockStateBase<AT>::set_weight_of( prev, static_cast<index_type>( prev->weight + self_block_granules ) );
         return CoalescingBlock( *prev );
     }
     FreeBlock<AT> finalize_coalesce() noexcept
     {
-        h_->avl_height = 1;
-        h_->node_type  = NodeType::Free;
+        BlockStateBase<AT>::set_avl_height_of( h_, 1 );
+        BlockStateBase<AT>::set_node_type_of( h_, NodeType::Free );
         return FreeBlock<AT>( *h_ );
     }
 
@@ -393,13 +510,10 @@ template <typename AT> FreeBlockRemovedAVL<AT> FreeBlock<AT>::remove_from_avl()
 template <typename AT>
 AllocatedBlock<AT> FreeBlockRemovedAVL<AT>::mark_as_allocated( index_type data_granules, index_type own_idx ) noexcept
 {
-    h_->weight        = data_granules;
-    h_->root_offset   = own_idx;
-    h_->left_offset   = AT::no_block;
-    h_->right_offset  = AT::no_block;
-    h_->parent_offset = AT::no_block;
-    h_->avl_height    = 0;
-    h_->node_type     = NodeType::Generic;
+    BlockStateBase<AT>::reset_avl_fields_of( h_ );
+    BlockStateBase<AT>::set_weight_of( h_, data_granules );
+    BlockStateBase<AT>::set_node_type_of( h_, NodeType::Generic );
+    BlockStateBase<AT>::set_root_offset_of( h_, own_idx );
     return AllocatedBlock<AT>( *h_ );
 }
 template <typename AT> SplittingBlock<AT> FreeBlockRemovedAVL<AT>::begin_splitting() noexcept
@@ -409,20 +523,17 @@ template <typename AT> SplittingBlock<AT> FreeBlockRemovedAVL<AT>::begin_splitti
 template <typename AT>
 AllocatedBlock<AT> SplittingBlock<AT>::finalize_split( index_type data_granules, index_type own_idx ) noexcept
 {
-    h_->weight        = data_granules;
-    h_->root_offset   = own_idx;
-    h_->left_offset   = AT::no_block;
-    h_->right_offset  = AT::no_block;
-    h_->parent_offset = AT::no_block;
-    h_->avl_height    = 0;
-    h_->node_type     = NodeType::Generic;
+    BlockStateBase<AT>::reset_avl_fields_of( h_ );
+    BlockStateBase<AT>::set_weight_of( h_, data_granules );
+    BlockStateBase<AT>::set_node_type_of( h_, NodeType::Generic );
+    BlockStateBase<AT>::set_root_offset_of( h_, own_idx );
     return AllocatedBlock<AT>( *h_ );
 }
 template <typename AT> FreeBlockNotInAVL<AT> AllocatedBlock<AT>::mark_as_free( index_type total_granules ) noexcept
 {
-    h_->weight      = total_granules;
-    h_->root_offset = 0;
-    h_->node_type   = NodeType::Free;
+    BlockStateBase<AT>::set_weight_of( h_, total_granules );
+    BlockStateBase<AT>::set_node_type_of( h_, NodeType::Free );
+    BlockStateBase<AT>::set_root_offset_of( h_, 0 );
     return FreeBlockNotInAVL<AT>( *h_ );
 }
 template <typename AT> CoalescingBlock<AT> FreeBlockNotInAVL<AT>::begin_coalescing() noexcept
@@ -0,0 +1,198 @@
+#pragma once
+#include "pmm/arena_internals.h"
+#include "pmm/avl_tree_mixin.h"
+#include "pmm/block.h"
+#include "pmm/block_state.h"
+#include "pmm/dirty_tracking.h"
+#include "pmm/types.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+namespace pmm::detail
+{
+template <typename ManagerT>
+/*
+### pmm-detail-compactionops
+req: fr-004, feat-003
+*/
+struct CompactionOps
+{
+    using address_traits = typename ManagerT::address_traits;
+    using index_type     = typename address_traits::index_type;
+    using forest_domain  = typename ManagerT::forest_domain;
+    using BlockState     = BlockStateBase<address_traits>;
+    using clock          = std::chrono::steady_clock;
+    struct DataRefs
+    {
+        std::vector<index_type*> refs;
+        bool                     built = false;
+    };
+    static inline index_type _cursor = 0;
+    template <typename OnMove>
+    static CompactResult step( std::chrono::nanoseconds budget, OnMove& on_move ) noexcept
+    {
+        if constexpr ( ManagerT::kThreadCacheEnabled )
+            ManagerT::thread_cache_ops::flush_unlocked();
+        const auto    start     = clock::now();
+        CompactResult result{ 0, 0, false };
+        DataRefs      data;
+        auto          may_yield = [&]() noexcept { return result.moved_blocks > 0 && clock::now() - start >= budget; };
+        uint8_t*      base      = ManagerT::_backend.base_ptr();
+        index_type    idx       = ManagerT::get_header( base )->first_block_offset;
+        while ( idx != address_traits::no_block )
+        {
+            void*      blk  = block_at<address_traits>( base, idx );
+            index_type next = BlockState::get_next_offset( blk );
+            if ( idx < _cursor || next == address_traits::no_block ||
+                 !pmm::is_free( BlockState::get_node_type( blk ) ) )
+            {
+                idx = next;
+                continue;
+            }
+            size_t moved = 0;
+            if ( !relocate_next_unlocked( base, idx, data, may_yield, on_move, moved ) )
+            {
+                _cursor = idx;
+                return result;
+            }
+            if ( moved == 0 )
+            {
+                idx = next;
+            }
+            else
+            {
+                result.moved_blocks++;
+                result.moved_bytes += moved;
+            }
+            if ( clock::now() - start >= budget )
+            {
+                _cursor = idx;
+                return result;
+            }
+        }
+        _cursor         = 0;
+        result.complete = true;
+        return result;
+    }
+
+  private:
+    template <typename YieldFn, typename OnMove>
+    static bool relocate_next_unlocked( uint8_t* base, index_type hole_idx, DataRefs& data, YieldFn& may_yield,
+                                        OnMove& on_move, size_t& moved_bytes ) noexcept
+    {
+        index_type          blk_idx = BlockState::get_next_offset( block_at<address_traits>( base, hole_idx ) );
+        void*               blk     = block_at<address_traits>( base, blk_idx );
+        const pmm::NodeType nt      = BlockState::get_node_type( blk );
+        if ( nt != pmm::NodeType::Generic && nt != pmm::NodeType::PPtr )
+            return true;
+        index_type     old_idx  = static_cast<index_type>( blk_idx + ManagerT::kBlockHdrGranules );
+        index_type     new_idx  = static_cast<index_type>( hole_idx + ManagerT::kBlockHdrGranules );
+        forest_domain* domain   = ManagerT::pmap_domain_of_unlocked( base, old_idx );
+        index_type*    data_ref = nullptr;
+        if ( domain == nullptr )
+        {
+            if ( !data.built && !build_data_refs( base, data, may_yield ) )
+                return false;
+            data_ref = find_data_ref( data, old_idx );
+            if ( data_ref == nullptr )
+                return true;
+        }
+        auto&&     node   = BlockState::tree_node_of( blk );
+        index_type parent = node.parent_offset;
+        index_type left   = node.left_offset;
+        index_type right  = node.right_offset;
+        index_type moved  = ManagerT::allocator::relocate_into_hole(
+            ArenaView<address_traits>{ base, ManagerT::arena_ops::owning_header( base, hole_idx ) }, hole_idx );
+        if ( data_ref != nullptr )
+        {
+            *data_ref = new_idx;
+            note_dirty( data_ref, sizeof( index_type ) );
+        }
+        else
+        {
+            if ( parent == address_traits::no_block )
+            {
+                std::atomic_ref<index_type>( domain->root_offset ).store( new_idx, std::memory_order_relaxed );
+                note_dirty( &domain->root_offset, sizeof( index_type ) );
+            }
+            else
+                relink_child( base, parent, old_idx, new_idx );
+            if ( left != address_traits::no_block )
+                avl_store( BlockState::tree_node_of( ManagerT::tree_block_at( base, left ) ).parent_offset, new_idx );
+            if ( right != address_traits::no_block )
+                avl_store( BlockState::tree_node_of( ManagerT::tree_block_at( base, right ) ).parent_offset, new_idx );
+        }
+        on_move( old_idx, new_idx );
+        moved_bytes = static_cast<size_t>( moved ) * address_traits::granule_size;
+        return true;
+    }
+    static void relink_child( uint8_t* base, index_type parent, index_type old_idx, index_type new_idx ) noexcept
+    {
+        auto&& node = BlockState::tree_node_of( ManagerT::tree_block_at( base, parent ) );
+        if ( node.left_offset == old_idx )
+            avl_store( node.left_offset, new_idx );
+        else
+            avl_store( node.right_offset, new_idx );
+    }
+    template <typename YieldFn>
+    static bool build_data_refs( uint8_t* base, DataRefs& data, YieldFn& may_yield ) noexcept
+    {
+        static constexpr size_t kDataIdxOffset =
+            sizeof( Block<address_traits> ) + offsetof( typename ManagerT::template parray<char>, _data_idx );
+        static_assert( offsetof( typename ManagerT::pstring, _data_idx ) ==
+                           offsetof( typename ManagerT::template parray<char>, _data_idx ),
+                       "" );
+        static constexpr size_t kMinWeightBytes =
+            kDataIdxOffset + sizeof( index_type ) - sizeof( Block<address_traits> );
+        static constexpr size_t kBudgetStride   = 256;
+        size_t                  visited         = 0;
+        bool                    in_time         = true;
+        data.built                              = true;
+        auto step = [&]( index_type, void* blk ) noexcept
+        {
+            if ( ++visited % kBudgetStride == 0 && may_yield() )
+            {
+                in_time = false;
+                return WalkControl::StopOk;
+            }
+            const pmm::NodeType nt = BlockState::get_node_type( blk );
+            if ( ( nt != pmm::NodeType::PArray && nt != pmm::NodeType::PString ) ||
+                 static_cast<size_t>( BlockState::get_weight( blk ) ) * address_traits::granule_size < kMinWeightBytes )
+                return WalkControl::Continue;
+            try
+            {
+                data.refs.push_back( reinterpret_cast<index_type*>( static_cast<uint8_t*>( blk ) + kDataIdxOffset ) );
+            }
+            catch ( ... )
+            {
+                return WalkControl::Fail;
+            }
+            return WalkControl::Continue;
+        };
+        ArenaView<address_traits> arena{ base, ManagerT::get_header( base ) };
+        if ( !for_each_physical_block_mut<address_traits>( arena, step ) )
+            data.refs.clear();
+        if ( !in_time )
+        {
+            data.refs.clear();
+            data.built = false;
+            return false;
+        }
+        std::sort( data.refs.begin(), data.refs.end(), []( index_type* a, index_type* b ) { return *a < *b; } );
+        return true;
+    }
+    static index_type* find_data_ref( const DataRefs& data, index_type user_idx ) noexcept
+    {
+        auto range = std::equal_range( data.refs.begin(), data.refs.end(), user_idx, RefLess{} );
+        return ( range.second - range.first == 1 ) ? *range.first : nullptr;
+    }
+    struct RefLess
+    {
+        bool operator()( const index_type* a, index_type b ) const noexcept { return *a < b; }
+        bool operator()( index_type a, const index_type* b ) const noexcept { return a < *b; }
+    };
+};
+}
@@ -1,8 +1,33 @@
 #pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
 #include <shared_mutex>
+#include <thread>
+#if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 ) )
+#include <intrin.h>
+#endif
 namespace pmm
 {
+namespace detail
+{
+inline void spin_pause( unsigned iteration ) noexcept
+{
+    if ( iteration >= 64 )
+    {
+        std::this_thread::yield();
+        return;
+    }
+#if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 ) )
+    _mm_pause();
+#elif defined( __x86_64__ ) || defined( __i386__ )
+    __builtin_ia32_pause();
+#elif defined( __aarch64__ ) || defined( __arm__ )
+    asm volatile( "yield" );
+#endif
+}
+}
 namespace config
 {
 /*
@@ -38,6 +63,174 @@ struct NoLock
         explicit unique_lock_type( mutex_type& ) {}
     };
 };
+/*
+### pmm-config-spinlock
+req: qa-thread-001, qa-perf-001
+*/
+struct SpinLock
+{
+    struct mutex_type
+    {
+        static constexpr uint32_t kWriter  = 1u << 31;
+        static constexpr uint32_t kWaiting = 1u << 30;
+        std::atomic<uint32_t>     state{ 0 };
+        void                      lock() noexcept
+        {
+            for ( unsigned i = 0;; ++i )
+            {
+                uint32_t s = state.load( std::memory_order_relaxed );
+                if ( ( s & ~kWaiting ) == 0 )
+                {
+                    if ( state.compare_exchange_weak( s, kWriter, std::memory_order_acquire ) )
+                        return;
+                }
+                else if ( ( s & kWaiting ) == 0 )
+                {
+                    state.fetch_or( kWaiting, std::memory_order_relaxed );
+                }
+                detail::spin_pause( i );
+            }
+        }
+        bool try_lock() noexcept
+        {
+            uint32_t s = state.load( std::memory_order_relaxed );
+            return ( s & ~kWaiting ) == 0 && state.compare_exchange_strong( s, kWriter, std::memory_order_acquire );
+        }
+        void unlock() noexcept { state.fetch_and( ~kWriter, std::memory_order_release ); }
+        void lock_shared() noexcept
+        {
+            for ( unsigned i = 0; !try_lock_shared(); ++i )
+                detail::spin_pause( i );
+        }
+        bool try_lock_shared() noexcept
+        {
+            uint32_t s = state.load( std::memory_order_relaxed );
+            return ( s & ( kWriter | kWaiting ) ) == 0 &&
+                   state.compare_exchange_weak( s, s + 1, std::memory_order_acquire );
+        }
+        void unlock_shared() noexcept { state.fetch_sub( 1, std::memory_order_release ); }
+    };
+    using shared_lock_type = std::shared_lock<mutex_type>;
+    using unique_lock_type = std::unique_lock<mutex_type>;
+};
+/*
+### pmm-config-ticketlock
+req: qa-thread-001, qa-perf-001
+*/
+struct TicketLock
+{
+    struct mutex_type
+    {
+        std::atomic<uint32_t> next{ 0 };
+        std::atomic<uint32_t> serving{ 0 };
+        void                  lock() noexcept
+        {
+            uint32_t ticket = next.fetch_add( 1, std::memory_order_relaxed );
+            for ( unsigned i = 0; serving.load( std::memory_order_acquire ) != ticket; ++i )
+                detail::spin_pause( i );
+        }
+        bool try_lock() noexcept
+        {
+            uint32_t ticket = serving.load( std::memory_order_relaxed );
+            uint32_t expect = ticket;
+            return next.compare_exchange_strong( expect, ticket + 1, std::memory_order_acquire );
+        }
+        void unlock() noexcept
+        {
+            serving.store( serving.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+        }
+        void lock_shared() noexcept { lock(); }
+        bool try_lock_shared() noexcept { return try_lock(); }
+        void unlock_shared() noexcept { unlock(); }
+    };
+    using shared_lock_type = std::shared_lock<mutex_type>;
+    using unique_lock_type = std::unique_lock<mutex_type>;
+};
+/*
+### pmm-config-basicadaptivelock
+req: qa-thread-001, qa-perf-001
+*/
+template <unsigned SpinCount = 128> struct BasicAdaptiveLock
+{
+    struct mutex_type
+    {
+        std::shared_mutex m;
+        void              lock()
+        {
+            for ( unsigned i = 0; i < SpinCount; ++i )
+            {
+                if ( m.try_lock() )
+                    return;
+                detail::spin_pause( 0 );
+            }
+            m.lock();
+        }
+        bool try_lock() { return m.try_lock(); }
+        void unlock() { m.unlock(); }
+        void lock_shared()
+        {
+            for ( unsigned i = 0; i < SpinCount; ++i )
+            {
+                if ( m.try_lock_shared() )
+                    return;
+                detail::spin_pause( 0 );
+            }
+            m.lock_shared();
+        }
+        bool try_lock_shared() { return m.try_lock_shared(); }
+        void unlock_shared() { m.unlock_shared(); }
+    };
+    using shared_lock_type = std::shared_lock<mutex_type>;
+    using unique_lock_type = std::unique_lock<mutex_type>;
+};
+using AdaptiveLock = BasicAdaptiveLock<>;
+/*
+### pmm-config-nothreadcache
+*/
+struct NoThreadCache
+{
+    static constexpr size_t max_class_bytes = 0;
+    static constexpr size_t capacity        = 0;
+    static constexpr size_t batch           = 0;
+};
+template <size_t MaxClassBytes = 256, size_t Capacity = 32, size_t Batch = 16>
+/*
+### pmm-config-threadcache
+req: qa-thread-001, qa-perf-001
+*/
+struct ThreadCache
+{
+    static_assert( MaxClassBytes > 0, "" );
+    static_assert( Batch >= 1 && Batch <= Capacity, "" );
+    static constexpr size_t max_class_bytes = MaxClassBytes;
+    static constexpr size_t capacity        = Capacity;
+    static constexpr size_t batch           = Batch;
+};
+/*
+### pmm-config-fullvalidation
+req: fr-035, qa-perf-002
+*/
+struct FullValidation
+{
+    static constexpr bool check_on_resolve  = true;
+    static constexpr bool assert_on_resolve = false;
+};
+/*
+### pmm-config-debugvalidation
+*/
+struct DebugValidation
+{
+    static constexpr bool check_on_resolve  = false;
+    static constexpr bool assert_on_resolve = true;
+};
+/*
+### pmm-config-novalidation
+*/
+struct NoValidation
+{
+    static constexpr bool check_on_resolve  = false;
+    static constexpr bool assert_on_resolve = false;
+};
 inline constexpr size_t kDefaultGrowNumerator   = 5;
 inline constexpr size_t kDefaultGrowDenominator = 4;
 }
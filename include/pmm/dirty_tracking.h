@@ -0,0 +1,229 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+namespace pmm
+{
+using std::size_t;
+/*
+## pmm-flushmode
+req: fr-014, qa-rec-001
+*/
+enum class FlushMode : std::uint8_t
+{
+    Async,
+    Sync
+};
+namespace detail
+{
+/*
+### pmm-detail-dirtybitmap
+req: fr-014, qa-rec-001, qa-perf-001
+*/
+class DirtyBitmap
+{
+  public:
+    static constexpr size_t kMaxChunks = size_t( 1 ) << 22;
+    bool                    init( const void* base, size_t bytes, size_t page ) noexcept
+    {
+        unsigned shift = 0;
+        while ( ( size_t( 1 ) << shift ) < page )
+            ++shift;
+        while ( ( bytes >> shift ) > kMaxChunks )
+            ++shift;
+        size_t words = ( ( ( bytes + ( size_t( 1 ) << shift ) - 1 ) >> shift ) + 63 ) / 64;
+        _bits.reset( new ( std::nothrow ) std::atomic<std::uint64_t>[words]() );
+        if ( _bits == nullptr )
+            return false;
+        _shift = shift;
+        _words = words;
+        _bytes = bytes;
+        _lo.store( reinterpret_cast<std::uintptr_t>( base ), std::memory_order_release );
+        return true;
+    }
+    void rebase( const void* base ) noexcept
+    {
+        _lo.store( reinterpret_cast<std::uintptr_t>( base ), std::memory_order_release );
+    }
+    void reset() noexcept
+    {
+        _lo.store( 0, std::memory_order_release );
+        _bits.reset();
+        _words = 0;
+    }
+    size_t chunk_size() const noexcept { return size_t( 1 ) << _shift; }
+    bool   mark_if_contains( const void* p, size_t bytes ) noexcept
+    {
+        std::uintptr_t lo = _lo.load( std::memory_order_acquire );
+        std::uintptr_t a  = reinterpret_cast<std::uintptr_t>( p );
+        if ( lo == 0 || a < lo || a - lo >= _bytes )
+            return false;
+        mark( static_cast<size_t>( a - lo ), bytes );
+        return true;
+    }
+    void mark( size_t offset, size_t bytes ) noexcept
+    {
+        if ( bytes == 0 || offset >= _bytes || _words == 0 )
+            return;
+        size_t last = ( bytes > _bytes - offset ) ? _bytes - 1 : offset + bytes - 1;
+        for ( size_t c = offset >> _shift, end = last >> _shift; c <= end; )
+        {
+            size_t        bit  = c % 64;
+            size_t        n    = ( end - c + 1 < 64 - bit ) ? end - c + 1 : 64 - bit;
+            std::uint64_t mask = ( n == 64 ) ? ~std::uint64_t( 0 ) : ( ( std::uint64_t( 1 ) << n ) - 1 ) << bit;
+            auto&         w    = _bits[c / 64];
+            if ( ( w.load( std::memory_order_relaxed ) & mask ) != mask )
+                w.fetch_or( mask, std::memory_order_relaxed );
+            c += n;
+        }
+    }
+    size_t dirty_bytes() const noexcept
+    {
+        size_t chunks = 0;
+        for ( size_t i = 0; i < _words; ++i )
+            chunks += static_cast<size_t>( std::popcount( _bits[i].load( std::memory_order_relaxed ) ) );
+        return chunks << _shift;
+    }
+/*
+#### pmm-detail-dirtybitmap-drain
+*/
+    template <typename SyncFn> bool drain( size_t limit, SyncFn&& sync ) noexcept
+    {
+        bool   ok    = true;
+        size_t start = 0, run = 0;
+        auto   emit  = [&]() noexcept
+        {
+            size_t from = start << _shift;
+            size_t to   = ( start + run ) << _shift;
+            to          = ( to > limit ) ? limit : to;
+            if ( from < to && !sync( from, to - from ) )
+            {
+                mark( from, to - from );
+                ok = false;
+            }
+            run = 0;
+        };
+        for ( size_t i = 0; i < _words; ++i )
+        {
+            std::uint64_t w = _bits[i].load( std::memory_order_relaxed ) != 0
+                                  ? _bits[i].exchange( 0, std::memory_order_acquire )
+                                  : 0;
+            for ( size_t b = 0; b < 64; ++b )
+            {
+                if ( ( w >> b ) & 1 )
+                {
+                    if ( run == 0 )
+                        start = i * 64 + b;
+                    ++run;
+                }
+                else if ( run != 0 )
+                    emit();
+            }
+        }
+        if ( run != 0 )
+            emit();
+        return ok;
+    }
+
+  private:
+    std::atomic<std::uintptr_t>                    _lo{ 0 };
+    size_t                                         _bytes = 0;
+    size_t                                         _words = 0;
+    unsigned                                       _shift = 12;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> _bits;
+};
+/*
+### pmm-detail-dirtyrangeentry
+req: fr-014, qa-rec-001
+*/
+struct DirtyRangeEntry
+{
+    std::atomic<DirtyBitmap*> bitmap{ nullptr };
+    DirtyRangeEntry*          next = nullptr;
+};
+/*
+### pmm-detail-dirtyrangereader
+req: fr-014, qa-thread-001
+*/
+struct alignas( 64 ) DirtyRangeReader
+{
+    std::atomic<size_t> busy{ 0 };
+};
+/*
+### pmm-detail-dirtyrangetable
+req: fr-014, qa-rec-001, qa-perf-001
+*/
+struct DirtyRangeTable
+{
+    using Entry  = DirtyRangeEntry;
+    using Reader = DirtyRangeReader;
+    static constexpr size_t           kReaders = 64;
+    static inline std::atomic<size_t> active{ 0 };
+    static inline std::atomic<Entry*> head{ nullptr };
+    static inline std::atomic<size_t> next_reader{ 0 };
+    static inline Reader              readers[kReaders]{};
+    static bool                       add( DirtyBitmap* bitmap ) noexcept
+    {
+        for ( Entry* e = head.load( std::memory_order_acquire ); e != nullptr; e = e->next )
+        {
+            DirtyBitmap* expected = nullptr;
+            if ( e->bitmap.compare_exchange_strong( expected, bitmap, std::memory_order_acq_rel ) )
+            {
+                active.fetch_add( 1, std::memory_order_release );
+                return true;
+            }
+        }
+        Entry* e = new ( std::nothrow ) Entry;
+        if ( e == nullptr )
+            return false;
+        e->bitmap.store( bitmap, std::memory_order_relaxed );
+        e->next = head.load( std::memory_order_relaxed );
+        while ( !head.compare_exchange_weak( e->next, e, std::memory_order_release, std::memory_order_relaxed ) )
+        {
+        }
+        active.fetch_add( 1, std::memory_order_release );
+        return true;
+    }
+    static void remove( DirtyBitmap* bitmap ) noexcept
+    {
+        for ( Entry* e = head.load( std::memory_order_acquire ); e != nullptr; e = e->next )
+        {
+            DirtyBitmap* expected = bitmap;
+            if ( e->bitmap.compare_exchange_strong( expected, nullptr, std::memory_order_seq_cst ) )
+            {
+                active.fetch_sub( 1, std::memory_order_release );
+                break;
+            }
+        }
+        for ( Reader& r : readers )
+        {
+            while ( r.busy.load( std::memory_order_seq_cst ) != 0 )
+                std::this_thread::yield();
+        }
+    }
+    static Reader& reader() noexcept
+    {
+        static thread_local Reader& r = readers[next_reader.fetch_add( 1, std::memory_order_relaxed ) % kReaders];
+        return r;
+    }
+};
+inline void note_dirty( const void* p, size_t bytes ) noexcept
+{
+    if ( DirtyRangeTable::active.load( std::memory_order_relaxed ) == 0 || p == nullptr )
+        return;
+    DirtyRangeTable::Reader& r = DirtyRangeTable::reader();
+    r.busy.fetch_add( 1, std::memory_order_seq_cst );
+    for ( auto* e = DirtyRangeTable::head.load( std::memory_order_acquire ); e != nullptr; e = e->next )
+    {
+        DirtyBitmap* bitmap = e->bitmap.load( std::memory_order_seq_cst );
+        if ( bitmap != nullptr && bitmap->mark_if_contains( p, bytes ) )
+            break;
+    }
+    r.busy.fetch_sub( 1, std::memory_order_release );
+}
+}
+}
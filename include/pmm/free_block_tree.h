@@ -3,7 +3,10 @@
 #include "pmm/block.h"
 #include "pmm/block_state.h"
 #include "pmm/types.h"
+#include <atomic>
+#include <bit>
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <type_traits>
 namespace pmm
@@ -15,6 +18,19 @@ concept FreeBlockTreePolicyForTraitsConcept =
         { Policy::remove( base, hdr, idx ) };
         { Policy::find_best_fit( base, hdr, idx ) } -> std::convertible_to<typename AT::index_type>;
     };
+namespace detail
+{
+template <typename FT> inline constexpr size_t free_block_tree_reserve_bytes_v = 0;
+template <typename FT>
+    requires requires { FT::kImageReserveBytes; }
+inline constexpr size_t free_block_tree_reserve_bytes_v<FT> = FT::kImageReserveBytes;
+template <typename FT, typename AT> inline void free_block_tree_reset( uint8_t* base, ManagerHeader<AT>* hdr ) noexcept
+{
+    hdr->free_tree_root = AT::no_block;
+    if constexpr ( requires { FT::reset( base, hdr ); } )
+        FT::reset( base, hdr );
+}
+}
 /*
 ## pmm-avlfreetree
 req: feat-002, fr-004, fr-013, dr-005, dr-013, qa-perf-001, dr-009, dr-017, qa-maint-002
@@ -135,6 +151,17 @@ template <typename AT = DefaultAddressTraits> struct AvlFreeTree
         }
         return result;
     }
+    static index_type largest_free( const uint8_t* base, const detail::ManagerHeader<AT>* hdr ) noexcept
+    {
+        index_type cur = hdr->free_tree_root, result = 0;
+        while ( cur != AT::no_block )
+        {
+            const void* node = detail::block_at<AT>( base, cur );
+            result           = BlockState::get_weight( node );
+            cur              = BlockState::get_right_offset( node );
+        }
+        return result;
+    }
 
   private:
     static void set_child( uint8_t* base, detail::ManagerHeader<AT>* hdr, index_type parent, index_type old_child,
@@ -153,4 +180,70 @@ template <typename AT = DefaultAddressTraits> struct AvlFreeTree
     }
 };
 static_assert( FreeBlockTreePolicyForTraitsConcept<AvlFreeTree<DefaultAddressTraits>, DefaultAddressTraits>, "" );
+namespace detail
+{
+inline size_t size_histogram_bucket( uint64_t granules ) noexcept
+{
+    size_t bucket = ( granules > 1 ) ? static_cast<size_t>( std::bit_width( granules ) ) - 1 : 0;
+    return ( bucket < kSizeHistogramBuckets ) ? bucket : kSizeHistogramBuckets - 1;
+}
+/*
+### pmm-detail-heapstatsfreetree
+req: feat-005, fr-019, qa-perf-001
+*/
+template <typename FT, typename AT, typename ManagerTag, bool Concurrent> struct HeapStatsFreeTree : FT
+{
+    using index_type   = typename AT::index_type;
+    using counter_type = std::conditional_t<Concurrent, std::atomic<size_t>, size_t>;
+    struct Histogram
+    {
+        counter_type blocks[kSizeHistogramBuckets];
+        counter_type granules;
+    };
+    static inline Histogram         free_hist{};
+    static inline Histogram         alloc_hist{};
+    static inline std::atomic<bool> stale{ true };
+    static void                     insert( uint8_t* base, ManagerHeader<AT>* hdr, index_type blk_idx )
+    {
+        FT::insert( base, hdr, blk_idx );
+        note( free_hist, BlockStateBase<AT>::get_weight( block_at<AT>( base, blk_idx ) ), true );
+    }
+    static void remove( uint8_t* base, ManagerHeader<AT>* hdr, index_type blk_idx )
+    {
+        note( free_hist, BlockStateBase<AT>::get_weight( block_at<AT>( base, blk_idx ) ), false );
+        FT::remove( base, hdr, blk_idx );
+    }
+    static void reset( uint8_t* base, ManagerHeader<AT>* hdr ) noexcept
+    {
+        if constexpr ( requires { FT::reset( base, hdr ); } )
+            FT::reset( base, hdr );
+        stale.store( true, std::memory_order_relaxed );
+    }
+    static void note_allocated( index_type data_gran, bool added ) noexcept { note( alloc_hist, data_gran, added ); }
+    static void note( Histogram& h, uint64_t granules, bool added ) noexcept
+    {
+        size_t bucket = size_histogram_bucket( granules );
+        if ( added )
+        {
+            h.blocks[bucket] += 1;
+            h.granules += static_cast<size_t>( granules );
+        }
+        else
+        {
+            h.blocks[bucket] -= 1;
+            h.granules -= static_cast<size_t>( granules );
+        }
+    }
+    static void clear() noexcept
+    {
+        for ( size_t b = 0; b < kSizeHistogramBuckets; ++b )
+        {
+            free_hist.blocks[b]  = 0;
+            alloc_hist.blocks[b] = 0;
+        }
+        free_hist.granules  = 0;
+        alloc_hist.granules = 0;
+    }
+};
+}
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "pmm/address_traits.h"
 #include "pmm/arena_internals.h"
+#include "pmm/reserved_heap_storage.h"
 #include "pmm/storage_backend.h"
 #include <cassert>
 #include <cstddef>
@@ -16,6 +17,7 @@ namespace pmm
 {
 namespace detail
 {
+inline constexpr size_t kHeapBaseAlignment = 4096;
 /*
 ### pmm-detail-alignedalloc
 */
@@ -50,11 +52,12 @@ inline void aligned_free_for_arena( void* p ) noexcept
 ## pmm-heapstorage
 req: feat-001, fr-001, fr-026, ur-001, if-008, qa-mem-001, feat-006, fr-013, fr-028, if-005, sys-003
 */
-template <typename AT = DefaultAddressTraits> class HeapStorage
+template <typename AT = DefaultAddressTraits, bool HugePages = false> class HeapStorage
 {
   public:
-    using address_traits   = AT;
-    HeapStorage() noexcept = default;
+    using address_traits             = AT;
+    static constexpr bool kHugePages = HugePages;
+    HeapStorage() noexcept           = default;
     explicit HeapStorage( size_t initial_size ) noexcept
     {
         if ( initial_size == 0 )
@@ -62,11 +65,12 @@ template <typename AT = DefaultAddressTraits> class HeapStorage
         auto rounded = pmm::detail::round_up_checked( initial_size, AT::granule_size );
         if ( !rounded.has_value() )
             return;
-        _buffer = static_cast<uint8_t*>( detail::aligned_alloc_for_arena( AT::granule_size, *rounded ) );
+        _buffer = static_cast<uint8_t*>( detail::aligned_alloc_for_arena( kBaseAlign, *rounded ) );
         if ( _buffer != nullptr )
         {
             _size        = *rounded;
             _owns_memory = true;
+            advise( _buffer, _size );
         }
         assert( reinterpret_cast<std::uintptr_t>( _buffer ) % AT::granule_size == 0 );
     }
@@ -110,6 +114,7 @@ template <typename AT = DefaultAddressTraits> class HeapStorage
     uint8_t*       base_ptr() noexcept { return _buffer; }
     const uint8_t* base_ptr() const noexcept { return _buffer; }
     size_t         total_size() const noexcept { return _size; }
+    size_t         huge_page_bytes() const noexcept { return detail::huge_page_resident_bytes( _buffer, _size ); }
     bool           resize_to( size_t new_total_size ) noexcept
     {
         if ( new_total_size == 0 )
@@ -118,10 +123,11 @@ template <typename AT = DefaultAddressTraits> class HeapStorage
             return false;
         if ( new_total_size <= _size )
             return false;
-        void* new_buf = detail::aligned_alloc_for_arena( AT::granule_size, new_total_size );
+        void* new_buf = detail::aligned_alloc_for_arena( kBaseAlign, new_total_size );
         if ( new_buf == nullptr )
             return false;
         assert( reinterpret_cast<std::uintptr_t>( new_buf ) % AT::granule_size == 0 );
+        advise( new_buf, new_total_size );
         if ( _buffer != nullptr )
             std::memcpy( new_buf, _buffer, _size );
         if ( _owns_memory && _buffer != nullptr )
@@ -131,12 +137,50 @@ template <typename AT = DefaultAddressTraits> class HeapStorage
         _owns_memory = true;
         return true;
     }
+/*
+### pmm-heapstorage-shrink_to
+*/
+    bool shrink_to( size_t new_total_size ) noexcept
+    {
+        if ( new_total_size == 0 )
+            return false;
+        if ( new_total_size % AT::granule_size != 0 )
+            return false;
+        if ( new_total_size >= _size )
+            return false;
+        if ( !_owns_memory )
+        {
+            _size = new_total_size;
+            return true;
+        }
+        void* new_buf = detail::aligned_alloc_for_arena( kBaseAlign, new_total_size );
+        if ( new_buf == nullptr )
+            return false;
+        advise( new_buf, new_total_size );
+        std::memcpy( new_buf, _buffer, new_total_size );
+        detail::aligned_free_for_arena( _buffer );
+        _buffer = static_cast<uint8_t*>( new_buf );
+        _size   = new_total_size;
+        return true;
+    }
     bool owns_memory() const noexcept { return _owns_memory; }
 
   private:
+    static constexpr size_t kBaseAlign = HugePages ? detail::kHugePageSize
+                                         : AT::granule_size > detail::kHeapBaseAlignment ? AT::granule_size
+                                                                                          : detail::kHeapBaseAlignment;
+    static void             advise( void* p, size_t bytes ) noexcept
+    {
+        if constexpr ( HugePages )
+            detail::advise_huge_pages( p, ( bytes + kBaseAlign - 1 ) / kBaseAlign * kBaseAlign );
+    }
     uint8_t* _buffer      = nullptr;
     size_t   _size        = 0;
     bool     _owns_memory = false;
 };
 static_assert( is_storage_backend_v<HeapStorage<>>, "" );
+template <typename AT, bool H> struct detail::with_huge_pages<HeapStorage<AT, H>>
+{
+    using type = HeapStorage<AT, true>;
+};
 }
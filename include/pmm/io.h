@@ -85,8 +85,8 @@ template <typename MgrT> inline bool save_manager( const char* filename )
     if ( filename == nullptr )
         return false;
     std::vector<uint8_t> snapshot;
+    auto                 take_snapshot = [&]()
     {
-        typename MgrT::thread_policy::shared_lock_type lock( MgrT::_mutex );
         if ( !MgrT::is_initialized() )
             return false;
         const uint8_t* data  = MgrT::backend().base_ptr();
@@ -95,6 +95,20 @@ template <typename MgrT> inline bool save_manager( const char* filename )
             return false;
         snapshot.resize( total );
         std::memcpy( snapshot.data(), data, total );
+        return true;
+    };
+    if constexpr ( MgrT::kThreadCacheEnabled || MgrT::kArenaMode )
+    {
+        typename MgrT::write_lock_type lock( MgrT::_mutex );
+        MgrT::prepare_snapshot_unlocked();
+        if ( !take_snapshot() )
+            return false;
+    }
+    else
+    {
+        typename MgrT::thread_policy::shared_lock_type lock( MgrT::_mutex );
+        if ( !take_snapshot() )
+            return false;
     }
     auto* hdr            = detail::manager_header_at<address_traits>( snapshot.data() );
     hdr->crc32           = detail::compute_image_crc32<address_traits>( snapshot.data(), snapshot.size() );
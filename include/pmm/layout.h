@@ -2,9 +2,11 @@
 #include "pmm/arena_internals.h"
 #include "pmm/block.h"
 #include "pmm/block_state.h"
+#include "pmm/free_block_tree.h"
 #include "pmm/types.h"
 #include <cstddef>
 #include <cstdint>
+#include <algorithm>
 #include <cstring>
 #include <optional>
 namespace pmm::detail
@@ -35,21 +37,21 @@ template <typename ManagerAccess> struct ManagerLayoutOps
         hdr->total_size         = size;
         hdr->first_block_offset = kHdrBlkIdx;
         hdr->last_block_offset  = address_traits::no_block;
-        hdr->free_tree_root     = address_traits::no_block;
         hdr->image_version      = kCurrentImageVersion;
         hdr->granule_size       = static_cast<uint16_t>( kGranSz );
         hdr->root_offset        = address_traits::no_block;
-        void*      blk          = base + static_cast<size_t>( kFreeBlkIdx ) * kGranSz;
-        index_type total_gran   = static_cast<index_type>( size / kGranSz );
-        index_type free_gran    = static_cast<index_type>( total_gran - kFreeBlkIdx );
+        free_block_tree_reset<free_block_tree>( base, hdr );
+        void*      blk        = base + static_cast<size_t>( kFreeBlkIdx ) * kGranSz;
+        index_type total_gran = static_cast<index_type>( size / kGranSz );
+        index_type free_gran  = static_cast<index_type>( total_gran - kFreeBlkIdx );
         std::memset( blk, 0, sizeof( Block<address_traits> ) );
         BlockState::init_fields( blk, kHdrBlkIdx, address_traits::no_block, 1, free_gran, 0, NodeType::Free );
         hdr->last_block_offset = kFreeBlkIdx;
-        hdr->free_tree_root    = kFreeBlkIdx;
         hdr->block_count       = 2;
         hdr->free_count        = 1;
         hdr->alloc_count       = 1;
         hdr->used_size         = kFreeBlkIdx + ManagerAccess::kBlockHdrGranules;
+        free_block_tree::insert( base, hdr, kFreeBlkIdx );
         (void)backend;
         ManagerAccess::set_initialized();
         return true;
@@ -130,10 +132,76 @@ template <typename ManagerAccess> struct ManagerLayoutOps
             hdr->last_block_offset = extra_idx;
             hdr->block_count++;
             hdr->free_count++;
+            hdr->used_size += ManagerAccess::kBlockHdrGranules;
             hdr->total_size = new_size;
             free_block_tree::insert( new_base, hdr, extra_idx );
         }
         return true;
     }
+    static size_t tail_free_bytes( const uint8_t* base ) noexcept
+    {
+        const ManagerHeader<address_traits>* hdr  = manager_header_at<address_traits>( base );
+        index_type                           tail = hdr->last_block_offset;
+        if ( tail == address_traits::no_block )
+            return 0;
+        const void* blk = block_at<address_traits>( base, tail );
+        if ( !pmm::is_free( BlockState::get_node_type( blk ) ) )
+            return 0;
+        return static_cast<size_t>( hdr->total_size ) - static_cast<size_t>( tail ) * address_traits::granule_size;
+    }
+    static bool do_shrink( storage_backend& backend, bool initialized, size_t target_size ) noexcept
+    {
+        static constexpr size_t kGranSz = address_traits::granule_size;
+        if ( !initialized )
+            return false;
+        uint8_t*                       base     = backend.base_ptr();
+        ManagerHeader<address_traits>* hdr      = ManagerAccess::get_header( base );
+        size_t                         old_size = hdr->total_size;
+        index_type                     tail     = hdr->last_block_offset;
+        if ( tail == address_traits::no_block )
+            return false;
+        void* tail_raw = block_at<address_traits>( base, tail );
+        if ( !pmm::is_free( BlockState::get_node_type( tail_raw ) ) )
+            return false;
+        index_type prev = BlockState::get_prev_offset( tail_raw );
+        if ( prev == address_traits::no_block )
+            return false;
+        auto target = round_up_checked( target_size, kGranSz );
+        if ( !target.has_value() )
+            return false;
+        size_t tail_off  = static_cast<size_t>( tail ) * kGranSz;
+        size_t keep_min  = tail_off + sizeof( Block<address_traits> ) + kGranSz;
+        bool   drop_tail = *target <= tail_off;
+        size_t new_size  = drop_tail ? tail_off : std::max( *target, keep_min );
+        if ( new_size >= old_size )
+            return false;
+        free_block_tree::remove( base, hdr, tail );
+        if ( !backend.shrink_to( new_size ) )
+        {
+            free_block_tree::insert( base, hdr, tail );
+            return false;
+        }
+        base     = backend.base_ptr();
+        hdr      = ManagerAccess::get_header( base );
+        tail_raw = block_at<address_traits>( base, tail );
+        if ( drop_tail )
+        {
+            BlockState::set_next_offset_of( block_at<address_traits>( base, prev ), address_traits::no_block );
+            hdr->last_block_offset = prev;
+            hdr->block_count--;
+            hdr->free_count--;
+            hdr->used_size -= ManagerAccess::kBlockHdrGranules;
+            hdr->total_size = new_size;
+        }
+        else
+        {
+            BlockState::set_weight_of( tail_raw, static_cast<index_type>( new_size / kGranSz - tail ) );
+            hdr->total_size = new_size;
+            free_block_tree::insert( base, hdr, tail );
+        }
+        if constexpr ( requires { logging_policy::on_shrink( old_size, new_size ); } )
+            logging_policy::on_shrink( old_size, new_size );
+        return true;
+    }
 };
 }
@@ -1,7 +1,13 @@
 #pragma once
 #include "pmm/types.h"
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
+#include <type_traits>
 namespace pmm
 {
 namespace logging
@@ -13,6 +19,7 @@ struct NoLogging
 {
     static void on_allocation_failure( size_t, PmmError ) noexcept {}
     static void on_expand( size_t, size_t ) noexcept {}
+    static void on_shrink( size_t, size_t ) noexcept {}
     static void on_corruption_detected( PmmError ) noexcept {}
     static void on_create( size_t ) noexcept {}
     static void on_destroy() noexcept {}
@@ -31,6 +38,10 @@ struct StderrLogging
     {
         std::fprintf( stderr, "[pmm] expand: %zu -> %zu\n", old_size, new_size );
     }
+    static void on_shrink( size_t old_size, size_t new_size ) noexcept
+    {
+        std::fprintf( stderr, "[pmm] shrink: %zu -> %zu\n", old_size, new_size );
+    }
     static void on_corruption_detected( PmmError err ) noexcept
     {
         std::fprintf( stderr, "[pmm] corruption_detected: error=%d\n", static_cast<int>( err ) );
@@ -42,5 +53,175 @@ struct StderrLogging
     static void on_destroy() noexcept { std::fprintf( stderr, "[pmm] destroy\n" ); }
     static void on_load() noexcept { std::fprintf( stderr, "[pmm] load\n" ); }
 };
+enum class LatencyOp : uint8_t
+{
+    Allocate   = 0,
+    Deallocate = 1,
+    Realloc    = 2,
+    LockWait   = 3,
+};
+/*
+### pmm-logging-latencyhistogram
+req: qa-perf-001
+*/
+struct LatencyHistogram
+{
+    static constexpr unsigned kSubBits    = 3;
+    static constexpr size_t   kSubBuckets = size_t{ 1 } << kSubBits;
+    static constexpr size_t   kBuckets    = ( 64 - kSubBits + 1 ) * kSubBuckets;
+    uint64_t                  buckets[kBuckets];
+    uint64_t                  count;
+    uint64_t                  max_ns;
+    static constexpr size_t   bucket_of( uint64_t ns ) noexcept
+    {
+        if ( ns < kSubBuckets )
+            return static_cast<size_t>( ns );
+        unsigned e   = static_cast<unsigned>( std::bit_width( ns ) ) - 1;
+        size_t   sub = static_cast<size_t>( ( ns >> ( e - kSubBits ) ) & ( kSubBuckets - 1 ) );
+        return ( e - kSubBits + 1 ) * kSubBuckets + sub;
+    }
+    static constexpr uint64_t bucket_upper( size_t b ) noexcept
+    {
+        if ( b < kSubBuckets )
+            return b;
+        unsigned shift = static_cast<unsigned>( b / kSubBuckets ) - 1;
+        return ( ( ( kSubBuckets + b % kSubBuckets ) << shift ) - 1 ) + ( uint64_t{ 1 } << shift );
+    }
+    void add( uint64_t ns ) noexcept
+    {
+        ++buckets[bucket_of( ns )];
+        ++count;
+        max_ns = ( ns > max_ns ) ? ns : max_ns;
+    }
+    uint64_t percentile( double q ) const noexcept
+    {
+        if ( count == 0 )
+            return 0;
+        uint64_t target = static_cast<uint64_t>( std::ceil( q * static_cast<double>( count ) ) );
+        target          = ( target == 0 ) ? 1 : ( target > count ? count : target );
+        uint64_t seen   = 0;
+        for ( size_t b = 0; b < kBuckets; ++b )
+        {
+            seen += buckets[b];
+            if ( seen >= target )
+                return ( bucket_upper( b ) < max_ns ) ? bucket_upper( b ) : max_ns;
+        }
+        return max_ns;
+    }
+};
+/*
+### pmm-logging-histogramlogging
+req: qa-perf-001, qa-thread-001
+*/
+struct HistogramLogging : NoLogging
+{
+    static constexpr size_t kMaxThreads = 32;
+    static constexpr size_t kOps        = 4;
+    static void on_allocate( size_t, size_t, uint64_t ns ) noexcept { record( LatencyOp::Allocate, ns ); }
+    static void on_deallocate( size_t, uint64_t ns ) noexcept { record( LatencyOp::Deallocate, ns ); }
+    static void on_realloc( size_t, size_t, uint64_t ns ) noexcept { record( LatencyOp::Realloc, ns ); }
+    static void on_lock_wait( uint64_t ns ) noexcept { record( LatencyOp::LockWait, ns ); }
+    static void record( LatencyOp op, uint64_t ns ) noexcept
+    {
+        static thread_local size_t slot = _next_slot.fetch_add( 1, std::memory_order_relaxed );
+        Counters&                  c    = _slots[slot < kMaxThreads ? slot : kMaxThreads][static_cast<size_t>( op )];
+        std::atomic<uint64_t>&     b    = c.buckets[LatencyHistogram::bucket_of( ns )];
+        if ( slot < kMaxThreads )
+        {
+            b.store( b.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+            if ( ns > c.max_ns.load( std::memory_order_relaxed ) )
+                c.max_ns.store( ns, std::memory_order_relaxed );
+            return;
+        }
+        b.fetch_add( 1, std::memory_order_relaxed );
+        uint64_t seen = c.max_ns.load( std::memory_order_relaxed );
+        while ( ns > seen && !c.max_ns.compare_exchange_weak( seen, ns, std::memory_order_relaxed ) )
+        {
+        }
+    }
+    static LatencyHistogram snapshot( LatencyOp op ) noexcept
+    {
+        LatencyHistogram h{};
+        for ( const auto& thread : _slots )
+        {
+            const Counters& c = thread[static_cast<size_t>( op )];
+            for ( size_t b = 0; b < LatencyHistogram::kBuckets; ++b )
+            {
+                uint64_t n = c.buckets[b].load( std::memory_order_relaxed );
+                h.buckets[b] += n;
+                h.count += n;
+            }
+            uint64_t m = c.max_ns.load( std::memory_order_relaxed );
+            h.max_ns   = ( m > h.max_ns ) ? m : h.max_ns;
+        }
+        return h;
+    }
+    static void reset() noexcept
+    {
+        for ( auto& thread : _slots )
+        {
+            for ( Counters& c : thread )
+            {
+                for ( auto& b : c.buckets )
+                    b.store( 0, std::memory_order_relaxed );
+                c.max_ns.store( 0, std::memory_order_relaxed );
+            }
+        }
+    }
+
+  private:
+    struct Counters
+    {
+        std::atomic<uint64_t> buckets[LatencyHistogram::kBuckets];
+        std::atomic<uint64_t> max_ns;
+    };
+    static inline std::atomic<size_t> _next_slot{ 0 };
+    static inline Counters            _slots[kMaxThreads + 1][kOps]{};
+};
+}
+namespace detail
+{
+template <typename LoggingT>
+inline constexpr bool logs_allocate_v = requires { LoggingT::on_allocate( size_t{}, size_t{}, uint64_t{} ); };
+template <typename LoggingT>
+inline constexpr bool logs_deallocate_v = requires { LoggingT::on_deallocate( size_t{}, uint64_t{} ); };
+template <typename LoggingT>
+inline constexpr bool logs_realloc_v = requires { LoggingT::on_realloc( size_t{}, size_t{}, uint64_t{} ); };
+template <typename LoggingT>
+inline constexpr bool logs_lock_wait_v = requires { LoggingT::on_lock_wait( uint64_t{} ); };
+template <typename LoggingT>
+inline constexpr bool logs_trace_v = requires {
+    LoggingT::on_trace_allocate( uint64_t{}, size_t{} );
+    LoggingT::on_trace_deallocate( uint64_t{} );
+    LoggingT::on_trace_realloc( uint64_t{}, uint64_t{}, size_t{} );
+};
+/*
+### pmm-detail-latencytimer
+req: qa-perf-001
+*/
+template <bool Enabled> struct LatencyTimer
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint64_t                              elapsed_ns() const noexcept
+    {
+        auto d = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start );
+        return static_cast<uint64_t>( d.count() );
+    }
+};
+template <> struct LatencyTimer<false>
+{
+    constexpr uint64_t elapsed_ns() const noexcept { return 0; }
+};
+template <typename LockT, typename LoggingT> struct LockWaitTimed
+{
+    LatencyTimer<true> timer;
+    LockT              lock;
+    template <typename MutexT> explicit LockWaitTimed( MutexT& m ) : lock( m )
+    {
+        LoggingT::on_lock_wait( timer.elapsed_ns() );
+    }
+};
+template <typename LockT, typename LoggingT>
+using logged_lock_t = std::conditional_t<logs_lock_wait_v<LoggingT>, LockWaitTimed<LockT, LoggingT>, LockT>;
 }
 }
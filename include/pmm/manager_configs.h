@@ -1,11 +1,15 @@
 #pragma once
+#include "pmm/address_ordered_free_tree.h"
 #include "pmm/address_traits.h"
 #include "pmm/config.h"
 #include "pmm/free_block_tree.h"
 #include "pmm/heap_storage.h"
 #include "pmm/logging_policy.h"
+#include "pmm/reserved_heap_storage.h"
+#include "pmm/size_class_free_tree.h"
 #include "pmm/static_storage.h"
 #include "pmm/storage_backend.h"
+#include "pmm/tlsf_free_tree.h"
 #include <concepts>
 #include <cstddef>
 namespace pmm
@@ -19,7 +23,8 @@ static_assert( ValidPmmAddressTraits<SmallAddressTraits>, "" );
 static_assert( ValidPmmAddressTraits<LargeAddressTraits>, "" );
 template <typename AT = DefaultAddressTraits, typename LockPolicyT = config::NoLock,
           size_t GrowNum = config::kDefaultGrowNumerator, size_t GrowDen = config::kDefaultGrowDenominator,
-          size_t MaxMemoryGB = 64, typename LoggingPolicyT = logging::NoLogging>
+          size_t MaxMemoryGB = 64, typename LoggingPolicyT = logging::NoLogging,
+          typename FreeBlockTreeT = AvlFreeTree<AT>, typename ValidationPolicyT = config::FullValidation>
 /*
 ## pmm-basicconfig
 req: feat-001, fr-001, ur-001, ur-006, if-008, con-005, if-006
@@ -27,11 +32,13 @@ req: feat-001, fr-001, ur-001, ur-006, if-008, con-005, if-006
 struct BasicConfig
 {
     static_assert( ValidPmmAddressTraits<AT>, "" );
+    static_assert( FreeBlockTreePolicyForTraitsConcept<FreeBlockTreeT, AT>, "" );
     using address_traits                     = AT;
     using storage_backend                    = HeapStorage<AT>;
-    using free_block_tree                    = AvlFreeTree<AT>;
+    using free_block_tree                    = FreeBlockTreeT;
     using lock_policy                        = LockPolicyT;
     using logging_policy                     = LoggingPolicyT;
+    using validation_policy                  = ValidationPolicyT;
     static constexpr size_t granule_size     = AT::granule_size;
     static constexpr size_t max_memory_gb    = MaxMemoryGB;
     static constexpr size_t grow_numerator   = GrowNum;
@@ -64,4 +71,54 @@ using PersistentDataConfig  = BasicConfig<DefaultAddressTraits, config::SharedMu
 using EmbeddedManagerConfig = BasicConfig<DefaultAddressTraits, config::NoLock, 3, 2, 64>;
 using IndustrialDBConfig    = BasicConfig<DefaultAddressTraits, config::SharedMutexLock, 2, 1, 64>;
 using LargeDBConfig         = BasicConfig<LargeAddressTraits, config::SharedMutexLock, 2, 1, 0>;
+template <typename BaseConfigT, typename ThreadCacheT = config::ThreadCache<>>
+/*
+## pmm-threadcachedconfig
+req: qa-thread-001, qa-perf-001
+*/
+struct ThreadCachedConfig : BaseConfigT
+{
+    using thread_cache = ThreadCacheT;
+};
+template <typename BaseConfigT, size_t ArenaCount>
+/*
+## pmm-arenaconfig
+req: qa-thread-001, qa-perf-001, dr-013
+*/
+struct ArenaConfig : BaseConfigT
+{
+    static_assert( ArenaCount >= 1 && ArenaCount <= 64, "" );
+    static constexpr size_t arena_count = ArenaCount;
+};
+template <typename BaseConfigT, size_t ShrinkNum = 1, size_t ShrinkDen = 2>
+/*
+## pmm-autoshrinkconfig
+req: fr-004, fr-026
+*/
+struct AutoShrinkConfig : BaseConfigT
+{
+    static_assert( ShrinkNum >= 1 && ShrinkNum < ShrinkDen, "" );
+    static constexpr size_t shrink_numerator   = ShrinkNum;
+    static constexpr size_t shrink_denominator = ShrinkDen;
+};
+template <typename BaseConfigT>
+/*
+## pmm-reservedheapconfig
+req: qa-mem-001, qa-perf-001
+*/
+struct ReservedHeapConfig : BaseConfigT
+{
+    using storage_backend = ReservedHeapStorage<typename BaseConfigT::address_traits, BaseConfigT::max_memory_gb>;
+};
+template <typename BaseConfigT>
+/*
+## pmm-hugepageconfig
+req: qa-mem-001, qa-perf-001
+*/
+struct HugePageConfig : BaseConfigT
+{
+    using storage_backend = typename detail::with_huge_pages<typename BaseConfigT::storage_backend>::type;
+};
+using PersistentDataCachedConfig = ThreadCachedConfig<PersistentDataConfig>;
+using IndustrialDBCachedConfig   = ThreadCachedConfig<IndustrialDBConfig>;
 }
@@ -0,0 +1,262 @@
+#pragma once
+#include "pmm/arena_internals.h"
+#include "pmm/config.h"
+#include "pmm/dirty_tracking.h"
+#include "pmm/forest_registry.h"
+#include "pmm/free_block_tree.h"
+#include "pmm/process_shared_lock.h"
+#include "pmm/storage_backend.h"
+#include "pmm/types.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+namespace pmm::detail
+{
+template <typename LockT, typename SyncT>
+/*
+### pmm-detail-seqlockwritelock
+req: qa-thread-001
+*/
+struct SeqlockWriteLock : LockT
+{
+    template <typename MutexT> explicit SeqlockWriteLock( MutexT& m ) : LockT( m ) { SyncT::begin_write_unlocked(); }
+    ~SeqlockWriteLock() { SyncT::end_write_unlocked(); }
+};
+template <typename ManagerT>
+/*
+### pmm-detail-managersyncops
+req: qa-thread-001, qa-thread-002
+*/
+struct ManagerSyncOps
+{
+    using address_traits  = typename ManagerT::address_traits;
+    using thread_policy   = typename ManagerT::thread_policy;
+    using storage_backend = typename ManagerT::storage_backend;
+    using index_type      = typename address_traits::index_type;
+    using forest_registry = typename ManagerT::forest_registry;
+    using forest_domain   = typename ManagerT::forest_domain;
+    static constexpr bool kProcessShared = lock_is_process_shared_v<thread_policy>;
+    static constexpr bool kLockFreeStats =
+        !ManagerT::kArenaMode && !std::is_same_v<thread_policy, config::NoLock> && !kProcessShared;
+    static constexpr bool     kOptimisticReads        = kLockFreeStats && storage_has_stable_base_v<storage_backend>;
+    static constexpr unsigned kOptimisticReadAttempts = 8;
+    static constexpr bool     kDirtyTracking          = storage_tracks_dirty_v<storage_backend>;
+    static inline std::atomic<uint64_t> _version{ 0 };
+    static inline PublishedStats        _stats{};
+    static inline bool                  _lock_failed = false;
+    static void                         begin_write_unlocked() noexcept
+    {
+        if constexpr ( kOptimisticReads )
+        {
+            _version.store( _version.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_release );
+        }
+    }
+    static void end_write_unlocked() noexcept
+    {
+        if constexpr ( kOptimisticReads )
+            _version.store( _version.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+        if constexpr ( kLockFreeStats )
+            publish_stats_unlocked();
+        if constexpr ( kDirtyTracking )
+            note_dirty( ManagerT::_backend.base_ptr(),
+                        static_cast<size_t>( ManagerT::kFreeBlkIdxLayout ) * address_traits::granule_size );
+    }
+    template <typename Fn> static auto read_optimistic( Fn fn ) noexcept -> decltype( fn() )
+    {
+        if constexpr ( kOptimisticReads )
+        {
+            for ( unsigned attempt = 0; attempt < kOptimisticReadAttempts; ++attempt )
+            {
+                uint64_t before = _version.load( std::memory_order_acquire );
+                if ( ( before & 1 ) != 0 )
+                {
+                    spin_pause( attempt );
+                    continue;
+                }
+                auto result = fn();
+                std::atomic_thread_fence( std::memory_order_acquire );
+                if ( _version.load( std::memory_order_relaxed ) == before )
+                    return result;
+            }
+        }
+        typename thread_policy::shared_lock_type lock( ManagerT::_mutex );
+        return fn();
+    }
+    static index_type find_domain_optimistic( const char* name ) noexcept
+    {
+        if ( !detail::forest_domain_name_fits( name ) )
+            return 0;
+        return read_optimistic(
+            [name]() -> index_type
+            {
+                const forest_domain* rec = find_record_relaxed( [name]( const forest_domain& r )
+                                                                 { return name_equals_relaxed( r, name ); } );
+                return ( rec != nullptr ) ? relaxed_load( rec->binding_id ) : static_cast<index_type>( 0 );
+            } );
+    }
+    static index_type domain_root_optimistic( const char* name ) noexcept
+    {
+        if ( !detail::forest_domain_name_fits( name ) )
+            return 0;
+        return read_optimistic(
+            [name]() -> index_type
+            {
+                return root_index_relaxed( find_record_relaxed( [name]( const forest_domain& r )
+                                                                { return name_equals_relaxed( r, name ); } ) );
+            } );
+    }
+    static index_type domain_root_optimistic( index_type binding_id ) noexcept
+    {
+        if ( binding_id == 0 )
+            return 0;
+        return read_optimistic(
+            [binding_id]() -> index_type
+            {
+                return root_index_relaxed( find_record_relaxed(
+                    [binding_id]( const forest_domain& r ) { return relaxed_load( r.binding_id ) == binding_id; } ) );
+            } );
+    }
+    template <typename Fn> static size_t read_stat( Fn fn ) noexcept
+    {
+        if ( !ManagerT::_initialized.load( std::memory_order_acquire ) )
+            return 0;
+        if constexpr ( kLockFreeStats )
+        {
+            StatsSnapshot snap = _stats.read();
+            return fn( &snap );
+        }
+        typename ManagerT::read_lock_type lock( ManagerT::_mutex );
+        if ( !ManagerT::_initialized.load( std::memory_order_relaxed ) )
+            return 0;
+        if constexpr ( ManagerT::kArenaMode )
+            ManagerT::arena_ops::sync_header_unlocked();
+        StatsSnapshot snap = stats_snapshot_unlocked();
+        return fn( &snap );
+    }
+    static StatsSnapshot stats_snapshot_unlocked() noexcept
+    {
+        if ( !ManagerT::_initialized.load( std::memory_order_relaxed ) )
+            return StatsSnapshot{};
+        const ManagerHeader<address_traits>* hdr = ManagerT::get_header_c( ManagerT::_backend.base_ptr() );
+        return StatsSnapshot{ ManagerT::_backend.total_size(), hdr->total_size,  hdr->used_size,
+                              hdr->block_count,                hdr->free_count, hdr->alloc_count };
+    }
+    static void publish_stats_unlocked() noexcept { _stats.publish( stats_snapshot_unlocked() ); }
+    static bool bind_process_lock_unlocked( bool init ) noexcept
+    {
+        if constexpr ( kProcessShared )
+        {
+            static_assert( !ManagerT::kArenaMode && !ManagerT::kThreadCacheEnabled &&
+                               storage_has_stable_base_v<storage_backend>,
+                           "ProcessSharedLock requires one arena, no thread cache and a stable-base storage" );
+            using area_type          = typename thread_policy::area_type;
+            constexpr size_t kAlign  = alignof( area_type );
+            constexpr size_t kOffset = ( free_block_tree_reserve_bytes_v<typename ManagerT::free_block_tree> +
+                                         kAlign - 1 ) / kAlign * kAlign;
+            auto&            backend = ManagerT::_backend;
+            if ( !init && ManagerT::get_header_c( backend.base_ptr() )->magic != kMagic )
+                return true;
+            if constexpr ( RefreshableStorage<storage_backend> )
+            {
+                if ( !init && !backend.refresh() )
+                    return false;
+            }
+            uint8_t* reserve = manager_header_reserve_at<address_traits>( ManagerT::get_header( backend.base_ptr() ) );
+            if ( !ManagerT::_mutex.bind( reinterpret_cast<area_type*>( reserve + kOffset ), init,
+                                         &process_lock_acquired, &process_lock_failed ) )
+                return false;
+            _lock_failed = false;
+            return true;
+        }
+        else
+        {
+            (void)init;
+            return true;
+        }
+    }
+    static void unbind_process_lock_unlocked() noexcept
+    {
+        if constexpr ( kProcessShared )
+            ManagerT::_mutex.unbind();
+    }
+
+  private:
+    template <typename T> static T relaxed_load( const T& v ) noexcept
+    {
+        return std::atomic_ref<T>( const_cast<T&>( v ) ).load( std::memory_order_relaxed );
+    }
+    template <typename Match> static const forest_domain* find_record_relaxed( Match match ) noexcept
+    {
+        uint8_t* base = ManagerT::_backend.base_ptr();
+        if ( !ManagerT::_initialized.load( std::memory_order_relaxed ) || base == nullptr )
+            return nullptr;
+        const ManagerHeader<address_traits>* hdr  = ManagerT::get_header_c( base );
+        index_type                           off  = relaxed_load( hdr->root_offset );
+        size_t                               size = relaxed_load( hdr->total_size );
+        if ( off == address_traits::no_block || static_cast<size_t>( off ) * address_traits::granule_size +
+                                                        sizeof( forest_registry ) > size )
+            return nullptr;
+        const auto* reg = reinterpret_cast<const forest_registry*>(
+            base + static_cast<size_t>( off ) * address_traits::granule_size );
+        if ( relaxed_load( reg->magic ) != kForestRegistryMagic ||
+             relaxed_load( reg->version ) != kForestRegistryVersion )
+            return nullptr;
+        uint16_t count = std::atomic_ref<uint16_t>( const_cast<uint16_t&>( reg->domain_count ) )
+                             .load( std::memory_order_acquire );
+        if ( count > kMaxForestDomains )
+            count = static_cast<uint16_t>( kMaxForestDomains );
+        for ( uint16_t i = 0; i < count; ++i )
+        {
+            if ( match( reg->domains[i] ) )
+                return &reg->domains[i];
+        }
+        return nullptr;
+    }
+    static bool name_equals_relaxed( const forest_domain& rec, const char* name ) noexcept
+    {
+        for ( size_t i = 0; i < kForestDomainNameCapacity; ++i )
+        {
+            char c = relaxed_load( rec.name[i] );
+            if ( c != name[i] )
+                return false;
+            if ( c == '\0' )
+                return true;
+        }
+        return false;
+    }
+    static index_type root_index_relaxed( const forest_domain* rec ) noexcept
+    {
+        if ( rec == nullptr )
+            return 0;
+        if ( relaxed_load( rec->binding_kind ) != kForestBindingFreeTree )
+            return relaxed_load( rec->root_offset );
+        index_type root = relaxed_load( ManagerT::get_header_c( ManagerT::_backend.base_ptr() )->free_tree_root );
+        return ( root == address_traits::no_block ) ? static_cast<index_type>( 0 ) : root;
+    }
+    static void process_lock_acquired( bool owner_dead ) noexcept
+    {
+        using allocator = typename ManagerT::allocator;
+        uint8_t* base   = ManagerT::_backend.base_ptr();
+        if constexpr ( RefreshableStorage<storage_backend> )
+        {
+            if ( ManagerT::get_header_c( base )->total_size != ManagerT::_backend.total_size() )
+                ManagerT::_backend.refresh();
+        }
+        ManagerT::heap_stats::stale.store( true, std::memory_order_relaxed );
+        if ( owner_dead && ManagerT::_initialized.load( std::memory_order_relaxed ) )
+        {
+            ArenaView<address_traits> arena_mut{ base, ManagerT::get_header( base ) };
+            allocator::repair_linked_list( arena_mut );
+            allocator::recompute_counters( arena_mut );
+            allocator::rebuild_free_tree( arena_mut );
+        }
+    }
+    static void process_lock_failed( int ) noexcept
+    {
+        _lock_failed = true;
+        ManagerT::_initialized.store( false, std::memory_order_relaxed );
+    }
+};
+}
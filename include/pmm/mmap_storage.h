@@ -1,10 +1,13 @@
 #pragma once
 #include "pmm/address_traits.h"
 #include "pmm/arena_internals.h"
+#include "pmm/dirty_tracking.h"
+#include "pmm/reserved_heap_storage.h"
 #include "pmm/storage_backend.h"
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <optional>
 #if defined( _WIN32 ) || defined( _WIN64 )
 #ifndef WIN32_LEAN_AND_MEAN
@@ -26,21 +29,28 @@ namespace pmm
 ## pmm-mmapstorage
 req: feat-001, feat-008, fr-001, fr-014, ur-005, ur-007, qa-rec-001, qa-port-001, feat-006, if-005, sys-003, ur-011
 */
-template <typename AT = DefaultAddressTraits> class MMapStorage
+template <typename AT = DefaultAddressTraits, size_t ReserveGB = 0, bool HugePages = false> class MMapStorage
 {
   public:
-    using address_traits                         = AT;
+    using address_traits             = AT;
+    static constexpr bool kHugePages = HugePages;
+#if defined( _WIN32 ) || defined( _WIN64 )
+    static constexpr bool kStableBase = false;
+#else
+    static constexpr bool kStableBase = true;
+#endif
     MMapStorage() noexcept                       = default;
     MMapStorage( const MMapStorage& )            = delete;
     MMapStorage& operator=( const MMapStorage& ) = delete;
     MMapStorage( MMapStorage&& other ) noexcept
-        : _base( other._base ), _size( other._size ), _mapped( other._mapped )
+        : _base( other._base ), _size( other._size ), _mapped( other._mapped ), _readonly( other._readonly ),
+          _dirty( std::move( other._dirty ) )
 #if defined( _WIN32 ) || defined( _WIN64 )
           ,
           _file_handle( other._file_handle ), _map_handle( other._map_handle )
 #else
           ,
-          _fd( other._fd )
+          _fd( other._fd ), _reserved( other._reserved ), _page( other._page )
 #endif
     {
         other._base   = nullptr;
@@ -50,7 +60,8 @@ template <typename AT = DefaultAddressTraits> class MMapStorage
         other._file_handle = INVALID_HANDLE_VALUE;
         other._map_handle  = nullptr;
 #else
-        other._fd = -1;
+        other._fd       = -1;
+        other._reserved = 0;
 #endif
     }
     ~MMapStorage() { close(); }
@@ -63,27 +74,74 @@ template <typename AT = DefaultAddressTraits> class MMapStorage
         auto rounded = pmm::detail::round_up_checked( size_bytes, AT::granule_size );
         if ( !rounded.has_value() )
             return false;
-        return open_impl( path, *rounded );
+        _readonly = false;
+        if ( !open_impl( path, *rounded ) )
+            return false;
+        track_dirty();
+        return true;
+    }
+/*
+### pmm-mmapstorage-open_readonly
+*/
+    bool open_readonly( const char* path ) noexcept
+    {
+        if ( _mapped || path == nullptr )
+            return false;
+        _readonly = true;
+        return open_impl( path, 0 );
+    }
+    bool refresh() noexcept
+    {
+        if ( !_mapped )
+            return false;
+        size_t file_size = current_file_size();
+        if ( file_size == 0 )
+            return false;
+        return file_size == _size || remap_impl( file_size, false );
     }
     void close() noexcept
     {
         if ( !_mapped )
             return;
+        if ( _dirty != nullptr )
+        {
+            detail::DirtyRangeTable::remove( _dirty.get() );
+            _dirty.reset();
+        }
         close_impl();
         _base   = nullptr;
         _size   = 0;
         _mapped = false;
     }
     bool           is_open() const noexcept { return _mapped; }
+    bool           is_readonly() const noexcept { return _readonly; }
     uint8_t*       base_ptr() noexcept { return _base; }
     const uint8_t* base_ptr() const noexcept { return _base; }
     size_t         total_size() const noexcept { return _size; }
+    size_t         huge_page_bytes() const noexcept { return detail::huge_page_resident_bytes( _base, _size ); }
+    void           mark_dirty( size_t offset, size_t bytes ) noexcept
+    {
+        if ( _dirty != nullptr )
+            _dirty->mark( offset, bytes );
+    }
+    size_t dirty_bytes() const noexcept { return _dirty != nullptr ? _dirty->dirty_bytes() : 0; }
+/*
+### pmm-mmapstorage-flush
+*/
+    bool flush( FlushMode mode = FlushMode::Sync ) noexcept
+    {
+        if ( !_mapped || _dirty == nullptr )
+            return false;
+        return _dirty->drain( _size, [&]( size_t offset, size_t bytes ) noexcept
+                              { return sync_range( offset, bytes, mode ); } ) &&
+               sync_file( mode );
+    }
 /*
 ### pmm-mmapstorage-expand
 */
     bool resize_to( size_t new_total_size ) noexcept
     {
-        if ( !_mapped )
+        if ( !_mapped || _readonly )
             return false;
         if ( new_total_size == 0 )
             return false;
@@ -91,21 +149,66 @@ template <typename AT = DefaultAddressTraits> class MMapStorage
             return false;
         if ( new_total_size <= _size )
             return false;
-        return expand_impl( new_total_size );
+        return remap_impl( new_total_size, true );
+    }
+    bool shrink_to( size_t new_total_size ) noexcept
+    {
+        if ( !_mapped || _readonly )
+            return false;
+        if ( new_total_size == 0 )
+            return false;
+        if ( new_total_size % AT::granule_size != 0 )
+            return false;
+        if ( new_total_size >= _size )
+            return false;
+        return remap_impl( new_total_size, true );
     }
     bool owns_memory() const noexcept { return false; }
 
   private:
+    void track_dirty() noexcept
+    {
+        auto bitmap = std::unique_ptr<detail::DirtyBitmap>( new ( std::nothrow ) detail::DirtyBitmap );
 #if defined( _WIN32 ) || defined( _WIN64 )
-    uint8_t* _base        = nullptr;
-    size_t   _size        = 0;
-    bool     _mapped      = false;
-    HANDLE   _file_handle = INVALID_HANDLE_VALUE;
-    HANDLE   _map_handle  = nullptr;
-    bool     open_impl( const char* path, size_t size_bytes ) noexcept
+        size_t limit = detail::reservation_limit<AT>( ReserveGB );
+        size_t span  = limit > _size ? limit : _size;
+#else
+        size_t span = _reserved;
+#endif
+        if ( bitmap != nullptr && bitmap->init( _base, span, detail::os_page_size() ) &&
+             detail::DirtyRangeTable::add( bitmap.get() ) )
+            _dirty = std::move( bitmap );
+    }
+#if defined( _WIN32 ) || defined( _WIN64 )
+    uint8_t*                             _base        = nullptr;
+    size_t                               _size        = 0;
+    bool                                 _mapped      = false;
+    bool                                 _readonly    = false;
+    std::unique_ptr<detail::DirtyBitmap> _dirty;
+    HANDLE                               _file_handle = INVALID_HANDLE_VALUE;
+    HANDLE                               _map_handle  = nullptr;
+    DWORD  page_protect() const noexcept { return _readonly ? PAGE_READONLY : PAGE_READWRITE; }
+    DWORD  view_access() const noexcept { return _readonly ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS; }
+    size_t current_file_size() const noexcept
     {
-        _file_handle = CreateFileA( path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
-                                    OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr );
+        LARGE_INTEGER size{};
+        if ( !GetFileSizeEx( _file_handle, &size ) )
+            return 0;
+        return static_cast<size_t>( size.QuadPart ) / AT::granule_size * AT::granule_size;
+    }
+    bool sync_range( size_t offset, size_t bytes, FlushMode ) noexcept
+    {
+        return FlushViewOfFile( _base + offset, bytes ) != 0;
+    }
+    bool sync_file( FlushMode mode ) noexcept
+    {
+        return mode == FlushMode::Async || FlushFileBuffers( _file_handle ) != 0;
+    }
+    bool open_impl( const char* path, size_t size_bytes ) noexcept
+    {
+        DWORD access = _readonly ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE;
+        _file_handle = CreateFileA( path, access, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                    _readonly ? OPEN_EXISTING : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr );
         if ( _file_handle == INVALID_HANDLE_VALUE )
             return false;
         LARGE_INTEGER existing_size{};
@@ -115,6 +218,14 @@ template <typename AT = DefaultAddressTraits> class MMapStorage
             _file_handle = INVALID_HANDLE_VALUE;
             return false;
         }
+        if ( _readonly )
+            size_bytes = static_cast<size_t>( existing_size.QuadPart ) / AT::granule_size * AT::granule_size;
+        if ( size_bytes == 0 )
+        {
+            CloseHandle( _file_handle );
+            _file_handle = INVALID_HANDLE_VALUE;
+            return false;
+        }
         if ( static_cast<size_t>( existing_size.QuadPart ) < size_bytes )
         {
             LARGE_INTEGER new_size_li{};
@@ -128,14 +239,14 @@ template <typename AT = DefaultAddressTraits> class MMapStorage
         }
         DWORD size_hi = static_cast<DWORD>( size_bytes >> 32 );
         DWORD size_lo = static_cast<DWORD>( size_bytes & 0xFFFFFFFF );
-        _map_handle   = CreateFileMappingA( _file_handle, nullptr, PAGE_READWRITE, size_hi, size_lo, nullptr );
+        _map_handle   = CreateFileMappingA( _file_handle, nullptr, page_protect(), size_hi, size_lo, nullptr );
         if ( _map_handle == nullptr )
         {
             CloseHandle( _file_handle );
             _file_handle = INVALID_HANDLE_VALUE;
             return false;
         }
-        void* view = MapViewOfFile( _map_handle, FILE_MAP_ALL_ACCESS, 0, 0, size_bytes );
+        void* view = MapViewOfFile( _map_handle, view_access(), 0, 0, size_bytes );
         if ( view == nullptr )
         {
             CloseHandle( _map_handle );
@@ -167,13 +278,15 @@ template <typename AT = DefaultAddressTraits> class MMapStorage
             _file_handle = INVALID_HANDLE_VALUE;
         }
     }
-    bool expand_impl( size_t new_size ) noexcept
+    bool remap_impl( size_t new_size, bool resize_file ) noexcept
     {
         if ( _base != nullptr )
         {
             FlushViewOfFile( _base, _size );
             UnmapViewOfFile( _base );
             _base = nullptr;
+            if ( _dirty != nullptr )
+                _dirty->rebase( nullptr );
         }
         if ( _map_handle != nullptr )
         {
@@ -182,25 +295,28 @@ template <typename AT = DefaultAddressTraits> class MMapStorage
         }
         LARGE_INTEGER new_size_li{};
         new_size_li.QuadPart = static_cast<LONGLONG>( new_size );
-        if ( !SetFilePointerEx( _file_handle, new_size_li, nullptr, FILE_BEGIN ) || !SetEndOfFile( _file_handle ) )
+        if ( resize_file &&
+             ( !SetFilePointerEx( _file_handle, new_size_li, nullptr, FILE_BEGIN ) || !SetEndOfFile( _file_handle ) ) )
         {
             DWORD hi    = static_cast<DWORD>( _size >> 32 );
             DWORD lo    = static_cast<DWORD>( _size & 0xFFFFFFFF );
-            _map_handle = CreateFileMappingA( _file_handle, nullptr, PAGE_READWRITE, hi, lo, nullptr );
+            _map_handle = CreateFileMappingA( _file_handle, nullptr, page_protect(), hi, lo, nullptr );
             if ( _map_handle != nullptr )
             {
-                void* view = MapViewOfFile( _map_handle, FILE_MAP_ALL_ACCESS, 0, 0, _size );
+                void* view = MapViewOfFile( _map_handle, view_access(), 0, 0, _size );
                 if ( view != nullptr )
                     _base = static_cast<uint8_t*>( view );
             }
+            if ( _dirty != nullptr )
+                _dirty->rebase( _base );
             return false;
         }
         DWORD size_hi = static_cast<DWORD>( new_size >> 32 );
         DWORD size_lo = static_cast<DWORD>( new_size & 0xFFFFFFFF );
-        _map_handle   = CreateFileMappingA( _file_handle, nullptr, PAGE_READWRITE, size_hi, size_lo, nullptr );
+        _map_handle   = CreateFileMappingA( _file_handle, nullptr, page_protect(), size_hi, size_lo, nullptr );
         if ( _map_handle == nullptr )
             return false;
-        void* view = MapViewOfFile( _map_handle, FILE_MAP_ALL_ACCESS, 0, 0, new_size );
+        void* view = MapViewOfFile( _map_handle, view_access(), 0, 0, new_size );
         if ( view == nullptr )
         {
             CloseHandle( _map_handle );
@@ -209,16 +325,38 @@ template <typename AT = DefaultAddressTraits> class MMapStorage
         }
         _base = static_cast<uint8_t*>( view );
         _size = new_size;
+        if ( _dirty != nullptr )
+            _dirty->rebase( _base );
         return true;
     }
 #else
-    uint8_t* _base   = nullptr;
-    size_t   _size   = 0;
-    bool     _mapped = false;
-    int      _fd     = -1;
-    bool     open_impl( const char* path, size_t size_bytes ) noexcept
+    uint8_t*                             _base     = nullptr;
+    size_t                               _size     = 0;
+    bool                                 _mapped   = false;
+    bool                                 _readonly = false;
+    std::unique_ptr<detail::DirtyBitmap> _dirty;
+    int                                  _fd       = -1;
+    size_t                               _reserved = 0;
+    size_t                               _page     = 4096;
+    int    prot() const noexcept { return _readonly ? PROT_READ : PROT_READ | PROT_WRITE; }
+    size_t current_file_size() const noexcept
     {
-        _fd = ::open( path, O_RDWR | O_CREAT, 0600 );
+        struct stat st
+        {
+        };
+        if ( ::fstat( _fd, &st ) != 0 )
+            return 0;
+        return static_cast<size_t>( st.st_size ) / AT::granule_size * AT::granule_size;
+    }
+    bool sync_range( size_t offset, size_t bytes, FlushMode mode ) noexcept
+    {
+        size_t from = offset / _page * _page;
+        return ::msync( _base + from, offset + bytes - from, mode == FlushMode::Sync ? MS_SYNC : MS_ASYNC ) == 0;
+    }
+    bool sync_file( FlushMode ) noexcept { return true; }
+    bool open_impl( const char* path, size_t size_bytes ) noexcept
+    {
+        _fd = _readonly ? ::open( path, O_RDONLY ) : ::open( path, O_RDWR | O_CREAT, 0600 );
         if ( _fd < 0 )
             return false;
         struct stat st
@@ -230,22 +368,34 @@ template <typename AT = DefaultAddressTraits> class MMapStorage
             _fd = -1;
             return false;
         }
-        if ( static_cast<size_t>( st.st_size ) < size_bytes )
+        if ( _readonly )
+            size_bytes = static_cast<size_t>( st.st_size ) / AT::granule_size * AT::granule_size;
+        if ( size_bytes == 0 || ( static_cast<size_t>( st.st_size ) < size_bytes &&
+                                  ::ftruncate( _fd, static_cast<off_t>( size_bytes ) ) != 0 ) )
         {
-            if ( ::ftruncate( _fd, static_cast<off_t>( size_bytes ) ) != 0 )
-            {
-                ::close( _fd );
-                _fd = -1;
-                return false;
-            }
+            ::close( _fd );
+            _fd = -1;
+            return false;
         }
-        void* addr = ::mmap( nullptr, size_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0 );
+        _page            = detail::os_page_size();
+        size_t   limit   = detail::reservation_limit<AT>( ReserveGB );
+        size_t   align   = HugePages ? detail::kHugePageSize : _page;
+        uint8_t* reserve = detail::reserve_address_range_upto( limit > size_bytes ? limit : size_bytes, size_bytes,
+                                                               _page, _reserved, align );
+        void*    addr    = ( reserve == nullptr )
+                               ? MAP_FAILED
+                               : ::mmap( reserve, size_bytes, prot(), MAP_SHARED | MAP_FIXED, _fd, 0 );
         if ( addr == MAP_FAILED )
         {
+            if ( reserve != nullptr )
+                detail::release_address_range( reserve, _reserved );
+            _reserved = 0;
             ::close( _fd );
             _fd = -1;
             return false;
         }
+        if constexpr ( HugePages )
+            detail::advise_huge_pages( addr, size_bytes );
         _base   = static_cast<uint8_t*>( addr );
         _size   = size_bytes;
         _mapped = true;
@@ -254,35 +404,46 @@ template <typename AT = DefaultAddressTraits> class MMapStorage
     void close_impl() noexcept
     {
         if ( _base != nullptr )
-            ::munmap( _base, _size );
+            detail::release_address_range( _base, _reserved );
+        _reserved = 0;
         if ( _fd >= 0 )
         {
             ::close( _fd );
             _fd = -1;
         }
     }
-    bool expand_impl( size_t new_size ) noexcept
+    bool remap_impl( size_t new_size, bool resize_file ) noexcept
     {
-        if ( _base != nullptr )
+        if ( new_size > _reserved )
+            return false;
+        if ( new_size < _size )
         {
-            ::munmap( _base, _size );
-            _base = nullptr;
+            size_t keep   = ( new_size + _page - 1 ) / _page * _page;
+            size_t mapped = ( _size + _page - 1 ) / _page * _page;
+            if ( resize_file && ::ftruncate( _fd, static_cast<off_t>( new_size ) ) != 0 )
+                return false;
+            if ( keep < mapped )
+                (void)detail::decommit_address_range( _base + keep, mapped - keep );
+            _size = new_size;
+            return true;
         }
-        if ( ::ftruncate( _fd, static_cast<off_t>( new_size ) ) != 0 )
-        {
-            void* addr = ::mmap( nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0 );
-            if ( addr != MAP_FAILED )
-                _base = static_cast<uint8_t*>( addr );
+        if ( resize_file && ::ftruncate( _fd, static_cast<off_t>( new_size ) ) != 0 )
             return false;
-        }
-        void* addr = ::mmap( nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0 );
+        size_t from = _size / _page * _page;
+        void*  addr =
+            ::mmap( _base + from, new_size - from, prot(), MAP_SHARED | MAP_FIXED, _fd, static_cast<off_t>( from ) );
         if ( addr == MAP_FAILED )
             return false;
-        _base = static_cast<uint8_t*>( addr );
+        if constexpr ( HugePages )
+            detail::advise_huge_pages( addr, new_size - from );
         _size = new_size;
         return true;
     }
 #endif
 };
 static_assert( is_storage_backend_v<MMapStorage<>>, "" );
+template <typename AT, size_t G, bool H> struct detail::with_huge_pages<MMapStorage<AT, G, H>>
+{
+    using type = MMapStorage<AT, G, true>;
+};
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include "pmm/dirty_tracking.h"
 #include "pmm/pptr.h"
 #include "pmm/types.h"
 #include <cassert>
@@ -63,12 +64,14 @@ template <typename T, typename ManagerT> struct parray
             return false;
         d[_size] = value;
         ++_size;
+        mark_dirty( d + _size - 1, 1 );
         return true;
     }
     void pop_back() noexcept
     {
         if ( _size > 0 )
             --_size;
+        mark_dirty( nullptr, 0 );
     }
     bool set( size_t i, const T& value ) noexcept
     {
@@ -78,6 +81,7 @@ template <typename T, typename ManagerT> struct parray
         if ( d == nullptr )
             return false;
         d[i] = value;
+        mark_dirty( d + i, 1 );
         return true;
     }
     bool reserve( size_t n ) noexcept
@@ -99,8 +103,10 @@ template <typename T, typename ManagerT> struct parray
             if ( d == nullptr )
                 return false;
             std::memset( d + _size, 0, static_cast<size_t>( new_size - _size ) * sizeof( T ) );
+            detail::note_dirty( d + _size, static_cast<size_t>( new_size - _size ) * sizeof( T ) );
         }
         _size = new_size;
+        mark_dirty( nullptr, 0 );
         return true;
     }
     bool insert( size_t index, const T& value ) noexcept
@@ -116,6 +122,7 @@ template <typename T, typename ManagerT> struct parray
             std::memmove( d + index + 1, d + index, ( static_cast<size_t>( _size ) - index ) * sizeof( T ) );
         d[index] = value;
         ++_size;
+        mark_dirty( d + index, static_cast<size_t>( _size ) - index );
         return true;
     }
     bool erase( size_t index ) noexcept
@@ -128,9 +135,14 @@ template <typename T, typename ManagerT> struct parray
         if ( index + 1 < static_cast<size_t>( _size ) )
             std::memmove( d + index, d + index + 1, ( static_cast<size_t>( _size ) - index - 1 ) * sizeof( T ) );
         --_size;
+        mark_dirty( d + index, static_cast<size_t>( _size ) - index );
         return true;
     }
-    void clear() noexcept { _size = 0; }
+    void clear() noexcept
+    {
+        _size = 0;
+        mark_dirty( nullptr, 0 );
+    }
     void free_data() noexcept
     {
         if ( _data_idx != detail::kNullIdx_v<typename ManagerT::address_traits> )
@@ -140,6 +152,7 @@ template <typename T, typename ManagerT> struct parray
         }
         _size     = 0;
         _capacity = 0;
+        mark_dirty( nullptr, 0 );
     }
     bool operator==( const parray& other ) const noexcept
     {
@@ -159,6 +172,11 @@ template <typename T, typename ManagerT> struct parray
 
   private:
     T*   resolve_data() const noexcept { return pmm::pptr<T, ManagerT>( _data_idx ).resolve_unchecked(); }
+    void mark_dirty( const T* first, size_t count ) noexcept
+    {
+        detail::note_dirty( this, sizeof( parray ) );
+        detail::note_dirty( first, count * sizeof( T ) );
+    }
     bool ensure_capacity( uint32_t required ) noexcept
     {
         if ( required <= _capacity )
@@ -177,6 +195,7 @@ template <typename T, typename ManagerT> struct parray
             return false;
         _data_idx = new_p.offset();
         _capacity = new_cap;
+        mark_dirty( nullptr, 0 );
         return true;
     }
 };
@@ -8,23 +8,30 @@
 #endif
 #include "pmm/allocator_policy.h"
 #include "pmm/arena_internals.h"
+#include "pmm/arena_ops.h"
 #include "pmm/block.h"
 #include "pmm/block_state.h"
+#include "pmm/compaction.h"
 #include "pmm/diagnostics.h"
 #include "pmm/forest_registry.h"
 #include "pmm/layout.h"
 #include "pmm/logging_policy.h"
 #include "pmm/manager_configs.h"
+#include "pmm/manager_sync.h"
 #include "pmm/pallocator.h"
 #include "pmm/parray.h"
 #include "pmm/pmap.h"
 #include "pmm/pptr.h"
+#include "pmm/process_shared_lock.h"
 #include "pmm/pstring.h"
 #include "pmm/pstringview.h"
+#include "pmm/readonly_image.h"
+#include "pmm/thread_cache.h"
 #include "pmm/typed_manager_api.h"
 #include "pmm/types.h"
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
@@ -43,6 +50,34 @@ template <typename C> struct config_logging_policy<C, std::void_t<typename C::lo
 {
     using type = typename C::logging_policy;
 };
+template <typename C, typename = void> struct config_validation_policy
+{
+    using type = config::FullValidation;
+};
+template <typename C> struct config_validation_policy<C, std::void_t<typename C::validation_policy>>
+{
+    using type = typename C::validation_policy;
+};
+template <typename C, typename = void> struct config_thread_cache
+{
+    using type = config::NoThreadCache;
+};
+template <typename C> struct config_thread_cache<C, std::void_t<typename C::thread_cache>>
+{
+    using type = typename C::thread_cache;
+};
+template <typename C> inline constexpr size_t config_arena_count_v = 1;
+template <typename C>
+    requires requires { C::arena_count; }
+inline constexpr size_t config_arena_count_v<C> = C::arena_count;
+template <typename C> inline constexpr size_t config_shrink_numerator_v = 0;
+template <typename C>
+    requires requires { C::shrink_numerator; }
+inline constexpr size_t config_shrink_numerator_v<C> = C::shrink_numerator;
+template <typename C> inline constexpr size_t config_shrink_denominator_v = 1;
+template <typename C>
+    requires requires { C::shrink_denominator; }
+inline constexpr size_t config_shrink_denominator_v<C> = C::shrink_denominator;
 }
 template <typename ConfigT = CacheManagerConfig, size_t InstanceId = 0>
 /*
@@ -56,25 +91,45 @@ class PersistMemoryManager : public detail::PersistMemoryTypedApi<PersistMemoryM
     using storage_backend = typename ConfigT::storage_backend;
     using free_block_tree = typename ConfigT::free_block_tree;
     using thread_policy   = typename ConfigT::lock_policy;
-    using logging_policy  = typename detail::config_logging_policy<ConfigT>::type;
+    using logging_policy    = typename detail::config_logging_policy<ConfigT>::type;
+    using validation_policy = typename detail::config_validation_policy<ConfigT>::type;
+    using thread_cache      = typename detail::config_thread_cache<ConfigT>::type;
     static_assert( ConfigT::grow_numerator >= 1, "ConfigT must define grow_numerator >= 1" );
     static_assert( ConfigT::grow_denominator >= 1, "ConfigT must define grow_denominator >= 1" );
     static_assert( ConfigT::grow_numerator >= ConfigT::grow_denominator,
                    "ConfigT::grow_numerator must be >= grow_denominator" );
-    using allocator       = AllocatorPolicy<free_block_tree, address_traits>;
     using index_type      = typename address_traits::index_type;
     using forest_registry = detail::ForestDomainRegistry<address_traits>;
     using forest_domain   = detail::ForestDomainRecord<address_traits>;
     using manager_type    = PersistMemoryManager<ConfigT, InstanceId>;
+    static constexpr size_t kThreadCacheClasses = thread_cache::max_class_bytes / address_traits::granule_size;
+    static constexpr bool   kThreadCacheEnabled = kThreadCacheClasses > 0;
+    static constexpr size_t kArenaCount         = detail::config_arena_count_v<ConfigT>;
+    static constexpr bool   kArenaMode          = kArenaCount > 1;
+    static_assert( !kArenaMode || detail::free_block_tree_reserve_bytes_v<free_block_tree> == 0,
+                   "ArenaConfig requires a free-block tree without an image reserve" );
+    using heap_stats =
+        detail::HeapStatsFreeTree<free_block_tree, address_traits, PersistMemoryManager<ConfigT, InstanceId>, kArenaMode>;
+    using allocator = AllocatorPolicy<heap_stats, address_traits>;
+    static constexpr size_t kShrinkNumerator   = detail::config_shrink_numerator_v<ConfigT>;
+    static constexpr size_t kShrinkDenominator = detail::config_shrink_denominator_v<ConfigT>;
+    static constexpr bool   kAutoShrink        = kShrinkNumerator > 0;
+    static_assert( !kAutoShrink || !kArenaMode, "AutoShrinkConfig cannot be combined with ArenaConfig" );
     template <typename> friend struct pstringview;
     template <typename, typename, typename> friend struct pmap;
     friend class detail::PersistMemoryTypedApi<manager_type>;
+    template <typename> friend struct detail::ArenaOps;
+    template <typename> friend struct detail::CompactionOps;
+    template <typename> friend struct detail::ManagerSyncOps;
+    template <typename> friend struct detail::ReadonlyImageOps;
+    template <typename> friend struct detail::ThreadCacheOps;
     template <typename> friend bool save_manager( const char* );
     template <typename T> using pptr               = pmm::pptr<T, manager_type>;
     using pstringview                              = pmm::pstringview<manager_type>;
     using pstring                                  = pmm::pstring<manager_type>;
     template <typename _K, typename _V> using pmap = pmm::pmap<_K, _V, manager_type>;
     template <typename T> using parray             = pmm::parray<T, manager_type>;
+    template <typename T> using pslab              = pmm::pslab<T, manager_type>;
     template <typename T> using pallocator         = pmm::pallocator<T, manager_type>;
     static PmmError last_error() noexcept { return _last_error; }
     static void     clear_error() noexcept { _last_error = PmmError::Ok; }
@@ -85,7 +140,7 @@ req: fr-001, fr-026, ur-001, feat-001
 */
     static bool     create( size_t initial_size ) noexcept
     {
-        typename thread_policy::unique_lock_type lock( _mutex );
+        write_lock_type lock( _mutex );
         if ( initial_size < detail::kMinMemorySize )
         {
             _last_error = PmmError::InvalidSize;
@@ -112,55 +167,17 @@ req: fr-001, fr-026, ur-001, feat-001
             _last_error = PmmError::BackendError;
             return false;
         }
-        detail::InitGuard guard( _initialized );
-        if ( !init_layout( _backend.base_ptr(), _backend.total_size() ) )
-        {
-            _last_error = PmmError::BackendError;
-            return false;
-        }
-        if ( !bootstrap_forest_registry_unlocked() )
-        {
-            _last_error = PmmError::BackendError;
-            return false;
-        }
-        if ( !validate_bootstrap_invariants_unlocked() )
-        {
-            _last_error = PmmError::BackendError;
-            return false;
-        }
-        _last_error = PmmError::Ok;
-        logging_policy::on_create( _backend.total_size() );
-        guard.commit();
-        return true;
+        return create_unlocked();
     }
     static bool create() noexcept
     {
-        typename thread_policy::unique_lock_type lock( _mutex );
+        write_lock_type lock( _mutex );
         if ( _backend.base_ptr() == nullptr || _backend.total_size() < detail::kMinMemorySize )
         {
             _last_error = ( _backend.base_ptr() == nullptr ) ? PmmError::BackendError : PmmError::InvalidSize;
             return false;
         }
-        detail::InitGuard guard( _initialized );
-        if ( !init_layout( _backend.base_ptr(), _backend.total_size() ) )
-        {
-            _last_error = PmmError::BackendError;
-            return false;
-        }
-        if ( !bootstrap_forest_registry_unlocked() )
-        {
-            _last_error = PmmError::BackendError;
-            return false;
-        }
-        if ( !validate_bootstrap_invariants_unlocked() )
-        {
-            _last_error = PmmError::BackendError;
-            return false;
-        }
-        _last_error = PmmError::Ok;
-        logging_policy::on_create( _backend.total_size() );
-        guard.commit();
-        return true;
+        return create_unlocked();
     }
 /*
 ### pmm-persistmemorymanager-load
@@ -170,10 +187,17 @@ req: fr-002, fr-014, ur-005, feat-001, feat-004, qa-rec-001, qa-compat-001, ur-0
     {
         result.mode = RecoveryMode::Repair;
         result.ok   = true;
-        typename thread_policy::unique_lock_type lock( _mutex );
-        if ( _backend.base_ptr() == nullptr || _backend.total_size() < detail::kMinMemorySize )
+        write_lock_type lock( _mutex );
+        if constexpr ( kThreadCacheEnabled )
+            thread_cache_ops::discard_unlocked();
+        detail::CompactionOps<manager_type>::_cursor = 0;
+        _readonly                                    = false;
+        if ( _backend.base_ptr() == nullptr || _backend.total_size() < detail::kMinMemorySize ||
+             detail::storage_is_readonly( _backend ) || !sync_ops::bind_process_lock_unlocked( false ) )
         {
-            _last_error = ( _backend.base_ptr() == nullptr ) ? PmmError::BackendError : PmmError::InvalidSize;
+            _last_error = ( _backend.base_ptr() == nullptr || _backend.total_size() >= detail::kMinMemorySize )
+                              ? PmmError::BackendError
+                              : PmmError::InvalidSize;
             result.add( ViolationType::HeaderCorruption, DiagnosticAction::Aborted );
             return false;
         }
@@ -211,11 +235,29 @@ req: fr-002, fr-014, ur-005, feat-001, feat-004, qa-rec-001, qa-compat-001, ur-0
                         static_cast<uint64_t>( hdr->granule_size ) );
             return false;
         }
+        if ( kMgrHdrReserveBytes != 0 && BlockStateBase<address_traits>::get_weight( base ) != kMgrHdrGranules )
+        {
+            _last_error = PmmError::UnsupportedImageVersion;
+            logging_policy::on_corruption_detected( PmmError::UnsupportedImageVersion );
+            result.add( ViolationType::HeaderCorruption, DiagnosticAction::Aborted, 0, kMgrHdrGranules,
+                        static_cast<uint64_t>( BlockStateBase<address_traits>::get_weight( base ) ) );
+            return false;
+        }
         auto mark_entries = []( VerifyResult& r, size_t from, DiagnosticAction act )
         {
             for ( size_t i = from; i < r.entry_count; ++i )
                 r.entries[i].action = act;
         };
+        if constexpr ( kArenaMode )
+        {
+            if ( !arena_ops::layout_valid( base ) )
+            {
+                _last_error = PmmError::UnsupportedImageVersion;
+                logging_policy::on_corruption_detected( PmmError::UnsupportedImageVersion );
+                result.add( ViolationType::HeaderCorruption, DiagnosticAction::Aborted, 0, kArenaCount );
+                return false;
+            }
+        }
         detail::ConstArenaView<address_traits> cview{ base, hdr };
         size_t                                 pre = result.entry_count;
         allocator::verify_block_states( cview, result );
@@ -227,7 +269,7 @@ req: fr-002, fr-014, ur-005, feat-001, feat-004, qa-rec-001, qa-compat-001, ur-0
         allocator::verify_counters( cview, result );
         mark_entries( result, pre, DiagnosticAction::Rebuilt );
         pre = result.entry_count;
-        allocator::verify_free_tree( cview, result );
+        verify_free_trees_unlocked( cview, result );
         mark_entries( result, pre, DiagnosticAction::Rebuilt );
         if ( detail::image_version_requires_migration( hdr->image_version ) )
             hdr->image_version = detail::kCurrentImageVersion;
@@ -236,7 +278,10 @@ req: fr-002, fr-014, ur-005, feat-001, feat-004, qa-rec-001, qa-compat-001, ur-0
         detail::ArenaView<address_traits> arena_mut{ base, hdr };
         allocator::repair_linked_list( arena_mut );
         allocator::recompute_counters( arena_mut );
-        allocator::rebuild_free_tree( arena_mut );
+        if constexpr ( kArenaMode )
+            arena_ops::rebuild_unlocked();
+        else
+            allocator::rebuild_free_tree( arena_mut );
         _initialized = true;
         {
             VerifyResult forest_verify;
@@ -274,39 +319,151 @@ req: fr-003, ur-001
 */
     static void destroy() noexcept
     {
-        typename thread_policy::unique_lock_type lock( _mutex );
+        write_lock_type lock( _mutex );
+        sync_ops::unbind_process_lock_unlocked();
         if ( !_initialized )
             return;
+        if constexpr ( kThreadCacheEnabled )
+            thread_cache_ops::flush_unlocked();
         _initialized = false;
         logging_policy::on_destroy();
     }
     static void destroy_image() noexcept
     {
-        typename thread_policy::unique_lock_type lock( _mutex );
-        uint8_t*                                 base = _backend.base_ptr();
-        if ( base != nullptr && _backend.total_size() >= detail::kMinMemorySize )
+        write_lock_type lock( _mutex );
+        if constexpr ( kThreadCacheEnabled )
+            thread_cache_ops::discard_unlocked();
+        sync_ops::unbind_process_lock_unlocked();
+        uint8_t* base = _backend.base_ptr();
+        if ( base != nullptr && !_readonly && _backend.total_size() >= detail::kMinMemorySize )
             get_header( base )->magic = 0;
         _initialized = false;
         logging_policy::on_destroy();
     }
     static bool is_initialized() noexcept { return _initialized.load( std::memory_order_acquire ); }
 /*
+### pmm-persistmemorymanager-load_readonly
+req: fr-002, ur-005, qa-thread-001, sys-003
+*/
+    static bool load_readonly( VerifyResult& result ) noexcept
+    {
+        return detail::ReadonlyImageOps<manager_type>::attach( result );
+    }
+/*
 ### pmm-persistmemorymanager-allocate
 req: fr-004, fr-021, fr-022, ur-002, feat-002
 */
     static void* allocate( size_t user_size ) noexcept
     {
-        typename thread_policy::unique_lock_type lock( _mutex );
-        return allocate_unlocked( user_size );
+        return allocate_with( user_size, true, []( void* raw ) noexcept { return raw; } );
+    }
+/*
+### pmm-persistmemorymanager-allocate_aligned
+req: fr-004, feat-002
+*/
+    static void* allocate_aligned( size_t user_size, size_t align, bool by_offset = false ) noexcept
+    {
+        if ( align == 0 || ( align & ( align - 1 ) ) != 0 )
+        {
+            _last_error = PmmError::InvalidSize;
+            logging_policy::on_allocation_failure( user_size, PmmError::InvalidSize );
+            return nullptr;
+        }
+        if ( align <= address_traits::granule_size )
+            return allocate( user_size );
+        detail::LatencyTimer<detail::logs_allocate_v<logging_policy>> timer;
+        write_lock_type                                               lock( _mutex );
+        void*                                                         raw =
+            allocate_unlocked( user_size, align, by_offset );
+        note_allocate_unlocked( raw, user_size );
+        if constexpr ( detail::logs_allocate_v<logging_policy> )
+        {
+            if ( raw != nullptr )
+                logging_policy::on_allocate( user_size, granted_bytes_unlocked( raw ), timer.elapsed_ns() );
+        }
+        return raw;
     }
     static void deallocate( void* ptr ) noexcept
     {
-        typename thread_policy::unique_lock_type lock( _mutex );
-        deallocate_unlocked( ptr );
+        detail::LatencyTimer<detail::logs_deallocate_v<logging_policy>> timer;
+        size_t                                                          size = release_ptr( ptr );
+        if constexpr ( detail::logs_deallocate_v<logging_policy> )
+        {
+            if ( size != 0 )
+                logging_policy::on_deallocate( size, timer.elapsed_ns() );
+        }
+    }
+/*
+### pmm-persistmemorymanager-flush_thread_caches
+req: qa-thread-001, qa-perf-001
+*/
+    static void flush_thread_caches() noexcept
+    {
+        if constexpr ( kThreadCacheEnabled )
+        {
+            write_lock_type lock( _mutex );
+            thread_cache_ops::flush_unlocked();
+        }
+    }
+/*
+### pmm-persistmemorymanager-compact_step
+req: fr-004, feat-003
+*/
+    template <typename OnMove>
+    static CompactResult compact_step( std::chrono::nanoseconds budget, OnMove&& on_move ) noexcept
+    {
+        write_lock_type lock( _mutex );
+        if ( !writable_unlocked() )
+        {
+            _last_error = unwritable_error();
+            return CompactResult{ 0, 0, false };
+        }
+        return detail::CompactionOps<manager_type>::step( budget, on_move );
+    }
+    static CompactResult compact_step( std::chrono::nanoseconds budget ) noexcept
+    {
+        return compact_step( budget, []( index_type, index_type ) noexcept {} );
     }
+/*
+### pmm-persistmemorymanager-shrink_to_fit
+req: fr-004, fr-026
+*/
+    static bool shrink_to_fit() noexcept
+    {
+        write_lock_type lock( _mutex );
+        if ( !writable_unlocked() )
+        {
+            _last_error = unwritable_error();
+            return false;
+        }
+        if constexpr ( kThreadCacheEnabled )
+            thread_cache_ops::flush_unlocked();
+        return do_shrink( 0 );
+    }
+/*
+### pmm-persistmemorymanager-flush
+req: fr-014, qa-rec-001, qa-perf-001
+*/
+    static bool flush( FlushMode mode = FlushMode::Sync ) noexcept
+    {
+        read_lock_type lock( _mutex );
+        if ( !_initialized )
+        {
+            _last_error = PmmError::NotInitialized;
+            return false;
+        }
+        bool ok = false;
+        if constexpr ( sync_ops::kDirtyTracking )
+            ok = _backend.flush( mode );
+        else
+            (void)mode;
+        _last_error = ok ? PmmError::Ok : PmmError::BackendError;
+        return ok;
+    }
+    static void mark_dirty( const void* ptr, size_t bytes ) noexcept { detail::note_dirty( ptr, bytes ); }
     static bool lock_block_permanent( void* ptr ) noexcept
     {
-        typename thread_policy::unique_lock_type lock( _mutex );
+        write_lock_type lock( _mutex );
         return lock_block_permanent_unlocked( ptr );
     }
     static bool is_permanently_locked( const void* ptr ) noexcept
@@ -321,7 +478,7 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
     }
     template <typename T> static void set_root( pptr<T> p ) noexcept
     {
-        typename thread_policy::unique_lock_type lock( _mutex );
+        write_lock_type lock( _mutex );
         if ( !_initialized )
             return;
         set_forest_domain_root_index_unlocked( find_domain_by_name_unlocked( detail::kServiceNameDomainRoot ),
@@ -329,22 +486,12 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
     }
     template <typename T> static pptr<T> get_root() noexcept
     {
-        typename thread_policy::shared_lock_type lock( _mutex );
-        if ( !_initialized )
-            return pptr<T>();
-        index_type root =
-            forest_domain_root_index_unlocked( find_domain_by_name_unlocked( detail::kServiceNameDomainRoot ) );
-        if ( root == static_cast<index_type>( 0 ) )
-            return pptr<T>();
-        return pptr<T>( root );
+        index_type root = get_domain_root_offset( detail::kServiceNameDomainRoot );
+        return ( root == static_cast<index_type>( 0 ) ) ? pptr<T>() : pptr<T>( root );
     }
     static index_type find_domain_by_name( const char* name ) noexcept
     {
-        typename thread_policy::shared_lock_type lock( _mutex );
-        if ( !_initialized )
-            return 0;
-        const forest_domain* rec = find_domain_by_name_unlocked( name );
-        return ( rec != nullptr ) ? rec->binding_id : static_cast<index_type>( 0 );
+        return sync_ops::find_domain_optimistic( name );
     }
     static index_type find_domain_by_symbol( pptr<pstringview> symbol ) noexcept
     {
@@ -362,33 +509,25 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
     }
     static bool register_domain( const char* name ) noexcept
     {
-        typename thread_policy::unique_lock_type lock( _mutex );
+        write_lock_type lock( _mutex );
         if ( !_initialized )
             return false;
         return register_domain_unlocked( name, 0, detail::kForestBindingDirectRoot, 0 );
     }
     static bool register_system_domain( const char* name ) noexcept
     {
-        typename thread_policy::unique_lock_type lock( _mutex );
+        write_lock_type lock( _mutex );
         if ( !_initialized )
             return false;
         return register_domain_unlocked( name, detail::kForestDomainFlagSystem, detail::kForestBindingDirectRoot, 0 );
     }
     static index_type get_domain_root_offset( const char* name ) noexcept
     {
-        typename thread_policy::shared_lock_type lock( _mutex );
-        if ( !_initialized )
-            return 0;
-        const forest_domain* rec = find_domain_by_name_unlocked( name );
-        return forest_domain_root_index_unlocked( rec );
+        return sync_ops::domain_root_optimistic( name );
     }
     static index_type get_domain_root_offset( index_type binding_id ) noexcept
     {
-        typename thread_policy::shared_lock_type lock( _mutex );
-        if ( !_initialized )
-            return 0;
-        const forest_domain* rec = find_domain_by_binding_unlocked( binding_id );
-        return forest_domain_root_index_unlocked( rec );
+        return sync_ops::domain_root_optimistic( binding_id );
     }
     static index_type get_domain_root_offset( pptr<pstringview> symbol ) noexcept
     {
@@ -415,7 +554,7 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
     }
     template <typename T> static bool set_domain_root( const char* name, pptr<T> root ) noexcept
     {
-        typename thread_policy::unique_lock_type lock( _mutex );
+        write_lock_type lock( _mutex );
         if ( !_initialized )
             return false;
         forest_domain* rec = find_domain_by_name_unlocked( name );
@@ -436,8 +575,8 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
         }
         const index_type    blk_idx = block_idx_from_pptr( p );
         const pmm::NodeType nt      = BlockStateBase<address_traits>::get_node_type( blk );
-        if ( !pmm::is_known_node_type( static_cast<std::uint8_t>( nt ) ) || !pmm::is_allocated( nt ) ||
-             BlockStateBase<address_traits>::get_root_offset( blk ) != blk_idx )
+        if ( !pmm::is_known_node_type( static_cast<std::uint8_t>( nt ) ) ||
+             !BlockStateBase<address_traits>::is_allocated_raw( blk, blk_idx ) )
         {
             _last_error = PmmError::InvalidPointer;
             return nullptr;
@@ -520,74 +659,93 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
             return nullptr;
         return detail::block_header_at<address_traits>( blk );
     }
-    template <typename T> static BlockHeader<address_traits>& tree_node_unchecked( pptr<T> p ) noexcept
+    template <typename T> static decltype( auto ) tree_node_unchecked( pptr<T> p ) noexcept
     {
         assert( !p.is_null() && "tree_node_unchecked: pptr must not be null" );
         assert( _initialized && "tree_node_unchecked: manager must be initialized" );
         void* blk = block_raw_mut_ptr_from_pptr( p );
         assert( blk != nullptr && "tree_node_unchecked: pptr must resolve to a valid block" );
-        return *detail::block_header_at<address_traits>( blk );
+        return BlockStateBase<address_traits>::tree_node_of( blk );
     }
 
   private:
-    template <typename Fn> static size_t read_stat( Fn fn ) noexcept
-    {
-        if ( !_initialized.load( std::memory_order_acquire ) )
-            return 0;
-        typename thread_policy::shared_lock_type lock( _mutex );
-        if ( !_initialized.load( std::memory_order_relaxed ) )
-            return 0;
-        return fn( get_header_c( _backend.base_ptr() ) );
-    }
+    using read_lock_type   = std::conditional_t<kArenaMode, typename thread_policy::unique_lock_type,
+                                                typename thread_policy::shared_lock_type>;
+    using sync_ops         = detail::ManagerSyncOps<manager_type>;
+    using logged_lock_type = detail::logged_lock_t<typename thread_policy::unique_lock_type, logging_policy>;
+    using write_lock_type  = detail::SeqlockWriteLock<logged_lock_type, sync_ops>;
 
   public:
     static size_t total_size() noexcept
     {
-        if ( !_initialized.load( std::memory_order_acquire ) )
-            return 0;
-        typename thread_policy::shared_lock_type lock( _mutex );
-        return _initialized.load( std::memory_order_relaxed ) ? _backend.total_size() : 0;
+        return sync_ops::read_stat( []( const auto* h ) { return static_cast<size_t>( h->image_size ); } );
     }
     static size_t used_size() noexcept
     {
-        return read_stat( []( const auto* h ) { return address_traits::granules_to_bytes( h->used_size ); } );
+        return sync_ops::read_stat(
+            []( const auto* h )
+            { return address_traits::granules_to_bytes( static_cast<index_type>( h->used_size ) ); } );
     }
     static size_t free_size() noexcept
     {
-        return read_stat(
+        return sync_ops::read_stat(
             []( const auto* h )
             {
-                size_t used = address_traits::granules_to_bytes( h->used_size );
-                return ( h->total_size > used ) ? ( h->total_size - used ) : size_t( 0 );
+                size_t used = address_traits::granules_to_bytes( static_cast<index_type>( h->used_size ) );
+                return ( h->total_size > used ) ? static_cast<size_t>( h->total_size - used ) : size_t( 0 );
             } );
     }
     static size_t block_count() noexcept
     {
-        return read_stat( []( const auto* h ) { return static_cast<size_t>( h->block_count ); } );
+        return sync_ops::read_stat( []( const auto* h ) { return static_cast<size_t>( h->block_count ); } );
     }
     static size_t free_block_count() noexcept
     {
-        return read_stat( []( const auto* h ) { return static_cast<size_t>( h->free_count ); } );
+        return sync_ops::read_stat( []( const auto* h ) { return static_cast<size_t>( h->free_count ); } );
     }
     static size_t alloc_block_count() noexcept
     {
-        return read_stat( []( const auto* h ) { return static_cast<size_t>( h->alloc_count ); } );
+        return sync_ops::read_stat( []( const auto* h ) { return static_cast<size_t>( h->alloc_count ); } );
+    }
+/*
+### pmm-persistmemorymanager-memory_stats_detailed
+req: feat-005, fr-019, qa-perf-001
+*/
+    static DetailedMemoryStats memory_stats_detailed() noexcept
+    {
+        DetailedMemoryStats stats{};
+        if ( !_initialized.load( std::memory_order_acquire ) )
+            return stats;
+        if ( heap_stats::stale.load( std::memory_order_relaxed ) )
+        {
+            write_lock_type lock( _mutex );
+            if ( _initialized )
+                heap_stats_rebuild_unlocked();
+        }
+        read_lock_type lock( _mutex );
+        if ( _initialized )
+            heap_stats_collect_unlocked( stats );
+        if constexpr ( storage_uses_huge_pages_v<storage_backend> )
+            stats.huge_page_bytes = _initialized ? _backend.huge_page_bytes() : 0;
+        return stats;
     }
     static VerifyResult verify() noexcept
     {
-        VerifyResult                             result;
-        typename thread_policy::shared_lock_type lock( _mutex );
+        VerifyResult   result;
+        read_lock_type lock( _mutex );
         if ( !_initialized || _backend.base_ptr() == nullptr )
         {
             result.add( ViolationType::HeaderCorruption, DiagnosticAction::Aborted );
             return result;
         }
+        if constexpr ( kArenaMode )
+            arena_ops::sync_header_unlocked();
         verify_image_unlocked( result );
         return result;
     }
     template <typename Callback> static bool for_each_block( Callback&& callback ) noexcept
     {
-        typename thread_policy::shared_lock_type lock( _mutex );
+        read_lock_type lock( _mutex );
         if ( !_initialized )
             return false;
         const uint8_t* base                                  = _backend.base_ptr();
@@ -619,12 +777,25 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
     }
     template <typename Callback> static bool for_each_free_block( Callback&& callback ) noexcept
     {
-        typename thread_policy::shared_lock_type lock( _mutex );
+        read_lock_type lock( _mutex );
         if ( !_initialized )
             return false;
         const uint8_t*                               base = _backend.base_ptr();
         const detail::ManagerHeader<address_traits>* hdr  = get_header_c( base );
         for_each_free_block_inorder( base, hdr, hdr->free_tree_root, 0, callback );
+        if constexpr ( kArenaMode )
+        {
+            for ( size_t a = 0; a < kArenaCount; ++a )
+            {
+                const detail::ManagerHeader<address_traits>* sub = arena_ops::header_c( base, a );
+                for_each_free_block_inorder( base, sub, sub->free_tree_root, 0, callback );
+            }
+        }
+        if constexpr ( requires { free_block_tree::for_each_listed( base, hdr, []( index_type ) {} ); } )
+        {
+            auto emit = [&]( index_type idx ) { callback( free_block_view( base, hdr, idx, 0 ) ); };
+            free_block_tree::for_each_listed( base, hdr, emit );
+        }
         return true;
     }
     static storage_backend& backend() noexcept { return _backend; }
@@ -634,6 +805,14 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
     static inline std::atomic<bool>                  _initialized{ false };
     static inline typename thread_policy::mutex_type _mutex{};
     static inline thread_local PmmError              _last_error{ PmmError::Ok };
+    static inline bool                               _readonly = false;
+    static bool     writable_unlocked() noexcept { return _initialized && !_readonly; }
+    static PmmError unwritable_error() noexcept
+    {
+        if ( sync_ops::_lock_failed )
+            return PmmError::LockFailed;
+        return _readonly ? PmmError::ReadOnlyImage : PmmError::NotInitialized;
+    }
     static bool is_valid_user_offset_unlocked( index_type off, size_t size_bytes ) noexcept
     {
         if ( off == 0 || _backend.base_ptr() == nullptr || _backend.total_size() == 0 )
@@ -643,12 +822,12 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
             return false;
         return detail::fits_range( *byte_off_opt, size_bytes, _backend.total_size() );
     }
-    static void* allocate_unlocked( size_t user_size ) noexcept
+    static void* allocate_unlocked( size_t user_size, size_t align = 0, bool by_offset = false ) noexcept
     {
-        if ( !_initialized )
+        if ( !writable_unlocked() )
         {
-            _last_error = PmmError::NotInitialized;
-            logging_policy::on_allocation_failure( user_size, PmmError::NotInitialized );
+            _last_error = unwritable_error();
+            logging_policy::on_allocation_failure( user_size, _last_error );
             return nullptr;
         }
         if ( user_size == 0 )
@@ -677,62 +856,220 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
             logging_policy::on_allocation_failure( user_size, PmmError::Overflow );
             return nullptr;
         }
-        uint8_t*                               base   = _backend.base_ptr();
-        detail::ManagerHeader<address_traits>* hdr    = get_header( base );
-        index_type                             needed = kBlockHdrGranules + data_gran;
-        index_type                             idx    = free_block_tree::find_best_fit( base, hdr, needed );
-        if ( idx != address_traits::no_block )
+        index_type slack = 0;
+        if ( align > address_traits::granule_size )
+        {
+            size_t align_gran = align / address_traits::granule_size;
+            if ( align_gran > std::numeric_limits<index_type>::max() - 2 * size_t{ kBlockHdrGranules } - data_gran )
+            {
+                _last_error = PmmError::Overflow;
+                logging_policy::on_allocation_failure( user_size, PmmError::Overflow );
+                return nullptr;
+            }
+            slack = static_cast<index_type>( kBlockHdrGranules + align_gran );
+        }
+        void* raw = allocate_fit_unlocked( data_gran, align, by_offset );
+        if ( raw != nullptr )
         {
             _last_error = PmmError::Ok;
-            return allocator::allocate_from_block( detail::ArenaView<address_traits>{ base, hdr }, idx, data_gran );
+            return raw;
         }
-        if ( !do_expand( data_gran ) )
+        if ( !do_expand( static_cast<index_type>( data_gran + slack ) ) )
         {
             _last_error = PmmError::OutOfMemory;
             logging_policy::on_allocation_failure( user_size, PmmError::OutOfMemory );
             return nullptr;
         }
-        base = _backend.base_ptr();
-        hdr  = get_header( base );
-        idx  = free_block_tree::find_best_fit( base, hdr, needed );
-        if ( idx != address_traits::no_block )
+        raw = allocate_fit_unlocked( data_gran, align, by_offset );
+        if ( raw != nullptr )
         {
             _last_error = PmmError::Ok;
-            return allocator::allocate_from_block( detail::ArenaView<address_traits>{ base, hdr }, idx, data_gran );
+            return raw;
         }
         _last_error = PmmError::OutOfMemory;
         logging_policy::on_allocation_failure( user_size, PmmError::OutOfMemory );
         return nullptr;
     }
-    static void deallocate_unlocked( void* ptr ) noexcept
+    using thread_cache_ops = detail::ThreadCacheOps<manager_type>;
+    using arena_ops        = detail::ArenaOps<manager_type>;
+    template <typename Fn> static auto allocate_with( size_t user_size, bool cacheable, Fn&& finish_raw ) noexcept
+    {
+        detail::LatencyTimer<detail::logs_allocate_v<logging_policy>> timer;
+        auto                                                          finish = [&]( void* raw ) noexcept
+        {
+            note_allocate_unlocked( raw, user_size );
+            if constexpr ( detail::logs_allocate_v<logging_policy> )
+            {
+                if ( raw != nullptr )
+                    logging_policy::on_allocate( user_size, granted_bytes_unlocked( raw ), timer.elapsed_ns() );
+            }
+            return finish_raw( raw );
+        };
+        if constexpr ( kThreadCacheEnabled )
+        {
+            if ( cacheable && user_size != 0 && user_size <= kThreadCacheClasses * address_traits::granule_size )
+                return thread_cache_ops::allocate( ( user_size - 1 ) / address_traits::granule_size, user_size,
+                                                   finish );
+        }
+        if constexpr ( kArenaMode )
+        {
+            auto checked = detail::bytes_to_granules_checked<address_traits>( user_size );
+            if ( user_size != 0 && checked.has_value() && checked->value != 0 &&
+                 checked->value <= std::numeric_limits<index_type>::max() - kBlockHdrGranules )
+            {
+                decltype( finish( nullptr ) ) out{};
+                auto                          emit = [&]( void* raw ) { out = finish( raw ); };
+                if ( arena_ops::try_allocate( checked->value, emit ) )
+                    return out;
+            }
+        }
+        write_lock_type lock( _mutex );
+        return finish( allocate_unlocked( user_size ) );
+    }
+    static size_t release_ptr( void* ptr ) noexcept
+    {
+        if constexpr ( kThreadCacheEnabled )
+        {
+            if ( size_t bytes = thread_cache_ops::push( ptr ); bytes != 0 )
+                return bytes;
+        }
+        if constexpr ( kArenaMode )
+        {
+            return arena_ops::deallocate( ptr );
+        }
+        else
+        {
+            write_lock_type lock( _mutex );
+            size_t          bytes = note_deallocate_unlocked( ptr, deallocate_unlocked( ptr ) );
+            auto_shrink_unlocked();
+            return bytes;
+        }
+    }
+    static size_t granted_bytes_unlocked( const void* raw ) noexcept
+    {
+        const auto* blk = static_cast<const uint8_t*>( raw ) - sizeof( Block<address_traits> );
+        return static_cast<size_t>( BlockStateBase<address_traits>::get_weight( blk ) ) * address_traits::granule_size;
+    }
+    static uint64_t user_offset_of( const void* raw ) noexcept
+    {
+        return static_cast<uint64_t>( static_cast<const uint8_t*>( raw ) - _backend.base_ptr() ) /
+               address_traits::granule_size;
+    }
+    static void note_allocate_unlocked( void* raw, size_t user_size ) noexcept
+    {
+        if constexpr ( detail::logs_trace_v<logging_policy> )
+        {
+            if ( raw != nullptr )
+                logging_policy::on_trace_allocate( user_offset_of( raw ), user_size );
+        }
+    }
+    static size_t note_deallocate_unlocked( const void* ptr, size_t bytes ) noexcept
+    {
+        if constexpr ( detail::logs_trace_v<logging_policy> )
+        {
+            if ( bytes != 0 )
+                logging_policy::on_trace_deallocate( user_offset_of( ptr ) );
+        }
+        return bytes;
+    }
+    static void* allocate_fit_unlocked( index_type data_gran, size_t align = 0, bool by_offset = false ) noexcept
+    {
+        if constexpr ( kArenaMode )
+            return arena_ops::fit_unlocked( data_gran, align, by_offset );
+        uint8_t* base = _backend.base_ptr();
+        return fit_in_unlocked( base, get_header( base ), data_gran, align, by_offset );
+    }
+    static void* fit_in_unlocked( uint8_t* base, detail::ManagerHeader<address_traits>* hdr, index_type data_gran,
+                                  size_t align, bool by_offset = false ) noexcept
+    {
+        detail::ArenaView<address_traits> arena{ base, hdr };
+        const uint8_t*                    origin = by_offset ? nullptr : base;
+        index_type idx = free_block_tree::find_best_fit( base, hdr, kBlockHdrGranules + data_gran );
+        if ( align > address_traits::granule_size &&
+             ( idx == address_traits::no_block || allocator::aligned_lead( origin, idx, align ) != 0 ) )
+        {
+            index_type slack = static_cast<index_type>( kBlockHdrGranules + align / address_traits::granule_size );
+            idx = free_block_tree::find_best_fit( base, hdr, kBlockHdrGranules + data_gran + slack );
+            if ( idx == address_traits::no_block )
+                return nullptr;
+            return allocator::allocate_aligned_from_block( arena, idx, data_gran,
+                                                           allocator::aligned_lead( origin, idx, align ) );
+        }
+        if ( idx == address_traits::no_block )
+            return nullptr;
+        return allocator::allocate_from_block( arena, idx, data_gran );
+    }
+    template <typename Fn> static size_t allocate_run_unlocked( index_type data_gran, size_t count, Fn&& emit ) noexcept
+    {
+        if ( !writable_unlocked() )
+            return 0;
+        uint8_t*                               base = _backend.base_ptr();
+        detail::ManagerHeader<address_traits>* hdr  = arena_ops::local_header( base );
+        index_type step    = kBlockHdrGranules + data_gran;
+        size_t     max_run = std::numeric_limits<index_type>::max() / step;
+        index_type run     = static_cast<index_type>( count < max_run ? count : max_run );
+        index_type idx     = free_block_tree::find_best_fit( base, hdr, static_cast<index_type>( run * step ) );
+        if ( idx == address_traits::no_block )
+            return 0;
+        return allocator::allocate_run_from_block( detail::ArenaView<address_traits>{ base, hdr }, idx, data_gran, run,
+                                                   emit );
+    }
+    template <typename Next> static void release_sorted_unlocked( Next&& next ) noexcept
+    {
+        uint8_t*   base = _backend.base_ptr();
+        index_type idx  = next();
+        while ( idx != address_traits::no_block )
+        {
+            detail::ArenaView<address_traits> arena{ base, arena_ops::owning_header( base, idx ) };
+            idx = allocator::release_sorted( arena, idx, arena_ops::limit_of( base, idx ), next );
+        }
+    }
+    static size_t deallocate_unlocked( void* ptr ) noexcept
     {
         if ( !_initialized || ptr == nullptr )
-            return;
+            return 0;
         pmm::Block<address_traits>* blk = find_block_from_user_ptr( ptr );
-        if ( blk == nullptr )
-            return;
+        if ( !deallocatable_block( blk ) )
+            return 0;
+        size_t     bytes   = granted_bytes_unlocked( ptr );
+        uint8_t*   base    = _backend.base_ptr();
+        index_type blk_idx = detail::block_idx_t<address_traits>( base, blk );
+        release_block( detail::ArenaView<address_traits>{ base, arena_ops::owning_header( base, blk_idx ) }, blk_idx );
+        return bytes;
+    }
+    static bool deallocatable_block( const pmm::Block<address_traits>* blk ) noexcept
+    {
+        if ( blk == nullptr || _readonly )
+            return false;
         const pmm::NodeType nt = BlockStateBase<address_traits>::get_node_type( blk );
         if ( !pmm::is_allocated( nt ) || !pmm::can_be_deleted_from_pap( nt ) )
-            return;
-        index_type freed = BlockStateBase<address_traits>::get_weight( blk );
-        if ( freed == 0 )
-            return;
-        uint8_t*                               base       = _backend.base_ptr();
-        detail::ManagerHeader<address_traits>* hdr        = get_header( base );
-        index_type                             blk_idx    = detail::block_idx_t<address_traits>( base, blk );
-        index_type                             total_gran = detail::physical_block_total_granules<address_traits>(
-            base, hdr, detail::block_at<address_traits>( base, blk_idx ) );
+            return false;
+        if constexpr ( kThreadCacheEnabled )
+        {
+            if ( thread_cache_ops::cached( blk ) )
+                return false;
+        }
+        return BlockStateBase<address_traits>::get_weight( blk ) != 0;
+    }
+    static void release_block( detail::ArenaView<address_traits> arena, index_type blk_idx ) noexcept
+    {
+        uint8_t*                               base       = arena.base();
+        detail::ManagerHeader<address_traits>* hdr        = arena.header();
+        pmm::Block<address_traits>*            blk        = detail::block_at<address_traits>( base, blk_idx );
+        index_type                             freed      = BlockStateBase<address_traits>::get_weight( blk );
+        index_type total_gran = detail::physical_block_total_granules<address_traits>( base, hdr, blk );
         AllocatedBlock<address_traits> alloc = AllocatedBlock<address_traits>::cast_from_raw( blk );
         alloc.mark_as_free( total_gran );
         hdr->alloc_count--;
         hdr->free_count++;
         if ( hdr->used_size >= freed )
             hdr->used_size -= freed;
-        allocator::coalesce( detail::ArenaView<address_traits>{ base, hdr }, blk_idx );
+        allocator::note_allocated( freed, false );
+        allocator::coalesce( arena, blk_idx );
     }
     static bool lock_block_permanent_unlocked( void* ptr ) noexcept
     {
-        if ( !_initialized || ptr == nullptr )
+        if ( !writable_unlocked() || ptr == nullptr )
             return false;
         pmm::Block<address_traits>* blk = find_block_from_user_ptr( ptr );
         if ( blk == nullptr )
@@ -760,12 +1097,31 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
         ::new ( obj ) T( static_cast<Args&&>( args )... );
         return p;
     }
+    static void* tree_block_at( uint8_t* base, index_type user_idx ) noexcept
+    {
+        return detail::block_at<address_traits>( base, static_cast<index_type>( user_idx - kBlockHdrGranules ) );
+    }
+    static void prepare_snapshot_unlocked() noexcept
+    {
+        if constexpr ( kThreadCacheEnabled )
+            thread_cache_ops::flush_unlocked();
+        if constexpr ( kArenaMode )
+        {
+            if ( _initialized )
+                arena_ops::sync_header_unlocked();
+        }
+    }
 #include "pmm/forest_domain_mixin.inc"
 #include "pmm/verify_repair_mixin.inc"
     static constexpr size_t     kBlockHdrByteSize = detail::manager_header_offset_bytes_v<address_traits>;
     static constexpr index_type kBlockHdrGranules =
         static_cast<index_type>( kBlockHdrByteSize / address_traits::granule_size );
-    static constexpr index_type                   kMgrHdrGranules   = detail::kManagerHeaderGranules_t<address_traits>;
+    static constexpr size_t     kMgrHdrReserveBytes =
+        detail::free_block_tree_reserve_bytes_v<free_block_tree> + detail::lock_policy_reserve_bytes_v<thread_policy> +
+        ( kArenaMode ? kArenaCount * sizeof( detail::ManagerHeader<address_traits> ) : 0 );
+    static constexpr index_type kMgrHdrGranules     = static_cast<index_type>(
+        ( sizeof( detail::ManagerHeader<address_traits> ) + kMgrHdrReserveBytes + address_traits::granule_size - 1 ) /
+        address_traits::granule_size );
     static constexpr index_type                   kFreeBlkIdxLayout = kBlockHdrGranules + kMgrHdrGranules;
     static detail::ManagerHeader<address_traits>* get_header( uint8_t* base ) noexcept
     {
@@ -778,7 +1134,7 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
     struct layout_access
     {
         using address_traits                                            = manager_type::address_traits;
-        using free_block_tree                                           = manager_type::free_block_tree;
+        using free_block_tree                                           = manager_type::heap_stats;
         using logging_policy                                            = manager_type::logging_policy;
         using storage_backend                                           = manager_type::storage_backend;
         using index_type                                                = manager_type::index_type;
@@ -796,13 +1152,69 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
         }
         static void set_initialized() noexcept { manager_type::_initialized = true; }
     };
+    static bool create_unlocked() noexcept
+    {
+        if constexpr ( kThreadCacheEnabled )
+            thread_cache_ops::discard_unlocked();
+        detail::CompactionOps<manager_type>::_cursor = 0;
+        detail::InitGuard guard( _initialized );
+        if ( !init_layout( _backend.base_ptr(), _backend.total_size() ) || !bootstrap_forest_registry_unlocked() ||
+             !validate_bootstrap_invariants_unlocked() )
+        {
+            _last_error = PmmError::BackendError;
+            return false;
+        }
+        _last_error = PmmError::Ok;
+        logging_policy::on_create( _backend.total_size() );
+        guard.commit();
+        return true;
+    }
     static bool init_layout( uint8_t* base, size_t size ) noexcept
     {
-        return detail::ManagerLayoutOps<layout_access>::init_layout( _backend, base, size );
+        _readonly = false;
+        if ( detail::storage_is_readonly( _backend ) ||
+             !detail::ManagerLayoutOps<layout_access>::init_layout( _backend, base, size ) ||
+             !sync_ops::bind_process_lock_unlocked( true ) )
+            return false;
+        if constexpr ( kArenaMode )
+            return arena_ops::partition_unlocked();
+        return true;
     }
     static bool do_expand( index_type data_gran ) noexcept
     {
+        if constexpr ( kArenaMode )
+            return arena_ops::expand_unlocked( data_gran );
         return detail::ManagerLayoutOps<layout_access>::do_expand( _backend, _initialized, data_gran );
     }
+    static bool do_shrink( size_t target_size ) noexcept
+    {
+        if constexpr ( !requires { _backend.shrink_to( target_size ); } )
+        {
+            _last_error = PmmError::BackendError;
+            return false;
+        }
+        else if constexpr ( kArenaMode )
+        {
+            return arena_ops::shrink_unlocked( target_size );
+        }
+        else
+        {
+            return detail::ManagerLayoutOps<layout_access>::do_shrink( _backend, _initialized, target_size );
+        }
+    }
+    static void auto_shrink_unlocked() noexcept
+    {
+        if constexpr ( kAutoShrink )
+        {
+            if ( !writable_unlocked() )
+                return;
+            size_t total = _backend.total_size();
+            size_t spare = detail::ManagerLayoutOps<layout_access>::tail_free_bytes( _backend.base_ptr() );
+            if ( spare * kShrinkDenominator <= total * kShrinkNumerator )
+                return;
+            size_t in_use = total - spare;
+            do_shrink( in_use / ConfigT::grow_denominator * ConfigT::grow_numerator );
+        }
+    }
 };
 }
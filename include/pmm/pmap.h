@@ -1,8 +1,11 @@
 #pragma once
 #include "pmm/avl_tree_mixin.h"
+#include "pmm/dirty_tracking.h"
 #include "pmm/forest_registry.h"
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <span>
 #include <type_traits>
 namespace pmm
 {
@@ -53,15 +56,15 @@ inline uint64_t pmap_key_hash( const char* key ) noexcept
     }
     return h;
 }
-inline bool pmap_write_name( char ( &out )[kForestDomainNameCapacity], uint32_t type_fp, char kind, uint64_t value,
-                             unsigned value_hex_digits ) noexcept
+inline constexpr char kPmapDomainPrefix[] = "container/pmap/";
+inline bool           pmap_write_name( char ( &out )[kForestDomainNameCapacity], uint32_t type_fp, char kind,
+                                       uint64_t value, unsigned value_hex_digits ) noexcept
 {
-    constexpr const char* kPrefix = "container/pmap/";
-    const unsigned        needed  = 15 + 8 + 1 + 1 + value_hex_digits + 1;
+    const unsigned needed = sizeof( kPmapDomainPrefix ) - 1 + 8 + 1 + 1 + value_hex_digits + 1;
     if ( needed > kForestDomainNameCapacity )
         return false;
     size_t p = 0;
-    for ( const char* s = kPrefix; *s != '\0'; ++s )
+    for ( const char* s = kPmapDomainPrefix; *s != '\0'; ++s )
         out[p++] = *s;
     auto put_hex = [&]( uint64_t v, unsigned digits )
     {
@@ -196,15 +199,19 @@ template <typename _K, typename _V, typename ManagerT> struct pmap
         if ( !existing.is_null() )
         {
             if ( node_type* obj = ManagerT::template resolve<node_type>( existing ); obj != nullptr )
+            {
                 obj->value = val;
+                detail::note_dirty( obj, sizeof( node_type ) );
+            }
             return existing;
         }
-        node_pptr  new_node = ManagerT::template allocate_typed<node_type>();
+        node_pptr  new_node = ManagerT::template allocate_tree_node<node_type>();
         node_type* obj      = new_node.is_null() ? nullptr : ManagerT::template resolve<node_type>( new_node );
         if ( obj == nullptr )
             return node_pptr();
         obj->key   = key;
         obj->value = val;
+        detail::note_dirty( obj, sizeof( node_type ) );
         detail::avl_init_node( new_node );
         ops.insert( new_node );
         return new_node;
@@ -235,9 +242,22 @@ template <typename _K, typename _V, typename ManagerT> struct pmap
         if ( root == nullptr )
             return;
         if ( *root != static_cast<index_type>( 0 ) )
+        {
+            node_pptr pending[64];
+            size_t    count = 0;
             detail::avl_clear_subtree( node_pptr( *root ),
-                                       []( node_pptr p ) { ManagerT::template deallocate_typed<node_type>( p ); } );
-        *root = static_cast<index_type>( 0 );
+                                       [&]( node_pptr p )
+                                       {
+                                           pending[count++] = p;
+                                           if ( count == std::size( pending ) )
+                                           {
+                                               ManagerT::template deallocate_batch<node_type>( pending );
+                                               count = 0;
+                                           }
+                                       } );
+            ManagerT::template deallocate_batch<node_type>( std::span<node_pptr>( pending, count ) );
+        }
+        detail::avl_store( *root, 0 );
     }
     void reset() noexcept { forest_domain_policy( descriptor() ).reset_root(); }
     using iterator = detail::AvlInorderIterator<node_pptr>;
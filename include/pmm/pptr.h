@@ -71,11 +71,11 @@ req: dr-007, qa-port-001, fr-035, if-012
             return false;
         return **this < *other;
     }
-    T&   operator*() const noexcept { return *ManagerT::template resolve_checked<T>( *this ); }
-    T*   operator->() const noexcept { return ManagerT::template resolve_checked<T>( *this ); }
-    T*   resolve() const noexcept { return ManagerT::template resolve_checked<T>( *this ); }
-    T*   resolve_unchecked() const noexcept { return ManagerT::template resolve_unchecked<T>( *this ); }
-    auto try_tree_node() const noexcept { return ManagerT::try_tree_node( *this ); }
-    auto& tree_node_unchecked() const noexcept { return ManagerT::tree_node_unchecked( *this ); }
+    T&               operator*() const noexcept { return *ManagerT::template resolve<T>( *this ); }
+    T*               operator->() const noexcept { return ManagerT::template resolve<T>( *this ); }
+    T*               resolve() const noexcept { return ManagerT::template resolve<T>( *this ); }
+    T*               resolve_unchecked() const noexcept { return ManagerT::template resolve_unchecked<T>( *this ); }
+    auto             try_tree_node() const noexcept { return ManagerT::try_tree_node( *this ); }
+    decltype( auto ) tree_node_unchecked() const noexcept { return ManagerT::tree_node_unchecked( *this ); }
 };
 }
@@ -0,0 +1,156 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#if !defined( _WIN32 ) && !defined( _WIN64 )
+#include <cerrno>
+#include <pthread.h>
+#endif
+namespace pmm
+{
+namespace detail
+{
+template <typename LP> inline constexpr bool lock_is_process_shared_v = false;
+template <typename LP>
+    requires requires { typename LP::area_type; }
+inline constexpr bool lock_is_process_shared_v<LP> = true;
+template <typename LP> inline constexpr size_t lock_policy_reserve_bytes_v = 0;
+template <typename LP>
+    requires requires { typename LP::area_type; }
+inline constexpr size_t lock_policy_reserve_bytes_v<LP> =
+    sizeof( typename LP::area_type ) + alignof( std::max_align_t );
+#if !defined( _WIN32 ) && !defined( _WIN64 )
+/*
+### pmm-detail-processlockarea
+req: qa-thread-001, qa-rec-001
+*/
+struct ProcessLockArea
+{
+    pthread_mutex_t mutex;
+    uint64_t        epoch;
+};
+#endif
+}
+namespace config
+{
+#if !defined( _WIN32 ) && !defined( _WIN64 )
+/*
+### pmm-config-processsharedlock
+req: qa-thread-001, qa-rec-001, sys-003
+*/
+struct ProcessSharedLock
+{
+    using area_type = detail::ProcessLockArea;
+    using hook_type = void ( * )( bool owner_dead ) noexcept;
+    using fail_type = void ( * )( int rc ) noexcept;
+    struct mutex_type
+    {
+        std::mutex       local;
+        area_type*       area       = nullptr;
+        area_type*       held       = nullptr;
+        hook_type        on_acquire = nullptr;
+        fail_type        on_fail    = nullptr;
+        uint64_t         epoch      = 0;
+        bool             shared     = false;
+        static bool      init_area( area_type* a ) noexcept
+        {
+            pthread_mutexattr_t attr;
+            if ( pthread_mutexattr_init( &attr ) != 0 )
+                return false;
+            bool ok = pthread_mutexattr_setpshared( &attr, PTHREAD_PROCESS_SHARED ) == 0 &&
+                      pthread_mutexattr_setrobust( &attr, PTHREAD_MUTEX_ROBUST ) == 0 &&
+                      pthread_mutex_init( &a->mutex, &attr ) == 0;
+            pthread_mutexattr_destroy( &attr );
+            a->epoch = 0;
+            return ok;
+        }
+        bool bind( area_type* a, bool init, hook_type hook, fail_type fail = nullptr ) noexcept
+        {
+            release();
+            unbind();
+            if ( init && !init_area( a ) )
+                return false;
+            area       = a;
+            on_acquire = hook;
+            on_fail    = fail;
+            return acquire( pthread_mutex_lock( &a->mutex ) );
+        }
+        void unbind() noexcept
+        {
+            area       = nullptr;
+            on_acquire = nullptr;
+            on_fail    = nullptr;
+        }
+        bool acquire( int rc ) noexcept
+        {
+            if ( rc != 0 && rc != EOWNERDEAD )
+                return false;
+            held = area;
+            if ( rc == EOWNERDEAD || held->epoch != epoch )
+            {
+                if ( on_acquire != nullptr )
+                    on_acquire( rc == EOWNERDEAD );
+                if ( rc == EOWNERDEAD )
+                {
+                    pthread_mutex_consistent( &held->mutex );
+                    ++held->epoch;
+                }
+                epoch = held->epoch;
+            }
+            return true;
+        }
+        void release() noexcept
+        {
+            if ( held == nullptr )
+                return;
+            if ( !shared )
+                epoch = ++held->epoch;
+            pthread_mutex_unlock( &held->mutex );
+            held = nullptr;
+        }
+        void lock()
+        {
+            local.lock();
+            shared = false;
+            if ( area == nullptr )
+                return;
+            int rc = pthread_mutex_lock( &area->mutex );
+            if ( !acquire( rc ) && on_fail != nullptr )
+                on_fail( rc );
+        }
+        bool try_lock()
+        {
+            if ( !local.try_lock() )
+                return false;
+            shared = false;
+            if ( area == nullptr || acquire( pthread_mutex_trylock( &area->mutex ) ) )
+                return true;
+            local.unlock();
+            return false;
+        }
+        void unlock()
+        {
+            release();
+            local.unlock();
+        }
+        void lock_shared()
+        {
+            lock();
+            shared = true;
+        }
+        bool try_lock_shared()
+        {
+            if ( !try_lock() )
+                return false;
+            shared = true;
+            return true;
+        }
+        void unlock_shared() { unlock(); }
+    };
+    using shared_lock_type = std::shared_lock<mutex_type>;
+    using unique_lock_type = std::unique_lock<mutex_type>;
+};
+#endif
+}
+}
@@ -0,0 +1,309 @@
+#pragma once
+#include "pmm/dirty_tracking.h"
+#include "pmm/forest_registry.h"
+#include "pmm/pptr.h"
+#include "pmm/types.h"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+namespace pmm
+{
+/*
+## pmm-slab_pool_for
+req: feat-002, qa-mem-001
+*/
+template <typename T> struct slab_pool_for
+{
+    static constexpr const char* name = nullptr;
+};
+template <typename T> inline constexpr bool slab_pooled_v = slab_pool_for<T>::name != nullptr;
+namespace detail
+{
+inline constexpr char kSlabDomainPrefix[] = "container/slab/";
+template <typename T> inline bool slab_domain_name( char ( &buf )[kForestDomainNameCapacity] ) noexcept
+{
+    constexpr size_t kPrefixLen = sizeof( kSlabDomainPrefix ) - 1;
+    const size_t     name_len   = std::strlen( slab_pool_for<T>::name );
+    if ( name_len == 0 || kPrefixLen + name_len >= kForestDomainNameCapacity )
+        return false;
+    std::memcpy( buf, kSlabDomainPrefix, kPrefixLen );
+    std::memcpy( buf + kPrefixLen, slab_pool_for<T>::name, name_len + 1 );
+    return true;
+}
+inline constexpr std::uint32_t kSlabChunkMagic = 0x534C4142U;
+template <typename AT> struct alignas( 8 ) SlabChunkHeader
+{
+    typename AT::index_type next_idx;
+    typename AT::index_type prev_idx;
+    typename AT::index_type next_free;
+    typename AT::index_type prev_free;
+    typename AT::index_type pool;
+    std::uint32_t           magic;
+    std::uint32_t           slots;
+    std::uint32_t           used;
+    std::uint32_t           hint;
+};
+template <typename AT> constexpr size_t slab_data_offset( size_t slots ) noexcept
+{
+    size_t bytes = sizeof( SlabChunkHeader<AT> ) + ( slots + 63 ) / 64 * sizeof( std::uint64_t );
+    return ( bytes + AT::granule_size - 1 ) / AT::granule_size * AT::granule_size;
+}
+template <typename AT> constexpr size_t slab_chunk_granules( size_t slot_granules ) noexcept
+{
+    return std::bit_ceil( std::max<size_t>( 512, slab_data_offset<AT>( 64 ) / AT::granule_size + 64 * slot_granules ) );
+}
+template <typename AT> constexpr std::uint32_t slab_chunk_slots( size_t slot_granules ) noexcept
+{
+    const size_t chunk_granules = slab_chunk_granules<AT>( slot_granules );
+    size_t       slots = chunk_granules / slot_granules;
+    while ( slab_data_offset<AT>( slots ) / AT::granule_size + slots * slot_granules > chunk_granules )
+        --slots;
+    return static_cast<std::uint32_t>( slots );
+}
+template <typename ManagerT, typename T> struct SlabPoolLock
+{
+    static inline typename ManagerT::thread_policy::mutex_type mutex;
+};
+}
+/*
+## pmm-pslab
+req: feat-002, feat-003, qa-mem-001
+*/
+template <typename T, typename ManagerT> struct pslab
+{
+    static_assert( std::is_trivially_copyable_v<T>, "" );
+    using manager_type                         = ManagerT;
+    using address_traits                       = typename ManagerT::address_traits;
+    using index_type                           = typename ManagerT::index_type;
+    using value_type                           = T;
+    using slot_pptr                            = pmm::pptr<T, ManagerT>;
+    using chunk_header                         = detail::SlabChunkHeader<address_traits>;
+    static constexpr index_type kNull          = detail::kNullIdx_v<address_traits>;
+    static constexpr size_t     kGranSz        = address_traits::granule_size;
+    static constexpr size_t     kSlotGranules  = ( sizeof( T ) + kGranSz - 1 ) / kGranSz;
+    static constexpr size_t     kChunkGranules = detail::slab_chunk_granules<address_traits>( kSlotGranules );
+    static constexpr uint32_t   kChunkSlots    = detail::slab_chunk_slots<address_traits>( kSlotGranules );
+    static constexpr uint32_t   kChunkWords    = ( kChunkSlots + 63 ) / 64;
+    static constexpr size_t     kDataGranules  = detail::slab_data_offset<address_traits>( kChunkSlots ) / kGranSz;
+    index_type                  _head_idx;
+    index_type                  _free_idx;
+    uint32_t                    _size;
+    uint32_t                    _capacity;
+    pslab() noexcept : _head_idx( kNull ), _free_idx( kNull ), _size( 0 ), _capacity( 0 ) {}
+    ~pslab() noexcept = default;
+    size_t size() const noexcept { return static_cast<size_t>( _size ); }
+    bool   empty() const noexcept { return _size == 0; }
+    size_t capacity() const noexcept { return static_cast<size_t>( _capacity ); }
+/*
+### pmm-pslab-allocate
+req: feat-002, qa-mem-001
+*/
+    slot_pptr allocate() noexcept
+    {
+        pslab*     self = this;
+        index_type idx  = _free_idx;
+        if ( idx == kNull )
+        {
+            idx = add_chunk( self );
+            if ( idx == kNull )
+                return slot_pptr();
+        }
+        chunk_header*  c    = chunk_at( idx );
+        std::uint64_t* bits = bitmap_of( c );
+        for ( uint32_t w = c->hint; w < kChunkWords; ++w )
+        {
+            if ( bits[w] == ~std::uint64_t( 0 ) )
+                continue;
+            uint32_t slot = w * 64 + static_cast<uint32_t>( std::countr_one( bits[w] ) );
+            bits[w] |= std::uint64_t( 1 ) << ( slot % 64 );
+            c->hint = w;
+            c->used++;
+            self->_size++;
+            if ( c->used == c->slots )
+                self->unlink_free( idx, c );
+            slot_pptr p( slot_idx( idx, slot ) );
+            std::memset( p.resolve_unchecked(), 0, kSlotGranules * kGranSz );
+            detail::note_dirty( p.resolve_unchecked(), kSlotGranules * kGranSz );
+            detail::note_dirty( c, data_offset() );
+            detail::note_dirty( self, sizeof( pslab ) );
+            return p;
+        }
+        return slot_pptr();
+    }
+/*
+### pmm-pslab-deallocate
+req: feat-002, qa-mem-001
+*/
+    bool deallocate( slot_pptr p ) noexcept
+    {
+        uint32_t      slot = 0;
+        chunk_header* c    = chunk_of( p, slot );
+        if ( c == nullptr )
+            return false;
+        index_type     idx  = chunk_idx_of( p );
+        std::uint64_t* bits = bitmap_of( c );
+        std::uint64_t  mask = std::uint64_t( 1 ) << ( slot % 64 );
+        if ( ( bits[slot / 64] & mask ) == 0 )
+            return false;
+        bits[slot / 64] &= ~mask;
+        if ( c->used == c->slots )
+            link_free( idx, c );
+        c->used--;
+        _size--;
+        if ( slot / 64 < c->hint )
+            c->hint = slot / 64;
+        detail::note_dirty( c, data_offset() );
+        detail::note_dirty( this, sizeof( pslab ) );
+        if ( c->used == 0 && _capacity > c->slots )
+        {
+            unlink_free( idx, c );
+            unlink_chunk( idx, c );
+            _capacity -= c->slots;
+            c->magic = 0;
+            ManagerT::template deallocate_typed<std::uint8_t>( pmm::pptr<std::uint8_t, ManagerT>( idx ) );
+        }
+        return true;
+    }
+    bool owns( slot_pptr p ) const noexcept
+    {
+        uint32_t            slot = 0;
+        const chunk_header* c    = chunk_of( p, slot );
+        return c != nullptr && ( ( bitmap_of( c )[slot / 64] >> ( slot % 64 ) ) & 1 ) != 0;
+    }
+    bool contains( slot_pptr p ) const noexcept
+    {
+        uint32_t slot = 0;
+        return chunk_of( p, slot ) != nullptr;
+    }
+    T* resolve( slot_pptr p ) const noexcept { return owns( p ) ? p.resolve_unchecked() : nullptr; }
+    void free_all() noexcept
+    {
+        index_type idx = _head_idx;
+        _head_idx      = kNull;
+        _free_idx      = kNull;
+        _size          = 0;
+        _capacity      = 0;
+        detail::note_dirty( this, sizeof( pslab ) );
+        while ( idx != kNull )
+        {
+            chunk_header* c    = chunk_at( idx );
+            index_type    next = c->next_idx;
+            touch( c )->magic  = 0;
+            ManagerT::template deallocate_typed<std::uint8_t>( pmm::pptr<std::uint8_t, ManagerT>( idx ) );
+            idx = next;
+        }
+    }
+
+  private:
+    static constexpr size_t data_offset() noexcept { return kDataGranules * kGranSz; }
+    static chunk_header* chunk_at( index_type idx ) noexcept
+    {
+        return reinterpret_cast<chunk_header*>( pmm::pptr<std::uint8_t, ManagerT>( idx ).resolve_unchecked() );
+    }
+    static std::uint64_t* bitmap_of( const chunk_header* c ) noexcept
+    {
+        return reinterpret_cast<std::uint64_t*>( const_cast<chunk_header*>( c ) + 1 );
+    }
+    static index_type slot_idx( index_type chunk_idx, uint32_t slot ) noexcept
+    {
+        return static_cast<index_type>( chunk_idx + kDataGranules + static_cast<size_t>( slot ) * kSlotGranules );
+    }
+    static index_type chunk_idx_of( slot_pptr p ) noexcept
+    {
+        return static_cast<index_type>( static_cast<size_t>( p.offset() ) & ~( kChunkGranules - 1 ) );
+    }
+    index_type pool_key() const noexcept
+    {
+        const auto self = reinterpret_cast<std::uintptr_t>( this );
+        const auto base = reinterpret_cast<std::uintptr_t>( ManagerT::backend().base_ptr() );
+        if ( self < base || self - base >= ManagerT::backend().total_size() )
+            return kNull;
+        return static_cast<index_type>( ( self - base ) / kGranSz );
+    }
+    chunk_header* chunk_of( slot_pptr p, uint32_t& slot ) const noexcept
+    {
+        const size_t off = static_cast<size_t>( p.offset() );
+        const size_t idx = static_cast<size_t>( chunk_idx_of( p ) );
+        if ( p.is_null() || idx == 0 || off < idx + kDataGranules ||
+             ( idx + kChunkGranules ) * kGranSz > ManagerT::backend().total_size() )
+            return nullptr;
+        if ( ( off - idx - kDataGranules ) % kSlotGranules != 0 )
+            return nullptr;
+        chunk_header* c = chunk_at( static_cast<index_type>( idx ) );
+        if ( c->magic != detail::kSlabChunkMagic || c->pool != pool_key() || c->slots != kChunkSlots )
+            return nullptr;
+        slot = static_cast<uint32_t>( ( off - idx - kDataGranules ) / kSlotGranules );
+        return slot < kChunkSlots ? c : nullptr;
+    }
+    void link_free( index_type idx, chunk_header* c ) noexcept
+    {
+        c->prev_free = kNull;
+        c->next_free = _free_idx;
+        if ( _free_idx != kNull )
+            touch( chunk_at( _free_idx ) )->prev_free = idx;
+        _free_idx = idx;
+    }
+    void unlink_free( index_type idx, chunk_header* c ) noexcept
+    {
+        if ( c->prev_free != kNull )
+            touch( chunk_at( c->prev_free ) )->next_free = c->next_free;
+        else if ( _free_idx == idx )
+            _free_idx = c->next_free;
+        if ( c->next_free != kNull )
+            touch( chunk_at( c->next_free ) )->prev_free = c->prev_free;
+        c->next_free = kNull;
+        c->prev_free = kNull;
+    }
+    void unlink_chunk( index_type idx, chunk_header* c ) noexcept
+    {
+        if ( c->prev_idx != kNull )
+            touch( chunk_at( c->prev_idx ) )->next_idx = c->next_idx;
+        else if ( _head_idx == idx )
+            _head_idx = c->next_idx;
+        if ( c->next_idx != kNull )
+            touch( chunk_at( c->next_idx ) )->prev_idx = c->prev_idx;
+    }
+    static chunk_header* touch( chunk_header* c ) noexcept
+    {
+        detail::note_dirty( c, sizeof( chunk_header ) );
+        return c;
+    }
+    index_type add_chunk( pslab*& self ) noexcept
+    {
+        if ( static_cast<uint64_t>( _capacity ) + kChunkSlots > std::numeric_limits<uint32_t>::max() )
+            return kNull;
+        const auto   self_addr = reinterpret_cast<std::uintptr_t>( this );
+        const auto   old_base  = reinterpret_cast<std::uintptr_t>( ManagerT::backend().base_ptr() );
+        const size_t self_off  = static_cast<size_t>( self_addr - old_base );
+        const bool   in_image  = self_addr >= old_base && self_off < ManagerT::backend().total_size();
+        void*        raw       = ManagerT::allocate_aligned( kChunkGranules * kGranSz, kChunkGranules * kGranSz, true );
+        if ( raw == nullptr )
+            return kNull;
+        if ( in_image )
+            self = reinterpret_cast<pslab*>( ManagerT::backend().base_ptr() + self_off );
+        const size_t     off = static_cast<size_t>( static_cast<uint8_t*>( raw ) - ManagerT::backend().base_ptr() );
+        const index_type idx = static_cast<index_type>( off / kGranSz );
+        chunk_header*    c   = chunk_at( idx );
+        std::memset( c, 0, data_offset() );
+        if ( kChunkSlots % 64 != 0 )
+            bitmap_of( c )[kChunkWords - 1] = ~std::uint64_t( 0 ) << ( kChunkSlots % 64 );
+        c->magic    = detail::kSlabChunkMagic;
+        c->slots    = kChunkSlots;
+        c->pool     = self->pool_key();
+        c->prev_idx = kNull;
+        c->next_idx = self->_head_idx;
+        if ( self->_head_idx != kNull )
+            touch( chunk_at( self->_head_idx ) )->prev_idx = idx;
+        self->_head_idx = idx;
+        self->link_free( idx, c );
+        self->_capacity += kChunkSlots;
+        detail::note_dirty( c, data_offset() );
+        detail::note_dirty( self, sizeof( pslab ) );
+        return idx;
+    }
+};
+}
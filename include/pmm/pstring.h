@@ -1,4 +1,5 @@
 #pragma once
+#include "pmm/dirty_tracking.h"
 #include "pmm/pptr.h"
 #include "pmm/types.h"
 #include <cstddef>
@@ -49,6 +50,7 @@ template <typename ManagerT> struct pstring
             return false;
         std::memcpy( data, s, static_cast<size_t>( len ) + 1 );
         _length = len;
+        mark_dirty( data, static_cast<size_t>( len ) + 1 );
         return true;
     }
     bool append( const char* s ) noexcept
@@ -67,6 +69,7 @@ template <typename ManagerT> struct pstring
         if ( data == nullptr )
             return false;
         std::memcpy( data + _length, s, static_cast<size_t>( add_len ) + 1 );
+        mark_dirty( data + _length, static_cast<size_t>( add_len ) + 1 );
         _length = new_len;
         return true;
     }
@@ -78,6 +81,7 @@ template <typename ManagerT> struct pstring
             char* data = resolve_data();
             if ( data != nullptr )
                 data[0] = '\0';
+            mark_dirty( data, 1 );
         }
     }
     void free_data() noexcept
@@ -89,6 +93,7 @@ template <typename ManagerT> struct pstring
         }
         _length   = 0;
         _capacity = 0;
+        mark_dirty( nullptr, 0 );
     }
     bool operator==( const char* s ) const noexcept
     {
@@ -112,6 +117,11 @@ template <typename ManagerT> struct pstring
 
   private:
     char* resolve_data() const noexcept { return pmm::pptr<char, ManagerT>( _data_idx ).resolve_unchecked(); }
+    void  mark_dirty( const char* first, size_t count ) noexcept
+    {
+        detail::note_dirty( this, sizeof( pstring ) );
+        detail::note_dirty( first, count );
+    }
     bool  ensure_capacity( uint32_t required ) noexcept
     {
         if ( required <= _capacity )
@@ -134,6 +144,7 @@ template <typename ManagerT> struct pstring
         if ( data == nullptr )
             return false;
         data[_length] = '\0';
+        mark_dirty( data + _length, 1 );
         return true;
     }
 };
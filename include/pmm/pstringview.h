@@ -83,7 +83,7 @@ template <typename ManagerT> struct pstringview
     {
         if ( !ManagerT::is_initialized() )
             return;
-        typename ManagerT::thread_policy::unique_lock_type lock( ManagerT::_mutex );
+        typename ManagerT::write_lock_type lock( ManagerT::_mutex );
         forest_domain_ops().reset_root();
     }
     static index_type root_index() noexcept
@@ -101,7 +101,7 @@ template <typename ManagerT> struct pstringview
     {
         if ( !ManagerT::is_initialized() )
             return psview_pptr();
-        typename ManagerT::thread_policy::unique_lock_type lock( ManagerT::_mutex );
+        typename ManagerT::write_lock_type lock( ManagerT::_mutex );
         return ManagerT::intern_symbol_unlocked( s );
     }
 };
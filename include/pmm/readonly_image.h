@@ -0,0 +1,78 @@
+#pragma once
+#include "pmm/block_state.h"
+#include "pmm/diagnostics.h"
+#include "pmm/forest_registry.h"
+#include "pmm/storage_backend.h"
+#include "pmm/types.h"
+#include <atomic>
+#include <cstdint>
+namespace pmm::detail
+{
+template <typename ManagerT>
+/*
+### pmm-detail-readonlyimageops
+req: fr-004, qa-thread-002
+*/
+struct ReadonlyImageOps
+{
+    using address_traits  = typename ManagerT::address_traits;
+    using storage_backend = typename ManagerT::storage_backend;
+    using logging_policy  = typename ManagerT::logging_policy;
+    static PmmError header_error( const uint8_t* base ) noexcept
+    {
+        const ManagerHeader<address_traits>* hdr = ManagerT::get_header_c( base );
+        if ( hdr->magic != kMagic )
+            return PmmError::InvalidMagic;
+        if ( hdr->image_version != kCurrentImageVersion )
+            return PmmError::UnsupportedImageVersion;
+        if ( hdr->total_size > ManagerT::_backend.total_size() )
+            return PmmError::SizeMismatch;
+        if ( hdr->granule_size != static_cast<uint16_t>( address_traits::granule_size ) )
+            return PmmError::GranuleMismatch;
+        if ( ManagerT::kMgrHdrReserveBytes != 0 &&
+             BlockStateBase<address_traits>::get_weight( base ) != ManagerT::kMgrHdrGranules )
+            return PmmError::UnsupportedImageVersion;
+        if constexpr ( ManagerT::kArenaMode )
+        {
+            if ( !ManagerT::arena_ops::layout_valid( base ) )
+                return PmmError::UnsupportedImageVersion;
+        }
+        return PmmError::Ok;
+    }
+    static bool attach( VerifyResult& result ) noexcept
+    {
+        result.mode = RecoveryMode::Verify;
+        result.ok   = true;
+        typename ManagerT::write_lock_type lock( ManagerT::_mutex );
+        if constexpr ( ManagerT::kThreadCacheEnabled )
+            ManagerT::thread_cache_ops::discard_unlocked();
+        auto& backend          = ManagerT::_backend;
+        ManagerT::_initialized = false;
+        bool mapped            = backend.base_ptr() != nullptr;
+        if constexpr ( RefreshableStorage<storage_backend> )
+            mapped = mapped && backend.refresh();
+        PmmError err = ( !mapped || backend.total_size() < kMinMemorySize ) ? PmmError::BackendError
+                                                                             : header_error( backend.base_ptr() );
+        if ( err != PmmError::Ok )
+        {
+            ManagerT::_last_error = err;
+            logging_policy::on_corruption_detected( err );
+            result.add( ViolationType::HeaderCorruption, DiagnosticAction::Aborted );
+            return false;
+        }
+        ManagerT::_readonly    = true;
+        ManagerT::_initialized = true;
+        ManagerT::heap_stats::stale.store( true, std::memory_order_relaxed );
+        if ( ManagerT::find_domain_by_name_unlocked( kServiceNameDomainRoot ) == nullptr )
+        {
+            ManagerT::_initialized = false;
+            ManagerT::_last_error  = PmmError::BackendError;
+            result.add( ViolationType::ForestRegistryMissing, DiagnosticAction::Aborted );
+            return false;
+        }
+        ManagerT::_last_error = PmmError::Ok;
+        logging_policy::on_load();
+        return true;
+    }
+};
+}
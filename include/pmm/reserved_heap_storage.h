@@ -0,0 +1,255 @@
+#pragma once
+#include "pmm/address_traits.h"
+#include "pmm/arena_internals.h"
+#include "pmm/storage_backend.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#if defined( _WIN32 ) || defined( _WIN64 )
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+namespace pmm
+{
+namespace detail
+{
+inline size_t os_page_size() noexcept
+{
+#if defined( _WIN32 ) || defined( _WIN64 )
+    SYSTEM_INFO info{};
+    GetSystemInfo( &info );
+    return static_cast<size_t>( info.dwPageSize );
+#else
+    long page = ::sysconf( _SC_PAGESIZE );
+    return page > 0 ? static_cast<size_t>( page ) : 4096;
+#endif
+}
+inline void* reserve_address_range( size_t bytes ) noexcept
+{
+#if defined( _WIN32 ) || defined( _WIN64 )
+    return VirtualAlloc( nullptr, bytes, MEM_RESERVE, PAGE_NOACCESS );
+#else
+    void* p = ::mmap( nullptr, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+    return p == MAP_FAILED ? nullptr : p;
+#endif
+}
+inline bool commit_address_range( void* p, size_t bytes ) noexcept
+{
+#if defined( _WIN32 ) || defined( _WIN64 )
+    return VirtualAlloc( p, bytes, MEM_COMMIT, PAGE_READWRITE ) != nullptr;
+#else
+    return ::mprotect( p, bytes, PROT_READ | PROT_WRITE ) == 0;
+#endif
+}
+inline bool decommit_address_range( void* p, size_t bytes ) noexcept
+{
+#if defined( _WIN32 ) || defined( _WIN64 )
+    return VirtualFree( p, bytes, MEM_DECOMMIT ) != 0;
+#else
+    return ::mmap( p, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0 ) != MAP_FAILED;
+#endif
+}
+inline void release_address_range( void* p, size_t bytes ) noexcept
+{
+#if defined( _WIN32 ) || defined( _WIN64 )
+    (void)bytes;
+    VirtualFree( p, 0, MEM_RELEASE );
+#else
+    ::munmap( p, bytes );
+#endif
+}
+template <typename AT> constexpr size_t reservation_limit( size_t reserve_gb ) noexcept
+{
+    constexpr uint64_t kAddressable =
+        ( static_cast<uint64_t>( std::numeric_limits<typename AT::index_type>::max() ) + 1 ) * AT::granule_size;
+    constexpr uint64_t kPlatform = ( sizeof( size_t ) >= 8 ) ? ( uint64_t( 1 ) << 40 ) : ( uint64_t( 1 ) << 30 );
+    uint64_t           limit     = ( reserve_gb == 0 ) ? kPlatform : static_cast<uint64_t>( reserve_gb ) << 30;
+    limit                        = ( limit > kPlatform ) ? kPlatform : limit;
+    limit                        = ( kAddressable != 0 && kAddressable < limit ) ? kAddressable : limit;
+    return static_cast<size_t>( limit );
+}
+inline constexpr size_t kHugePageSize = size_t( 2 ) * 1024 * 1024;
+inline uint8_t* reserve_aligned_address_range( size_t bytes, size_t align ) noexcept
+{
+#if defined( _WIN32 ) || defined( _WIN64 )
+    (void)align;
+    return static_cast<uint8_t*>( reserve_address_range( bytes ) );
+#else
+    if ( align <= os_page_size() )
+        return static_cast<uint8_t*>( reserve_address_range( bytes ) );
+    if ( bytes > std::numeric_limits<size_t>::max() - align )
+        return nullptr;
+    auto* raw = static_cast<uint8_t*>( reserve_address_range( bytes + align ) );
+    if ( raw == nullptr )
+        return nullptr;
+    uintptr_t addr = reinterpret_cast<uintptr_t>( raw );
+    uint8_t*  p    = raw + ( ( addr + align - 1 ) / align * align - addr );
+    if ( p != raw )
+        ::munmap( raw, static_cast<size_t>( p - raw ) );
+    if ( p + bytes != raw + bytes + align )
+        ::munmap( p + bytes, static_cast<size_t>( raw + bytes + align - ( p + bytes ) ) );
+    return p;
+#endif
+}
+inline uint8_t* reserve_address_range_upto( size_t max_bytes, size_t min_bytes, size_t page, size_t& reserved,
+                                            size_t align = 0 ) noexcept
+{
+    for ( size_t bytes = max_bytes; bytes >= min_bytes && bytes != 0; bytes /= 2 )
+    {
+        auto rounded = round_up_checked( bytes, page );
+        if ( !rounded.has_value() )
+            continue;
+        if ( uint8_t* p = reserve_aligned_address_range( *rounded, align ); p != nullptr )
+        {
+            reserved = *rounded;
+            return p;
+        }
+    }
+    return nullptr;
+}
+/*
+### pmm-detail-advise_huge_pages
+*/
+inline void advise_huge_pages( void* p, size_t bytes ) noexcept
+{
+#if defined( MADV_HUGEPAGE )
+    if ( p != nullptr && bytes != 0 )
+        ::madvise( p, bytes, MADV_HUGEPAGE );
+#else
+    (void)p;
+    (void)bytes;
+#endif
+}
+inline size_t huge_page_resident_bytes( const void* p, size_t bytes ) noexcept
+{
+    size_t total = 0;
+#if defined( __linux__ )
+    if ( p == nullptr || bytes == 0 )
+        return 0;
+    std::FILE* f = std::fopen( "/proc/self/smaps", "r" );
+    if ( f == nullptr )
+        return 0;
+    const uintptr_t lo      = reinterpret_cast<uintptr_t>( p );
+    const uintptr_t hi      = lo + bytes;
+    size_t          overlap = 0;
+    char            line[256];
+    while ( std::fgets( line, sizeof( line ), f ) != nullptr )
+    {
+        unsigned long start = 0, end = 0, kb = 0;
+        char          key[64];
+        if ( std::sscanf( line, "%lx-%lx ", &start, &end ) == 2 )
+            overlap = ( start < hi && end > lo ) ? ( end < hi ? end : hi ) - ( start > lo ? start : lo ) : 0;
+        else if ( overlap != 0 && std::sscanf( line, "%63[^:]: %lu kB", key, &kb ) == 2 &&
+                  ( std::strcmp( key, "AnonHugePages" ) == 0 || std::strcmp( key, "ShmemPmdMapped" ) == 0 ||
+                    std::strcmp( key, "FilePmdMapped" ) == 0 || std::strcmp( key, "Shared_Hugetlb" ) == 0 ||
+                    std::strcmp( key, "Private_Hugetlb" ) == 0 ) )
+            total += ( static_cast<size_t>( kb ) * 1024 < overlap ) ? static_cast<size_t>( kb ) * 1024 : overlap;
+    }
+    std::fclose( f );
+#else
+    (void)p;
+    (void)bytes;
+#endif
+    return total;
+}
+}
+/*
+## pmm-reservedheapstorage
+req: feat-001, fr-001, fr-026, qa-mem-001, qa-perf-001, feat-006, sys-003
+*/
+template <typename AT = DefaultAddressTraits, size_t ReserveGB = 64, bool HugePages = false> class ReservedHeapStorage
+{
+  public:
+    using address_traits                                         = AT;
+    static constexpr bool kStableBase                            = true;
+    static constexpr bool kHugePages                             = HugePages;
+    ReservedHeapStorage() noexcept                               = default;
+    ReservedHeapStorage( const ReservedHeapStorage& )            = delete;
+    ReservedHeapStorage& operator=( const ReservedHeapStorage& ) = delete;
+    explicit ReservedHeapStorage( size_t initial_size ) noexcept
+    {
+        auto rounded = detail::round_up_checked( initial_size, AT::granule_size );
+        if ( initial_size != 0 && rounded.has_value() )
+            resize_to( *rounded );
+    }
+    ~ReservedHeapStorage()
+    {
+        if ( _base != nullptr )
+            detail::release_address_range( _base, _reserved );
+    }
+    uint8_t*       base_ptr() noexcept { return _base; }
+    const uint8_t* base_ptr() const noexcept { return _base; }
+    size_t         total_size() const noexcept { return _size; }
+    size_t         reserved_size() const noexcept { return _reserved; }
+    size_t         committed_size() const noexcept { return _committed; }
+    size_t         huge_page_bytes() const noexcept { return detail::huge_page_resident_bytes( _base, _committed ); }
+/*
+### pmm-reservedheapstorage-resize_to
+*/
+    bool resize_to( size_t new_total_size ) noexcept
+    {
+        if ( new_total_size == 0 || new_total_size % AT::granule_size != 0 || new_total_size <= _size )
+            return false;
+        if ( _base == nullptr && !reserve( new_total_size ) )
+            return false;
+        if ( new_total_size > _reserved )
+            return false;
+        auto commit_to = detail::round_up_checked( new_total_size, _page );
+        if ( !commit_to.has_value() )
+            return false;
+        size_t target = ( *commit_to > _reserved ) ? _reserved : *commit_to;
+        if ( target > _committed )
+        {
+            if ( !detail::commit_address_range( _base + _committed, target - _committed ) )
+                return false;
+            if constexpr ( HugePages )
+                detail::advise_huge_pages( _base + _committed, target - _committed );
+            _committed = target;
+        }
+        _size = new_total_size;
+        return true;
+    }
+    bool shrink_to( size_t new_total_size ) noexcept
+    {
+        if ( _base == nullptr || new_total_size == 0 || new_total_size % AT::granule_size != 0 ||
+             new_total_size >= _size )
+            return false;
+        auto keep = detail::round_up_checked( new_total_size, _page );
+        if ( keep.has_value() && *keep < _committed &&
+             detail::decommit_address_range( _base + *keep, _committed - *keep ) )
+            _committed = *keep;
+        _size = new_total_size;
+        return true;
+    }
+    bool owns_memory() const noexcept { return _base != nullptr; }
+
+  private:
+    bool reserve( size_t min_bytes ) noexcept
+    {
+        _page = HugePages ? detail::kHugePageSize : detail::os_page_size();
+        _base = detail::reserve_address_range_upto( detail::reservation_limit<AT>( ReserveGB ), min_bytes, _page,
+                                                    _reserved, _page );
+        return _base != nullptr;
+    }
+    uint8_t* _base      = nullptr;
+    size_t   _size      = 0;
+    size_t   _committed = 0;
+    size_t   _reserved  = 0;
+    size_t   _page      = 4096;
+};
+static_assert( is_storage_backend_v<ReservedHeapStorage<>>, "" );
+template <typename AT, size_t G, bool H> struct detail::with_huge_pages<ReservedHeapStorage<AT, G, H>>
+{
+    using type = ReservedHeapStorage<AT, G, true>;
+};
+}
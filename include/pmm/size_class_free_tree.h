@@ -0,0 +1,200 @@
+#pragma once
+#include "pmm/arena_internals.h"
+#include "pmm/diagnostics.h"
+#include "pmm/free_block_tree.h"
+#include "pmm/types.h"
+#include "pmm/validation.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+namespace pmm
+{
+template <typename AT = DefaultAddressTraits, size_t MaxClassBytes = 256>
+/*
+## pmm-sizeclassfreetree
+req: feat-002, fr-004, fr-013, qa-perf-001
+*/
+struct SizeClassFreeTree
+{
+    using address_traits                           = AT;
+    using index_type                               = typename AT::index_type;
+    using BlockState                               = BlockStateBase<AT>;
+    using Tree                                     = AvlFreeTree<AT>;
+    static constexpr const char* kForestDomainName = Tree::kForestDomainName;
+    static constexpr index_type  kBlkHdrGran       = detail::kBlockHeaderGranules_t<AT>;
+    static constexpr size_t      kClassCount       = MaxClassBytes / AT::granule_size;
+    static_assert( kClassCount >= 1 && kClassCount <= 64, "" );
+    struct Table
+    {
+        uint64_t   nonempty;
+        index_type heads[kClassCount];
+    };
+    static constexpr size_t kImageReserveBytes         = sizeof( Table );
+    SizeClassFreeTree()                                = delete;
+    SizeClassFreeTree( const SizeClassFreeTree& )      = delete;
+    SizeClassFreeTree& operator=( const SizeClassFreeTree& ) = delete;
+    static constexpr bool tree_holds( index_type total_gran ) noexcept
+    {
+        return total_gran <= kBlkHdrGran || total_gran - kBlkHdrGran > kClassCount;
+    }
+    static void reset( uint8_t* base, detail::ManagerHeader<AT>* hdr ) noexcept
+    {
+        (void)base;
+        Table* t    = table_of( hdr );
+        t->nonempty = 0;
+        for ( size_t c = 0; c < kClassCount; ++c )
+            t->heads[c] = AT::no_block;
+    }
+    static void insert( uint8_t* base, detail::ManagerHeader<AT>* hdr, index_type blk_idx )
+    {
+        void*      blk = detail::block_at<AT>( base, blk_idx );
+        index_type w   = BlockState::get_weight( blk );
+        if ( tree_holds( w ) )
+        {
+            Tree::insert( base, hdr, blk_idx );
+            return;
+        }
+        Table*     t    = table_of( hdr );
+        size_t     cls  = class_of( w );
+        index_type head = t->heads[cls];
+        BlockState::set_left_offset_of( blk, AT::no_block );
+        BlockState::set_right_offset_of( blk, head );
+        BlockState::set_parent_offset_of( blk, AT::no_block );
+        BlockState::set_avl_height_of( blk, 0 );
+        if ( head != AT::no_block )
+            BlockState::set_left_offset_of( detail::block_at<AT>( base, head ), blk_idx );
+        t->heads[cls] = blk_idx;
+        t->nonempty |= uint64_t{ 1 } << cls;
+    }
+    static void remove( uint8_t* base, detail::ManagerHeader<AT>* hdr, index_type blk_idx )
+    {
+        void*      blk = detail::block_at<AT>( base, blk_idx );
+        index_type w   = BlockState::get_weight( blk );
+        if ( tree_holds( w ) )
+        {
+            Tree::remove( base, hdr, blk_idx );
+            return;
+        }
+        Table*     t    = table_of( hdr );
+        size_t     cls  = class_of( w );
+        index_type prev = BlockState::get_left_offset( blk );
+        index_type next = BlockState::get_right_offset( blk );
+        if ( prev != AT::no_block )
+            BlockState::set_right_offset_of( detail::block_at<AT>( base, prev ), next );
+        else
+            t->heads[cls] = next;
+        if ( next != AT::no_block )
+            BlockState::set_left_offset_of( detail::block_at<AT>( base, next ), prev );
+        if ( t->heads[cls] == AT::no_block )
+            t->nonempty &= ~( uint64_t{ 1 } << cls );
+        BlockState::reset_avl_fields_of( blk );
+    }
+/*
+### pmm-sizeclassfreetree-find_best_fit
+*/
+    static index_type find_best_fit( uint8_t* base, detail::ManagerHeader<AT>* hdr, index_type needed_granules )
+    {
+        if ( !tree_holds( needed_granules ) )
+        {
+            const Table* t    = table_of( hdr );
+            size_t       cls  = class_of( needed_granules );
+            uint64_t     mask = t->nonempty >> cls;
+            if ( mask != 0 )
+                return t->heads[cls + static_cast<size_t>( std::countr_zero( mask ) )];
+        }
+        return Tree::find_best_fit( base, hdr, needed_granules );
+    }
+    static index_type largest_free( const uint8_t* base, const detail::ManagerHeader<AT>* hdr ) noexcept
+    {
+        index_type   w = Tree::largest_free( base, hdr );
+        const Table* t = table_of( hdr );
+        if ( t->nonempty == 0 )
+            return w;
+        index_type listed = static_cast<index_type>( std::bit_width( t->nonempty ) + kBlkHdrGran );
+        return ( listed > w ) ? listed : w;
+    }
+    template <typename Fn>
+    static void for_each_listed( const uint8_t* base, const detail::ManagerHeader<AT>* hdr, Fn&& fn ) noexcept
+    {
+        const Table* t     = table_of( hdr );
+        size_t       limit = static_cast<size_t>( hdr->free_count );
+        for ( size_t c = 0; c < kClassCount; ++c )
+        {
+            for ( index_type idx = t->heads[c]; idx != AT::no_block && limit > 0; --limit )
+            {
+                if ( !detail::validate_block_index<AT>( hdr->total_size, idx ) )
+                    break;
+                fn( idx );
+                idx = BlockState::get_right_offset( detail::block_at<AT>( base, idx ) );
+            }
+        }
+    }
+    static void verify_lists( detail::ConstArenaView<AT> arena, VerifyResult& result ) noexcept
+    {
+        const uint8_t*                   base     = arena.base();
+        const detail::ManagerHeader<AT>* hdr      = arena.header();
+        const Table*                     t        = table_of( hdr );
+        size_t                           expected = 0;
+        (void)detail::for_each_physical_block<AT>( arena,
+                                                   [&]( index_type, const void* blk ) noexcept
+                                                   {
+                                                       if ( pmm::is_free( BlockState::get_node_type( blk ) ) &&
+                                                            !tree_holds( BlockState::get_weight( blk ) ) )
+                                                           ++expected;
+                                                       return true;
+                                                   } );
+        size_t listed = 0;
+        for ( size_t c = 0; c < kClassCount; ++c )
+        {
+            bool flagged = ( t->nonempty >> c ) & 1U;
+            if ( flagged != ( t->heads[c] != AT::no_block ) )
+            {
+                result.add( ViolationType::FreeTreeStale, DiagnosticAction::NoAction,
+                            static_cast<uint64_t>( t->heads[c] ), static_cast<uint64_t>( flagged ), 0 );
+            }
+            index_type prev = AT::no_block;
+            for ( index_type idx = t->heads[c]; idx != AT::no_block; )
+            {
+                if ( listed >= expected || !detail::validate_block_index<AT>( hdr->total_size, idx ) )
+                {
+                    result.add( ViolationType::FreeTreeStale, DiagnosticAction::NoAction, static_cast<uint64_t>( idx ),
+                                static_cast<uint64_t>( expected ), static_cast<uint64_t>( listed ) );
+                    break;
+                }
+                const void* node = detail::block_at<AT>( base, idx );
+                index_type  w    = static_cast<index_type>( kBlkHdrGran + c + 1 );
+                if ( !pmm::is_free( BlockState::get_node_type( node ) ) || BlockState::get_weight( node ) != w ||
+                     BlockState::get_left_offset( node ) != prev )
+                {
+                    result.add( ViolationType::FreeTreeStale, DiagnosticAction::NoAction, static_cast<uint64_t>( idx ),
+                                static_cast<uint64_t>( w ), static_cast<uint64_t>( BlockState::get_weight( node ) ) );
+                    break;
+                }
+                ++listed;
+                prev = idx;
+                idx  = BlockState::get_right_offset( node );
+            }
+        }
+        if ( listed != expected )
+        {
+            result.add( ViolationType::FreeTreeStale, DiagnosticAction::NoAction, 0, static_cast<uint64_t>( expected ),
+                        static_cast<uint64_t>( listed ) );
+        }
+    }
+
+  private:
+    static constexpr size_t class_of( index_type total_gran ) noexcept
+    {
+        return static_cast<size_t>( total_gran - kBlkHdrGran - 1 );
+    }
+    static Table* table_of( detail::ManagerHeader<AT>* hdr ) noexcept
+    {
+        return reinterpret_cast<Table*>( detail::manager_header_reserve_at<AT>( hdr ) );
+    }
+    static const Table* table_of( const detail::ManagerHeader<AT>* hdr ) noexcept
+    {
+        return reinterpret_cast<const Table*>( detail::manager_header_reserve_at<AT>( hdr ) );
+    }
+};
+static_assert( FreeBlockTreePolicyForTraitsConcept<SizeClassFreeTree<DefaultAddressTraits>, DefaultAddressTraits>, "" );
+}
@@ -16,6 +16,7 @@ template <size_t Size, typename AT = DefaultAddressTraits> class StaticStorage
 
   public:
     using address_traits                             = AT;
+    static constexpr bool kStableBase                = true;
     StaticStorage() noexcept                         = default;
     StaticStorage( const StaticStorage& )            = delete;
     StaticStorage& operator=( const StaticStorage& ) = delete;
@@ -1,4 +1,5 @@
 #pragma once
+#include "pmm/dirty_tracking.h"
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
@@ -15,4 +16,35 @@ concept StorageBackendConcept = requires( Backend& b, const Backend& cb, size_t
     { cb.owns_memory() } -> std::convertible_to<bool>;
 };
 template <typename Backend> inline constexpr bool is_storage_backend_v = StorageBackendConcept<Backend>;
+template <typename Backend>
+concept StableBaseStorage = requires { requires Backend::kStableBase; };
+template <typename Backend> inline constexpr bool storage_has_stable_base_v = StableBaseStorage<Backend>;
+template <typename Backend>
+concept HugePageStorage = requires( const Backend& cb ) {
+    requires Backend::kHugePages;
+    { cb.huge_page_bytes() } -> std::convertible_to<size_t>;
+};
+template <typename Backend> inline constexpr bool storage_uses_huge_pages_v = HugePageStorage<Backend>;
+template <typename Backend>
+concept DirtyTrackingStorage = requires( Backend& b, size_t n ) {
+    b.mark_dirty( n, n );
+    { b.flush( FlushMode::Sync ) } -> std::convertible_to<bool>;
+};
+template <typename Backend> inline constexpr bool storage_tracks_dirty_v = DirtyTrackingStorage<Backend>;
+template <typename Backend>
+concept RefreshableStorage = requires( Backend& b, const Backend& cb ) {
+    { b.refresh() } -> std::convertible_to<bool>;
+    { cb.is_readonly() } -> std::convertible_to<bool>;
+};
+namespace detail
+{
+template <typename Backend> struct with_huge_pages;
+template <typename Backend> bool storage_is_readonly( const Backend& b ) noexcept
+{
+    if constexpr ( RefreshableStorage<Backend> )
+        return b.is_readonly();
+    else
+        return false;
+}
+}
 }
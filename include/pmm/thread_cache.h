@@ -0,0 +1,211 @@
+#pragma once
+#include "pmm/block.h"
+#include "pmm/block_state.h"
+#include "pmm/types.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+namespace pmm::detail
+{
+template <typename ManagerT>
+/*
+### pmm-detail-threadcacheops
+req: qa-thread-001, qa-perf-001
+*/
+struct ThreadCacheOps
+{
+    using address_traits = typename ManagerT::address_traits;
+    using index_type     = typename address_traits::index_type;
+    using thread_policy  = typename ManagerT::thread_policy;
+    using policy         = typename ManagerT::thread_cache;
+    using BlockState     = BlockStateBase<address_traits>;
+    static constexpr size_t       kClasses      = ManagerT::kThreadCacheClasses;
+    static constexpr std::uint8_t kCachedHeight = 0xFF;
+    struct Slot
+    {
+        static constexpr size_t kSlotClasses  = kClasses > 0 ? kClasses : 1;
+        static constexpr size_t kSlotCapacity = policy::capacity > 0 ? policy::capacity : 1;
+        index_type              entries[kSlotClasses][kSlotCapacity];
+        size_t                  counts[kSlotClasses]{};
+        Slot*                   prev   = nullptr;
+        Slot*                   next   = nullptr;
+        bool                    linked = false;
+        ~Slot()
+        {
+            if ( linked )
+                retire( *this );
+        }
+    };
+    static inline Slot* _head = nullptr;
+    static Slot&        slot() noexcept
+    {
+        static thread_local Slot tc;
+        return tc;
+    }
+    static void flush_unlocked() noexcept
+    {
+        for ( Slot* tc = _head; tc != nullptr; tc = tc->next )
+        {
+            for ( size_t cls = 0; cls < kClasses; ++cls )
+            {
+                if ( ManagerT::_initialized )
+                    drain_unlocked( *tc, cls, tc->counts[cls] );
+                tc->counts[cls] = 0;
+            }
+        }
+    }
+    static void discard_unlocked() noexcept
+    {
+        for ( Slot* tc = _head; tc != nullptr; tc = tc->next )
+        {
+            for ( size_t cls = 0; cls < kClasses; ++cls )
+                tc->counts[cls] = 0;
+        }
+    }
+    template <typename Fn> static auto allocate( size_t cls, size_t user_size, Fn& finish ) noexcept
+    {
+        Slot& tc = slot();
+        {
+            typename thread_policy::shared_lock_type lock( ManagerT::_mutex );
+            if ( ManagerT::_initialized && tc.counts[cls] > 0 )
+            {
+                ManagerT::_last_error = PmmError::Ok;
+                return finish( pop( tc, cls ) );
+            }
+        }
+        typename ManagerT::write_lock_type lock( ManagerT::_mutex );
+        return finish( refill_unlocked( tc, cls, user_size ) );
+    }
+    static size_t push( void* ptr ) noexcept
+    {
+        if ( ptr == nullptr )
+            return 0;
+        Slot& tc = slot();
+        {
+            typename thread_policy::shared_lock_type lock( ManagerT::_mutex );
+            if ( !ManagerT::writable_unlocked() )
+                return 0;
+            const pmm::Block<address_traits>* blk = ManagerT::find_block_from_user_ptr( ptr );
+            size_t                            cls = class_of( blk );
+            if ( cls >= kClasses )
+                return 0;
+            if ( tc.linked && tc.counts[cls] < policy::capacity )
+            {
+                if ( !claim( blk ) )
+                    return 0;
+                tc.entries[cls][tc.counts[cls]++] = block_idx_t<address_traits>( ManagerT::_backend.base_ptr(), blk );
+                return ManagerT::note_deallocate_unlocked( ptr, ManagerT::granted_bytes_unlocked( ptr ) );
+            }
+        }
+        typename ManagerT::write_lock_type lock( ManagerT::_mutex );
+        const pmm::Block<address_traits>*  blk =
+            ManagerT::writable_unlocked() ? ManagerT::find_block_from_user_ptr( ptr ) : nullptr;
+        size_t cls = class_of( blk );
+        if ( cls >= kClasses || !claim( blk ) )
+            return ManagerT::note_deallocate_unlocked( ptr, ManagerT::deallocate_unlocked( ptr ) );
+        link_unlocked( tc );
+        if ( tc.counts[cls] >= policy::capacity )
+            drain_unlocked( tc, cls, policy::batch );
+        tc.entries[cls][tc.counts[cls]++] = block_idx_t<address_traits>( ManagerT::_backend.base_ptr(), blk );
+        return ManagerT::note_deallocate_unlocked( ptr, ManagerT::granted_bytes_unlocked( ptr ) );
+    }
+    static bool cached( const void* blk ) noexcept
+    {
+        return height_of( blk ).load( std::memory_order_relaxed ) == kCachedHeight;
+    }
+
+  private:
+    static std::atomic_ref<std::uint8_t> height_of( const void* blk ) noexcept
+    {
+        return std::atomic_ref<std::uint8_t>( const_cast<std::uint8_t&>( BlockState::header_of( blk )->avl_height ) );
+    }
+    static bool claim( const void* blk ) noexcept
+    {
+        std::uint8_t expected = 0;
+        return height_of( blk ).compare_exchange_strong( expected, kCachedHeight, std::memory_order_relaxed );
+    }
+    static void link_unlocked( Slot& tc ) noexcept
+    {
+        if ( tc.linked )
+            return;
+        tc.prev = nullptr;
+        tc.next = _head;
+        if ( _head != nullptr )
+            _head->prev = &tc;
+        _head     = &tc;
+        tc.linked = true;
+    }
+    static void drain_unlocked( Slot& tc, size_t cls, size_t n ) noexcept
+    {
+        uint8_t* base = ManagerT::_backend.base_ptr();
+        n             = ( n < tc.counts[cls] ) ? n : tc.counts[cls];
+        for ( size_t i = 0; i < n; ++i )
+        {
+            auto* blk = block_at<address_traits>( base, tc.entries[cls][i] );
+            height_of( blk ).store( 0, std::memory_order_relaxed );
+            ManagerT::deallocate_unlocked( user_ptr<address_traits>( blk ) );
+        }
+        tc.counts[cls] -= n;
+        std::memmove( tc.entries[cls], tc.entries[cls] + n, tc.counts[cls] * sizeof( index_type ) );
+    }
+    static void retire( Slot& tc ) noexcept
+    {
+        typename ManagerT::write_lock_type lock( ManagerT::_mutex );
+        for ( size_t cls = 0; cls < kClasses; ++cls )
+        {
+            if ( ManagerT::_initialized )
+                drain_unlocked( tc, cls, tc.counts[cls] );
+            tc.counts[cls] = 0;
+        }
+        if ( tc.prev != nullptr )
+            tc.prev->next = tc.next;
+        else
+            _head = tc.next;
+        if ( tc.next != nullptr )
+            tc.next->prev = tc.prev;
+        tc.linked = false;
+    }
+    static size_t class_of( const pmm::Block<address_traits>* blk ) noexcept
+    {
+        if ( blk == nullptr || BlockState::get_node_type( blk ) != pmm::NodeType::Generic )
+            return kClasses;
+        index_type w = BlockState::get_weight( blk );
+        if ( w == 0 || w > kClasses || height_of( blk ).load( std::memory_order_relaxed ) != 0 )
+            return kClasses;
+        if constexpr ( !BlockState::kCompactHeader )
+        {
+            if ( BlockState::get_left_offset( blk ) != address_traits::no_block ||
+                 BlockState::get_right_offset( blk ) != address_traits::no_block ||
+                 BlockState::get_parent_offset( blk ) != address_traits::no_block )
+                return kClasses;
+        }
+        return static_cast<size_t>( w - 1 );
+    }
+    static void* pop( Slot& tc, size_t cls ) noexcept
+    {
+        index_type idx = tc.entries[cls][--tc.counts[cls]];
+        auto*      blk = block_at<address_traits>( ManagerT::_backend.base_ptr(), idx );
+        height_of( blk ).store( 0, std::memory_order_relaxed );
+        return user_ptr<address_traits>( blk );
+    }
+    static void* refill_unlocked( Slot& tc, size_t cls, size_t user_size ) noexcept
+    {
+        void* raw = ManagerT::allocate_unlocked( user_size );
+        if ( raw == nullptr )
+            return nullptr;
+        link_unlocked( tc );
+        index_type data_gran = static_cast<index_type>( cls + 1 );
+        for ( size_t i = 1; i < policy::batch && tc.counts[cls] < policy::capacity; ++i )
+        {
+            void* extra = ManagerT::allocate_fit_unlocked( data_gran );
+            if ( extra == nullptr )
+                break;
+            const pmm::Block<address_traits>* blk = ManagerT::find_block_from_user_ptr( extra );
+            claim( blk );
+            tc.entries[cls][tc.counts[cls]++] = block_idx_t<address_traits>( ManagerT::_backend.base_ptr(), blk );
+        }
+        return raw;
+    }
+};
+}
@@ -0,0 +1,250 @@
+#pragma once
+#include "pmm/arena_internals.h"
+#include "pmm/diagnostics.h"
+#include "pmm/free_block_tree.h"
+#include "pmm/types.h"
+#include "pmm/validation.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+namespace pmm
+{
+template <typename AT = DefaultAddressTraits, unsigned SecondLevelBits = 4>
+/*
+## pmm-tlsffreetree
+req: feat-002, fr-004, fr-013, qa-perf-001
+*/
+struct TlsfFreeTree
+{
+    using address_traits                           = AT;
+    using index_type                               = typename AT::index_type;
+    using BlockState                               = BlockStateBase<AT>;
+    static constexpr const char* kForestDomainName = AvlFreeTree<AT>::kForestDomainName;
+    static constexpr unsigned    kSlBits           = SecondLevelBits;
+    static constexpr size_t      kSlCount          = size_t{ 1 } << kSlBits;
+    static constexpr size_t      kFlCount          = sizeof( index_type ) * 8 - kSlBits + 1;
+    static_assert( kSlBits >= 1 && kSlBits <= 5 && kFlCount <= 64, "" );
+    struct Table
+    {
+        uint64_t   fl_bitmap;
+        uint32_t   sl_bitmap[kFlCount];
+        index_type heads[kFlCount][kSlCount];
+    };
+    static constexpr size_t kImageReserveBytes     = sizeof( Table );
+    TlsfFreeTree()                                 = delete;
+    TlsfFreeTree( const TlsfFreeTree& )            = delete;
+    TlsfFreeTree& operator=( const TlsfFreeTree& ) = delete;
+    static constexpr bool tree_holds( index_type ) noexcept { return false; }
+    static void           reset( uint8_t* base, detail::ManagerHeader<AT>* hdr ) noexcept
+    {
+        (void)base;
+        Table* t     = table_of( hdr );
+        t->fl_bitmap = 0;
+        for ( size_t f = 0; f < kFlCount; ++f )
+        {
+            t->sl_bitmap[f] = 0;
+            for ( size_t s = 0; s < kSlCount; ++s )
+                t->heads[f][s] = AT::no_block;
+        }
+    }
+    static void insert( uint8_t* base, detail::ManagerHeader<AT>* hdr, index_type blk_idx )
+    {
+        void*  blk = detail::block_at<AT>( base, blk_idx );
+        Table* t   = table_of( hdr );
+        size_t fl = 0, sl = 0;
+        mapping( BlockState::get_weight( blk ), fl, sl );
+        index_type head = t->heads[fl][sl];
+        BlockState::set_left_offset_of( blk, AT::no_block );
+        BlockState::set_right_offset_of( blk, head );
+        BlockState::set_parent_offset_of( blk, AT::no_block );
+        BlockState::set_avl_height_of( blk, 0 );
+        if ( head != AT::no_block )
+            BlockState::set_left_offset_of( detail::block_at<AT>( base, head ), blk_idx );
+        t->heads[fl][sl] = blk_idx;
+        t->sl_bitmap[fl] |= uint32_t{ 1 } << sl;
+        t->fl_bitmap |= uint64_t{ 1 } << fl;
+    }
+    static void remove( uint8_t* base, detail::ManagerHeader<AT>* hdr, index_type blk_idx )
+    {
+        void*  blk = detail::block_at<AT>( base, blk_idx );
+        Table* t   = table_of( hdr );
+        size_t fl = 0, sl = 0;
+        mapping( BlockState::get_weight( blk ), fl, sl );
+        index_type prev = BlockState::get_left_offset( blk );
+        index_type next = BlockState::get_right_offset( blk );
+        if ( prev != AT::no_block )
+            BlockState::set_right_offset_of( detail::block_at<AT>( base, prev ), next );
+        else
+            t->heads[fl][sl] = next;
+        if ( next != AT::no_block )
+            BlockState::set_left_offset_of( detail::block_at<AT>( base, next ), prev );
+        if ( t->heads[fl][sl] == AT::no_block )
+        {
+            t->sl_bitmap[fl] &= ~( uint32_t{ 1 } << sl );
+            if ( t->sl_bitmap[fl] == 0 )
+                t->fl_bitmap &= ~( uint64_t{ 1 } << fl );
+        }
+        BlockState::reset_avl_fields_of( blk );
+    }
+/*
+### pmm-tlsffreetree-find_best_fit
+*/
+    static index_type find_best_fit( uint8_t* base, detail::ManagerHeader<AT>* hdr, index_type needed_granules )
+    {
+        const Table* t       = table_of( hdr );
+        uint64_t     rounded = needed_granules;
+        if ( rounded >= kSlCount )
+            rounded += ( uint64_t{ 1 } << ( std::bit_width( rounded ) - 1 - kSlBits ) ) - 1;
+        size_t fl = 0, sl = 0;
+        mapping( rounded, fl, sl );
+        if ( fl < kFlCount )
+        {
+            uint32_t sl_map = t->sl_bitmap[fl] & ( ~uint32_t{ 0 } << sl );
+            if ( sl_map == 0 )
+            {
+                uint64_t fl_map = ( fl + 1 < 64 ) ? t->fl_bitmap & ( ~uint64_t{ 0 } << ( fl + 1 ) ) : 0;
+                if ( fl_map != 0 )
+                {
+                    fl     = static_cast<size_t>( std::countr_zero( fl_map ) );
+                    sl_map = t->sl_bitmap[fl];
+                }
+            }
+            if ( sl_map != 0 )
+                return t->heads[fl][std::countr_zero( sl_map )];
+        }
+        if ( rounded == needed_granules )
+            return AT::no_block;
+        mapping( needed_granules, fl, sl );
+        for ( index_type idx = t->heads[fl][sl]; idx != AT::no_block; )
+        {
+            const void* blk = detail::block_at<AT>( base, idx );
+            if ( BlockState::get_weight( blk ) >= needed_granules )
+                return idx;
+            idx = BlockState::get_right_offset( blk );
+        }
+        return AT::no_block;
+    }
+    static index_type largest_free( const uint8_t* base, const detail::ManagerHeader<AT>* hdr ) noexcept
+    {
+        const Table* t = table_of( hdr );
+        if ( t->fl_bitmap == 0 )
+            return 0;
+        size_t     fl     = static_cast<size_t>( std::bit_width( t->fl_bitmap ) ) - 1;
+        size_t     sl     = static_cast<size_t>( std::bit_width( t->sl_bitmap[fl] ) ) - 1;
+        index_type result = 0;
+        for ( index_type idx = t->heads[fl][sl]; idx != AT::no_block; )
+        {
+            const void* blk = detail::block_at<AT>( base, idx );
+            if ( BlockState::get_weight( blk ) > result )
+                result = BlockState::get_weight( blk );
+            idx = BlockState::get_right_offset( blk );
+        }
+        return result;
+    }
+    template <typename Fn>
+    static void for_each_listed( const uint8_t* base, const detail::ManagerHeader<AT>* hdr, Fn&& fn ) noexcept
+    {
+        const Table* t     = table_of( hdr );
+        size_t       limit = static_cast<size_t>( hdr->free_count );
+        for ( size_t f = 0; f < kFlCount; ++f )
+        {
+            for ( size_t s = 0; s < kSlCount; ++s )
+            {
+                for ( index_type idx = t->heads[f][s]; idx != AT::no_block && limit > 0; --limit )
+                {
+                    if ( !detail::validate_block_index<AT>( hdr->total_size, idx ) )
+                        break;
+                    fn( idx );
+                    idx = BlockState::get_right_offset( detail::block_at<AT>( base, idx ) );
+                }
+            }
+        }
+    }
+    static void verify_lists( detail::ConstArenaView<AT> arena, VerifyResult& result ) noexcept
+    {
+        const uint8_t*                   base     = arena.base();
+        const detail::ManagerHeader<AT>* hdr      = arena.header();
+        const Table*                     t        = table_of( hdr );
+        size_t                           expected = 0;
+        (void)detail::for_each_physical_block<AT>( arena,
+                                                   [&]( index_type, const void* blk ) noexcept
+                                                   {
+                                                       if ( pmm::is_free( BlockState::get_node_type( blk ) ) )
+                                                           ++expected;
+                                                       return true;
+                                                   } );
+        size_t listed = 0;
+        for ( size_t f = 0; f < kFlCount; ++f )
+        {
+            bool fl_flagged = ( t->fl_bitmap >> f ) & 1U;
+            if ( fl_flagged != ( t->sl_bitmap[f] != 0 ) )
+            {
+                result.add( ViolationType::FreeTreeStale, DiagnosticAction::NoAction, static_cast<uint64_t>( f ),
+                            static_cast<uint64_t>( fl_flagged ), static_cast<uint64_t>( t->sl_bitmap[f] ) );
+            }
+            for ( size_t s = 0; s < kSlCount; ++s )
+            {
+                bool flagged = ( t->sl_bitmap[f] >> s ) & 1U;
+                if ( flagged != ( t->heads[f][s] != AT::no_block ) )
+                {
+                    result.add( ViolationType::FreeTreeStale, DiagnosticAction::NoAction,
+                                static_cast<uint64_t>( t->heads[f][s] ), static_cast<uint64_t>( flagged ), 0 );
+                }
+                index_type prev = AT::no_block;
+                for ( index_type idx = t->heads[f][s]; idx != AT::no_block; )
+                {
+                    if ( listed >= expected || !detail::validate_block_index<AT>( hdr->total_size, idx ) )
+                    {
+                        result.add( ViolationType::FreeTreeStale, DiagnosticAction::NoAction,
+                                    static_cast<uint64_t>( idx ), static_cast<uint64_t>( expected ),
+                                    static_cast<uint64_t>( listed ) );
+                        break;
+                    }
+                    const void* node = detail::block_at<AT>( base, idx );
+                    size_t      nf = 0, ns = 0;
+                    mapping( BlockState::get_weight( node ), nf, ns );
+                    if ( !pmm::is_free( BlockState::get_node_type( node ) ) || nf != f || ns != s ||
+                         BlockState::get_left_offset( node ) != prev )
+                    {
+                        result.add( ViolationType::FreeTreeStale, DiagnosticAction::NoAction,
+                                    static_cast<uint64_t>( idx ), static_cast<uint64_t>( f * kSlCount + s ),
+                                    static_cast<uint64_t>( BlockState::get_weight( node ) ) );
+                        break;
+                    }
+                    ++listed;
+                    prev = idx;
+                    idx  = BlockState::get_right_offset( node );
+                }
+            }
+        }
+        if ( listed != expected )
+        {
+            result.add( ViolationType::FreeTreeStale, DiagnosticAction::NoAction, 0, static_cast<uint64_t>( expected ),
+                        static_cast<uint64_t>( listed ) );
+        }
+    }
+
+  private:
+    static constexpr void mapping( uint64_t granules, size_t& fl, size_t& sl ) noexcept
+    {
+        if ( granules < kSlCount )
+        {
+            fl = 0;
+            sl = static_cast<size_t>( granules );
+            return;
+        }
+        unsigned msb = static_cast<unsigned>( std::bit_width( granules ) ) - 1;
+        fl           = msb - kSlBits + 1;
+        sl           = static_cast<size_t>( ( granules >> ( msb - kSlBits ) ) - kSlCount );
+    }
+    static Table* table_of( detail::ManagerHeader<AT>* hdr ) noexcept
+    {
+        return reinterpret_cast<Table*>( detail::manager_header_reserve_at<AT>( hdr ) );
+    }
+    static const Table* table_of( const detail::ManagerHeader<AT>* hdr ) noexcept
+    {
+        return reinterpret_cast<const Table*>( detail::manager_header_reserve_at<AT>( hdr ) );
+    }
+};
+static_assert( FreeBlockTreePolicyForTraitsConcept<TlsfFreeTree<DefaultAddressTraits>, DefaultAddressTraits>, "" );
+}
@@ -0,0 +1,187 @@
+#pragma once
+#include "pmm/logging_policy.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+namespace pmm
+{
+namespace logging
+{
+enum class TraceOp : uint8_t
+{
+    Allocate   = 0,
+    Deallocate = 1,
+    Realloc    = 2,
+};
+/*
+### pmm-logging-tracerecord
+req: qa-perf-001
+*/
+struct TraceRecord
+{
+    uint64_t timestamp_ns;
+    uint64_t handle;
+    uint32_t size;
+    TraceOp  op;
+    uint8_t  reserved[3];
+};
+static_assert( sizeof( TraceRecord ) == 24, "" );
+struct TraceFileHeader
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t record_size;
+};
+inline constexpr char     kTraceMagic[8] = { 'P', 'M', 'M', 'T', 'R', 'A', 'C', 'E' };
+inline constexpr uint32_t kTraceVersion  = 1;
+/*
+### pmm-logging-tracelogging
+req: qa-perf-001
+*/
+struct TraceLogging : NoLogging
+{
+    static constexpr size_t kBufferRecords = 4096;
+    static bool             open( const char* path ) noexcept
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        if ( _file != nullptr || path == nullptr )
+            return false;
+        _file = std::fopen( path, "wb" );
+        if ( _file == nullptr )
+            return false;
+        TraceFileHeader hdr{};
+        std::memcpy( hdr.magic, kTraceMagic, sizeof( kTraceMagic ) );
+        hdr.version     = kTraceVersion;
+        hdr.record_size = sizeof( TraceRecord );
+        _handles.clear();
+        _next_handle = 0;
+        _buffered    = 0;
+        _recorded    = 0;
+        _dropped     = 0;
+        _start       = std::chrono::steady_clock::now();
+        return std::fwrite( &hdr, sizeof( hdr ), 1, _file ) == 1;
+    }
+    static bool close() noexcept
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        if ( _file == nullptr )
+            return false;
+        bool ok = flush_unlocked();
+        ok      = ( std::fclose( _file ) == 0 ) && ok;
+        _file   = nullptr;
+        _handles.clear();
+        return ok;
+    }
+    static uint64_t recorded() noexcept
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        return _recorded;
+    }
+    static uint64_t dropped() noexcept
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        return _dropped;
+    }
+    static void on_trace_allocate( uint64_t offset, size_t size ) noexcept
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        if ( _file == nullptr )
+            return;
+        try
+        {
+            uint64_t handle  = _next_handle++;
+            _handles[offset] = handle;
+            append_unlocked( TraceOp::Allocate, handle, size );
+        }
+        catch ( ... )
+        {
+            ++_dropped;
+        }
+    }
+    static void on_trace_deallocate( uint64_t offset ) noexcept
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        auto                        it = _handles.find( offset );
+        if ( _file == nullptr || it == _handles.end() )
+            return;
+        append_unlocked( TraceOp::Deallocate, it->second, 0 );
+        _handles.erase( it );
+    }
+    static void on_trace_realloc( uint64_t old_offset, uint64_t new_offset, size_t new_size ) noexcept
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        auto                        it = _handles.find( old_offset );
+        if ( _file == nullptr || it == _handles.end() )
+            return;
+        uint64_t handle = it->second;
+        append_unlocked( TraceOp::Realloc, handle, new_size );
+        if ( new_offset == old_offset )
+            return;
+        _handles.erase( it );
+        try
+        {
+            _handles[new_offset] = handle;
+        }
+        catch ( ... )
+        {
+            ++_dropped;
+        }
+    }
+
+  private:
+    static void append_unlocked( TraceOp op, uint64_t handle, size_t size ) noexcept
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - _start );
+        TraceRecord& r = _buffer[_buffered++];
+        r              = TraceRecord{};
+        r.timestamp_ns = static_cast<uint64_t>( ns.count() );
+        r.handle       = handle;
+        r.size         = ( size > UINT32_MAX ) ? UINT32_MAX : static_cast<uint32_t>( size );
+        r.op           = op;
+        ++_recorded;
+        if ( _buffered == kBufferRecords )
+            flush_unlocked();
+    }
+    static bool flush_unlocked() noexcept
+    {
+        bool ok   = _buffered == 0 || std::fwrite( _buffer, sizeof( TraceRecord ), _buffered, _file ) == _buffered;
+        _buffered = 0;
+        return ok && std::fflush( _file ) == 0;
+    }
+    static inline std::mutex                             _mutex;
+    static inline std::FILE*                             _file = nullptr;
+    static inline std::unordered_map<uint64_t, uint64_t> _handles;
+    static inline uint64_t                               _next_handle = 0;
+    static inline uint64_t                               _recorded    = 0;
+    static inline uint64_t                               _dropped     = 0;
+    static inline std::chrono::steady_clock::time_point  _start;
+    static inline TraceRecord                            _buffer[kBufferRecords];
+    static inline size_t                                 _buffered = 0;
+};
+/*
+### pmm-logging-read_trace_file
+req: qa-perf-001
+*/
+inline bool read_trace_file( const char* path, std::vector<TraceRecord>& out )
+{
+    out.clear();
+    std::FILE* f = ( path != nullptr ) ? std::fopen( path, "rb" ) : nullptr;
+    if ( f == nullptr )
+        return false;
+    TraceFileHeader hdr{};
+    bool            ok = std::fread( &hdr, sizeof( hdr ), 1, f ) == 1;
+    ok = ok && std::memcmp( hdr.magic, kTraceMagic, sizeof( kTraceMagic ) ) == 0 && hdr.version == kTraceVersion &&
+         hdr.record_size == sizeof( TraceRecord );
+    TraceRecord r{};
+    while ( ok && std::fread( &r, sizeof( r ), 1, f ) == 1 )
+        out.push_back( r );
+    std::fclose( f );
+    return ok;
+}
+}
+}
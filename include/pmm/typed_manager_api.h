@@ -1,14 +1,19 @@
 #pragma once
 #include "pmm/arena_internals.h"
 #include "pmm/block_state.h"
+#include "pmm/logging_policy.h"
 #include "pmm/pptr.h"
+#include "pmm/pslab.h"
 #include "pmm/typed_guard.h"
 #include "pmm/types.h"
 #include <cstddef>
 #include <cstdint>
+#include <algorithm>
+#include <cassert>
 #include <cstring>
 #include <limits>
 #include <new>
+#include <span>
 #include <type_traits>
 namespace pmm
 {
@@ -38,38 +43,200 @@ template <typename ManagerT> class PersistMemoryTypedApi
         void* blk_raw = base + user_off - kHdrBytes;
         BlockStateBase<address_traits>::set_node_type_of( blk_raw, pmm::node_type_for_v<T> );
     }
-    template <typename T> static pmm::pptr<T, ManagerT> allocate_typed() noexcept
+    template <typename T> static pmm::pptr<T, ManagerT> finish_typed( void* raw ) noexcept
     {
-        using thread_policy = typename ManagerT::thread_policy;
-        typename thread_policy::unique_lock_type lock( ManagerT::_mutex );
-        void*                                    raw = ManagerT::allocate_unlocked( sizeof( T ) );
         if ( raw == nullptr )
             return pmm::pptr<T, ManagerT>();
-        assign_node_type_for<T>( raw );
+        if constexpr ( pmm::node_type_for_v<T> != pmm::NodeType::Generic )
+            assign_node_type_for<T>( raw );
         return ManagerT::template make_pptr_from_raw<T>( raw );
     }
+    template <typename T> static pmm::pptr<T, ManagerT> allocate_typed() noexcept
+    {
+        if constexpr ( pmm::slab_pooled_v<T> )
+            return slab_allocate<T>();
+        return ManagerT::allocate_with( sizeof( T ), pmm::node_type_for_v<T> == pmm::NodeType::Generic,
+                                        []( void* raw ) noexcept { return finish_typed<T>( raw ); } );
+    }
+/*
+#### pmm-detail-persistmemorytypedapi-allocate_tree_node
+req: dr-001, qa-mem-001
+*/
+    template <typename T> static pmm::pptr<T, ManagerT> allocate_tree_node() noexcept
+    {
+        constexpr size_t kSize = sizeof( T ) + detail::block_tree_slot_bytes_v<typename ManagerT::address_traits>;
+        return ManagerT::allocate_with( kSize, pmm::node_type_for_v<T> == pmm::NodeType::Generic,
+                                        []( void* raw ) noexcept { return finish_typed<T>( raw ); } );
+    }
     template <typename T> static pmm::pptr<T, ManagerT> allocate_typed( size_t count ) noexcept
     {
         if ( count == 0 )
             return pmm::pptr<T, ManagerT>();
         if ( sizeof( T ) > 0 && count > ( std::numeric_limits<size_t>::max )() / sizeof( T ) )
             return pmm::pptr<T, ManagerT>();
-        using thread_policy = typename ManagerT::thread_policy;
-        typename thread_policy::unique_lock_type lock( ManagerT::_mutex );
-        void*                                    raw = ManagerT::allocate_unlocked( sizeof( T ) * count );
-        if ( raw == nullptr )
+        return ManagerT::allocate_with( sizeof( T ) * count, pmm::node_type_for_v<T> == pmm::NodeType::Generic,
+                                        []( void* raw ) noexcept { return finish_typed<T>( raw ); } );
+    }
+/*
+#### pmm-detail-persistmemorytypedapi-allocate_typed_aligned
+req: fr-004, feat-002
+*/
+    template <typename T> static pmm::pptr<T, ManagerT> allocate_typed_aligned( size_t count, size_t align ) noexcept
+    {
+        if ( align <= ManagerT::address_traits::granule_size && align != 0 && ( align & ( align - 1 ) ) == 0 )
+            return allocate_typed<T>( count );
+        if ( count == 0 )
             return pmm::pptr<T, ManagerT>();
-        assign_node_type_for<T>( raw );
-        return ManagerT::template make_pptr_from_raw<T>( raw );
+        if ( sizeof( T ) > 0 && count > ( std::numeric_limits<size_t>::max )() / sizeof( T ) )
+            return pmm::pptr<T, ManagerT>();
+        return finish_typed<T>( ManagerT::allocate_aligned( sizeof( T ) * count, align ) );
+    }
+/*
+#### pmm-detail-persistmemorytypedapi-allocate_batch
+req: fr-004, qa-perf-001
+*/
+    template <typename T>
+    static bool allocate_batch( std::span<pmm::pptr<T, ManagerT>> out, size_t count = 1 ) noexcept
+    {
+        using address_traits = typename ManagerT::address_traits;
+        using index_type     = typename ManagerT::index_type;
+        for ( auto& p : out )
+            p = pmm::pptr<T, ManagerT>();
+        if ( out.empty() )
+            return true;
+        if ( count == 0 || ( sizeof( T ) > 0 && count > ( std::numeric_limits<size_t>::max )() / sizeof( T ) ) )
+        {
+            ManagerT::_last_error = ( count == 0 ) ? PmmError::InvalidSize : PmmError::Overflow;
+            return false;
+        }
+        using logging_policy = typename ManagerT::logging_policy;
+        pmm::detail::LatencyTimer<pmm::detail::logs_allocate_v<logging_policy>> timer;
+        size_t                                                                  user_size = sizeof( T ) * count;
+        typename ManagerT::write_lock_type                                      lock( ManagerT::_mutex );
+        if ( !ManagerT::_initialized )
+        {
+            ManagerT::_last_error = PmmError::NotInitialized;
+            return false;
+        }
+        auto checked = pmm::detail::bytes_to_granules_checked<address_traits>( user_size );
+        if ( !checked.has_value() || checked->value == 0 ||
+             checked->value > std::numeric_limits<index_type>::max() - ManagerT::kBlockHdrGranules )
+        {
+            ManagerT::_last_error = PmmError::Overflow;
+            return false;
+        }
+        size_t done = 0;
+        auto   emit = [&]( void* raw ) { out[done++] = finish_typed<T>( raw ); };
+        ManagerT::allocate_run_unlocked( checked->value, out.size(), emit );
+        while ( done < out.size() )
+        {
+            void* raw = ManagerT::allocate_unlocked( user_size );
+            if ( raw == nullptr )
+            {
+                for ( size_t i = 0; i < done; ++i )
+                {
+                    ManagerT::deallocate_unlocked( ManagerT::template raw_block_user_ptr_from_pptr<T>( out[i] ) );
+                    out[i] = pmm::pptr<T, ManagerT>();
+                }
+                return false;
+            }
+            emit( raw );
+        }
+        for ( const auto& p : out )
+            ManagerT::note_allocate_unlocked( resolve_unchecked<T>( p ), user_size );
+        if constexpr ( pmm::detail::logs_allocate_v<logging_policy> )
+        {
+            const uint64_t ns = timer.elapsed_ns() / out.size();
+            for ( const auto& p : out )
+                logging_policy::on_allocate( user_size, ManagerT::granted_bytes_unlocked( resolve_unchecked<T>( p ) ),
+                                             ns );
+        }
+        ManagerT::_last_error = PmmError::Ok;
+        return true;
     }
     template <typename T> static void deallocate_typed( pmm::pptr<T, ManagerT> p ) noexcept
     {
         if ( p.is_null() || !ManagerT::_initialized )
             return;
+        if constexpr ( pmm::slab_pooled_v<T> )
+        {
+            if ( slab_deallocate<T>( p ) )
+                return;
+        }
         void* raw = ManagerT::template raw_block_user_ptr_from_pptr<T>( p );
         ManagerT::deallocate( raw );
     }
 /*
+#### pmm-detail-persistmemorytypedapi-deallocate_batch
+req: fr-005, qa-perf-001
+*/
+    template <typename T> static void deallocate_batch( std::span<pmm::pptr<T, ManagerT>> ptrs ) noexcept
+    {
+        using address_traits = typename ManagerT::address_traits;
+        using index_type     = typename ManagerT::index_type;
+        if constexpr ( pmm::slab_pooled_v<T> )
+        {
+            for ( auto& p : ptrs )
+            {
+                if ( !p.is_null() && ManagerT::_initialized && slab_deallocate<T>( p ) )
+                    p = pmm::pptr<T, ManagerT>();
+            }
+        }
+        using logging_policy = typename ManagerT::logging_policy;
+        pmm::detail::LatencyTimer<pmm::detail::logs_deallocate_v<logging_policy>> timer;
+        size_t                                                                   pending = 0;
+        uint64_t                                                                 mark    = 0;
+        auto report = [&]() noexcept
+        {
+            if constexpr ( pmm::detail::logs_deallocate_v<logging_policy> )
+            {
+                if ( pending != 0 )
+                {
+                    uint64_t now = timer.elapsed_ns();
+                    logging_policy::on_deallocate( pending, now - mark );
+                    mark = now;
+                }
+            }
+        };
+        typename ManagerT::write_lock_type lock( ManagerT::_mutex );
+        if ( ManagerT::_initialized )
+        {
+            auto by_offset = []( const auto& a, const auto& b ) noexcept { return a.offset() < b.offset(); };
+            if ( !std::is_sorted( ptrs.begin(), ptrs.end(), by_offset ) )
+                std::sort( ptrs.begin(), ptrs.end(), by_offset );
+            uint8_t*   base = ManagerT::_backend.base_ptr();
+            size_t     i    = 0;
+            index_type last = 0;
+            ManagerT::release_sorted_unlocked(
+                [&]() noexcept
+                {
+                    while ( i < ptrs.size() )
+                    {
+                        pmm::pptr<T, ManagerT> p = ptrs[i++];
+                        if ( p.is_null() || p.offset() == last )
+                            continue;
+                        last     = p.offset();
+                        auto blk = ManagerT::find_block_from_user_ptr(
+                            ManagerT::template raw_block_user_ptr_from_pptr<T>( p ) );
+                        if ( ManagerT::deallocatable_block( blk ) )
+                        {
+                            if constexpr ( pmm::detail::logs_trace_v<logging_policy> )
+                                logging_policy::on_trace_deallocate( p.offset() );
+                            report();
+                            pending = static_cast<size_t>( BlockStateBase<address_traits>::get_weight( blk ) ) *
+                                      address_traits::granule_size;
+                            return pmm::detail::block_idx_t<address_traits>( base, blk );
+                        }
+                    }
+                    return address_traits::no_block;
+                } );
+            report();
+            ManagerT::auto_shrink_unlocked();
+        }
+        for ( auto& p : ptrs )
+            p = pmm::pptr<T, ManagerT>();
+    }
+/*
 #### pmm-detail-persistmemorytypedapi-reallocate_typed
 req: dr-019, fr-005, fr-006, fr-029, rule-007, ur-002
 */
@@ -77,27 +244,46 @@ req: dr-019, fr-005, fr-006, fr-029, rule-007, ur-002
     static pmm::pptr<T, ManagerT> reallocate_typed( pmm::pptr<T, ManagerT> p, size_t old_count,
                                                     size_t new_count ) noexcept
     {
-        using address_traits  = typename ManagerT::address_traits;
-        using allocator       = typename ManagerT::allocator;
-        using free_block_tree = typename ManagerT::free_block_tree;
-        using index_type      = typename ManagerT::index_type;
-        using logging_policy  = typename ManagerT::logging_policy;
-        using thread_policy   = typename ManagerT::thread_policy;
+        using logging_policy = typename ManagerT::logging_policy;
+        if ( p.is_null() && new_count != 0 )
+            return allocate_typed<T>( new_count );
+        pmm::detail::LatencyTimer<pmm::detail::logs_realloc_v<logging_policy>> timer;
+        pmm::pptr<T, ManagerT>                                                 result;
+        {
+            typename ManagerT::write_lock_type lock( ManagerT::_mutex );
+            result = reallocate_typed_unlocked<T>( p, old_count, new_count );
+            if constexpr ( pmm::detail::logs_trace_v<logging_policy> )
+            {
+                if ( !result.is_null() )
+                    logging_policy::on_trace_realloc( p.offset(), result.offset(), new_count * sizeof( T ) );
+            }
+        }
+        if constexpr ( pmm::detail::logs_realloc_v<logging_policy> )
+        {
+            if ( !result.is_null() )
+                logging_policy::on_realloc( old_count * sizeof( T ), new_count * sizeof( T ), timer.elapsed_ns() );
+        }
+        return result;
+    }
+    template <typename T>
+    static pmm::pptr<T, ManagerT> reallocate_typed_unlocked( pmm::pptr<T, ManagerT> p, size_t old_count,
+                                                             size_t new_count ) noexcept
+    {
+        using address_traits = typename ManagerT::address_traits;
+        using allocator      = typename ManagerT::allocator;
+        using index_type     = typename ManagerT::index_type;
         static_assert( std::is_trivially_copyable_v<T>, "" );
         if ( new_count == 0 )
         {
             ManagerT::_last_error = PmmError::InvalidSize;
             return pmm::pptr<T, ManagerT>();
         }
-        if ( p.is_null() )
-            return allocate_typed<T>( new_count );
         if ( sizeof( T ) > 0 && new_count > ( std::numeric_limits<size_t>::max )() / sizeof( T ) )
         {
             ManagerT::_last_error = PmmError::Overflow;
             return pmm::pptr<T, ManagerT>();
         }
-        size_t                                   new_user_size = sizeof( T ) * new_count;
-        typename thread_policy::unique_lock_type lock( ManagerT::_mutex );
+        size_t new_user_size = sizeof( T ) * new_count;
         if ( !ManagerT::_initialized )
         {
             ManagerT::_last_error = PmmError::NotInitialized;
@@ -124,8 +310,8 @@ req: dr-019, fr-005, fr-006, fr-029, rule-007, ur-002
         if ( blk_raw == nullptr )
             return pmm::pptr<T, ManagerT>();
         uint8_t*                               base          = ManagerT::_backend.base_ptr();
-        detail::ManagerHeader<address_traits>* hdr           = ManagerT::get_header( base );
         index_type                             blk_idx       = ManagerT::template block_idx_from_pptr<T>( p );
+        detail::ManagerHeader<address_traits>* hdr           = ManagerT::arena_ops::owning_header( base, blk_idx );
         index_type                             old_data_gran = BlockStateBase<address_traits>::get_weight( blk_raw );
         if ( new_data_gran == old_data_gran )
         {
@@ -151,33 +337,9 @@ req: dr-019, fr-005, fr-006, fr-029, rule-007, ur-002
                 }
             }
         }
-        index_type needed  = ManagerT::kBlockHdrGranules + new_data_gran;
-        index_type new_idx = free_block_tree::find_best_fit( base, hdr, needed );
-        if ( new_idx == address_traits::no_block )
-        {
-            if ( !ManagerT::do_expand( new_data_gran ) )
-            {
-                ManagerT::_last_error = PmmError::OutOfMemory;
-                logging_policy::on_allocation_failure( new_user_size, PmmError::OutOfMemory );
-                return pmm::pptr<T, ManagerT>();
-            }
-            base    = ManagerT::_backend.base_ptr();
-            hdr     = ManagerT::get_header( base );
-            new_idx = free_block_tree::find_best_fit( base, hdr, needed );
-            if ( new_idx == address_traits::no_block )
-            {
-                ManagerT::_last_error = PmmError::OutOfMemory;
-                logging_policy::on_allocation_failure( new_user_size, PmmError::OutOfMemory );
-                return pmm::pptr<T, ManagerT>();
-            }
-        }
-        detail::ArenaView<address_traits> arena_after{ base, hdr };
-        void* new_raw = allocator::allocate_from_block( arena_after, new_idx, new_data_gran );
+        void* new_raw = ManagerT::allocate_unlocked( new_user_size );
         if ( new_raw == nullptr )
-        {
-            ManagerT::_last_error = PmmError::OutOfMemory;
             return pmm::pptr<T, ManagerT>();
-        }
         assign_node_type_for<T>( new_raw );
         pmm::pptr<T, ManagerT> new_p = ManagerT::template make_pptr_from_raw<T>( new_raw );
         if ( new_p.is_null() )
@@ -189,21 +351,8 @@ req: dr-019, fr-005, fr-006, fr-029, rule-007, ur-002
         void*  old_src = resolve_unchecked<T>( p );
         size_t copy_sz = ( new_count < old_count ? new_count : old_count ) * sizeof( T );
         std::memmove( new_dst, old_src, copy_sz );
-        void*               old_blk_raw = detail::block_at<address_traits>( base, blk_idx );
-        index_type          freed_w     = BlockStateBase<address_traits>::get_weight( old_blk_raw );
-        const pmm::NodeType nt_old      = BlockStateBase<address_traits>::get_node_type( old_blk_raw );
-        if ( pmm::is_allocated( nt_old ) && pmm::can_be_deleted_from_pap( nt_old ) )
-        {
-            auto       old_alloc  = AllocatedBlock<address_traits>::cast_from_raw( old_blk_raw );
-            index_type total_gran = detail::physical_block_total_granules<address_traits>(
-                base, hdr, detail::block_at<address_traits>( base, blk_idx ) );
-            old_alloc.mark_as_free( total_gran );
-            hdr->alloc_count--;
-            hdr->free_count++;
-            if ( hdr->used_size >= freed_w )
-                hdr->used_size -= freed_w;
-            allocator::coalesce( arena_after, blk_idx );
-        }
+        pmm::detail::note_dirty( new_dst, copy_sz );
+        ManagerT::deallocate_unlocked( old_src );
         ManagerT::_last_error = PmmError::Ok;
         return new_p;
     }
@@ -212,14 +361,27 @@ req: dr-019, fr-005, fr-006, fr-029, rule-007, ur-002
         static_assert( std::is_nothrow_constructible_v<T, Args...>, "" );
         pmm::pptr<T, ManagerT> p;
         void*                  raw = nullptr;
+        if constexpr ( pmm::slab_pooled_v<T> )
         {
-            using thread_policy = typename ManagerT::thread_policy;
-            typename thread_policy::unique_lock_type lock( ManagerT::_mutex );
+            p = slab_allocate<T>();
+            if ( p.is_null() )
+                return p;
+            T* slot = ::new ( resolve_unchecked<T>( p ) ) T( static_cast<Args&&>( args )... );
+            pmm::detail::note_dirty( slot, sizeof( T ) );
+            return p;
+        }
+        {
+            using logging_policy = typename ManagerT::logging_policy;
+            pmm::detail::LatencyTimer<pmm::detail::logs_allocate_v<logging_policy>> timer;
+            typename ManagerT::write_lock_type                                      lock( ManagerT::_mutex );
             raw = ManagerT::allocate_unlocked( sizeof( T ) );
             if ( raw == nullptr )
                 return pmm::pptr<T, ManagerT>();
             assign_node_type_for<T>( raw );
             p = ManagerT::template make_pptr_from_raw<T>( raw );
+            ManagerT::note_allocate_unlocked( raw, sizeof( T ) );
+            if constexpr ( pmm::detail::logs_allocate_v<logging_policy> )
+                logging_policy::on_allocate( sizeof( T ), ManagerT::granted_bytes_unlocked( raw ), timer.elapsed_ns() );
         }
         T* obj = resolve_unchecked<T>( p );
         if ( obj == nullptr )
@@ -228,6 +390,7 @@ req: dr-019, fr-005, fr-006, fr-029, rule-007, ur-002
             return pmm::pptr<T, ManagerT>();
         }
         ::new ( obj ) T( static_cast<Args&&>( args )... );
+        pmm::detail::note_dirty( obj, sizeof( T ) );
         return p;
     }
     template <typename T> static void destroy_typed( pmm::pptr<T, ManagerT> p ) noexcept
@@ -235,6 +398,15 @@ req: dr-019, fr-005, fr-006, fr-029, rule-007, ur-002
         static_assert( std::is_nothrow_destructible_v<T>, "" );
         if ( p.is_null() || !ManagerT::_initialized )
             return;
+        if constexpr ( pmm::slab_pooled_v<T> )
+        {
+            if ( T* obj = resolve_checked<T>( p ); obj != nullptr )
+            {
+                obj->~T();
+                deallocate_typed<T>( p );
+            }
+            return;
+        }
         T*    obj = resolve_unchecked<T>( p );
         void* raw = ManagerT::template raw_block_user_ptr_from_pptr<T>( p );
         if ( obj == nullptr || raw == nullptr )
@@ -261,6 +433,11 @@ req: dr-019, fr-005, fr-006, fr-029, rule-007, ur-002
     }
     template <typename T> static T* resolve_checked( pmm::pptr<T, ManagerT> p ) noexcept
     {
+        if constexpr ( pmm::slab_pooled_v<T> )
+        {
+            if ( T* obj = nullptr; slab_resolve<T>( p, obj ) )
+                return obj;
+        }
         using address_traits = typename ManagerT::address_traits;
         using index_type     = typename ManagerT::index_type;
         if ( p.is_null() || !ManagerT::_initialized )
@@ -273,7 +450,7 @@ req: dr-019, fr-005, fr-006, fr-029, rule-007, ur-002
         }
         index_type          blk_idx   = ManagerT::template block_idx_from_pptr<T>( p );
         const pmm::NodeType node_type = BlockStateBase<address_traits>::get_node_type( blk_raw );
-        if ( !pmm::is_allocated( node_type ) || BlockStateBase<address_traits>::get_root_offset( blk_raw ) != blk_idx )
+        if ( !BlockStateBase<address_traits>::is_allocated_raw( blk_raw, blk_idx ) )
         {
             ManagerT::_last_error = PmmError::InvalidPointer;
             return nullptr;
@@ -289,10 +466,109 @@ req: dr-019, fr-005, fr-006, fr-029, rule-007, ur-002
         ManagerT::_last_error = PmmError::Ok;
         return raw;
     }
-    template <typename T> static T* resolve( pmm::pptr<T, ManagerT> p ) noexcept { return resolve_checked<T>( p ); }
+/*
+#### pmm-detail-persistmemorytypedapi-slab_pool
+req: feat-002, qa-mem-001
+*/
+    template <typename T> static pmm::pslab<T, ManagerT>* slab_pool( bool create ) noexcept
+    {
+        using pool_type = pmm::pslab<T, ManagerT>;
+        char name[detail::kForestDomainNameCapacity]{};
+        if ( !ManagerT::_initialized || !detail::slab_domain_name<T>( name ) )
+            return nullptr;
+        pmm::pptr<pool_type, ManagerT> pool = ManagerT::template get_domain_root<pool_type>( name );
+        if ( pool.is_null() && create )
+        {
+            if ( !ManagerT::has_domain( name ) && !ManagerT::register_domain( name ) )
+                return nullptr;
+            pool = create_typed<pool_type>();
+            if ( !pool.is_null() && !ManagerT::set_domain_root( name, pool ) )
+            {
+                destroy_typed<pool_type>( pool );
+                return nullptr;
+            }
+        }
+        return resolve_unchecked<pool_type>( pool );
+    }
+    template <typename T> static pmm::pptr<T, ManagerT> slab_allocate() noexcept
+    {
+        using logging_policy = typename ManagerT::logging_policy;
+        pmm::detail::LatencyTimer<pmm::detail::logs_allocate_v<logging_policy>> timer;
+        typename ManagerT::thread_policy::unique_lock_type lock( detail::SlabPoolLock<ManagerT, T>::mutex );
+        pmm::pslab<T, ManagerT>* pool = slab_pool<T>( true );
+        pmm::pptr<T, ManagerT>   p    = ( pool == nullptr ) ? pmm::pptr<T, ManagerT>() : pool->allocate();
+        if constexpr ( pmm::detail::logs_trace_v<logging_policy> )
+        {
+            if ( !p.is_null() )
+                logging_policy::on_trace_allocate( p.offset(), sizeof( T ) );
+        }
+        if constexpr ( pmm::detail::logs_allocate_v<logging_policy> )
+        {
+            if ( !p.is_null() )
+                logging_policy::on_allocate( sizeof( T ), slab_slot_bytes<T>(), timer.elapsed_ns() );
+        }
+        return p;
+    }
+    template <typename T> static bool slab_deallocate( pmm::pptr<T, ManagerT> p ) noexcept
+    {
+        using logging_policy = typename ManagerT::logging_policy;
+        pmm::detail::LatencyTimer<pmm::detail::logs_deallocate_v<logging_policy>> timer;
+        typename ManagerT::thread_policy::unique_lock_type lock( detail::SlabPoolLock<ManagerT, T>::mutex );
+        pmm::pslab<T, ManagerT>* pool = slab_pool<T>( false );
+        if ( pool == nullptr || !pool->contains( p ) )
+            return false;
+        if ( pool->deallocate( p ) )
+        {
+            if constexpr ( pmm::detail::logs_trace_v<logging_policy> )
+                logging_policy::on_trace_deallocate( p.offset() );
+            if constexpr ( pmm::detail::logs_deallocate_v<logging_policy> )
+                logging_policy::on_deallocate( slab_slot_bytes<T>(), timer.elapsed_ns() );
+        }
+        return true;
+    }
+    template <typename T> static constexpr size_t slab_slot_bytes() noexcept
+    {
+        return pmm::pslab<T, ManagerT>::kSlotGranules * ManagerT::address_traits::granule_size;
+    }
+    template <typename T> static bool slab_resolve( pmm::pptr<T, ManagerT> p, T*& obj ) noexcept
+    {
+        typename ManagerT::thread_policy::shared_lock_type lock( detail::SlabPoolLock<ManagerT, T>::mutex );
+        pmm::pslab<T, ManagerT>* pool = p.is_null() ? nullptr : slab_pool<T>( false );
+        if ( pool == nullptr || !pool->contains( p ) )
+            return false;
+        obj                   = pool->resolve( p );
+        ManagerT::_last_error = ( obj != nullptr ) ? PmmError::Ok : PmmError::InvalidPointer;
+        return true;
+    }
+/*
+#### pmm-detail-persistmemorytypedapi-resolve
+req: fr-035, qa-perf-002
+*/
+    template <typename T> static T* resolve( pmm::pptr<T, ManagerT> p ) noexcept
+    {
+        using validation_policy = typename ManagerT::validation_policy;
+        if constexpr ( validation_policy::check_on_resolve )
+        {
+            return resolve_checked<T>( p );
+        }
+        else
+        {
+            if constexpr ( validation_policy::assert_on_resolve )
+                assert( p.is_null() || resolve_checked<T>( p ) != nullptr );
+            return resolve_fast<T>( p );
+        }
+    }
+    template <typename T> static T* resolve_fast( pmm::pptr<T, ManagerT> p ) noexcept
+    {
+        using address_traits = typename ManagerT::address_traits;
+        if ( p.is_null() )
+            return nullptr;
+        return reinterpret_cast<T*>( ManagerT::_backend.base_ptr() +
+                                     static_cast<size_t>( p.offset() ) * address_traits::granule_size );
+    }
     template <typename T> static T* resolve_at( pmm::pptr<T, ManagerT> p, size_t i ) noexcept
     {
-        T* base_elem = resolve_checked<T>( p );
+        T* base_elem = resolve<T>( p );
         return ( base_elem == nullptr ) ? nullptr : base_elem + i;
     }
 /*
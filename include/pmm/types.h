@@ -4,6 +4,7 @@
 #include "pmm/block_state.h"
 #include "pmm/validation.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -31,6 +32,8 @@ enum class PmmError : uint8_t
     InvalidPointer          = 11,
     BlockLocked             = 12,
     UnsupportedImageVersion = 13,
+    ReadOnlyImage           = 14,
+    LockFailed              = 15,
 };
 inline constexpr size_t kGranuleSize = 16;
 static_assert( ( kGranuleSize & ( kGranuleSize - 1 ) ) == 0, "" );
@@ -49,6 +52,25 @@ struct MemoryStats
     size_t smallest_free;
     size_t total_fragmentation;
 };
+/*
+## pmm-detailedmemorystats
+req: feat-005, fr-019, qa-perf-001
+*/
+inline constexpr size_t kSizeHistogramBuckets = 32;
+struct DetailedMemoryStats
+{
+    size_t total_size;
+    size_t free_bytes;
+    size_t allocated_bytes;
+    size_t header_overhead;
+    size_t largest_free;
+    size_t free_blocks;
+    size_t allocated_blocks;
+    double external_fragmentation;
+    size_t free_histogram[kSizeHistogramBuckets];
+    size_t alloc_histogram[kSizeHistogramBuckets];
+    size_t huge_page_bytes;
+};
 struct ManagerInfo
 {
     uint64_t       magic;
@@ -90,8 +112,61 @@ struct FreeBlockView
     int            avl_height;
     int            avl_depth;
 };
+/*
+## pmm-compactresult
+req: feat-005, fr-004
+*/
+struct CompactResult
+{
+    size_t moved_blocks;
+    size_t moved_bytes;
+    bool   complete;
+};
 namespace detail
 {
+struct StatsSnapshot
+{
+    uint64_t image_size;
+    uint64_t total_size;
+    uint64_t used_size;
+    uint64_t block_count;
+    uint64_t free_count;
+    uint64_t alloc_count;
+};
+/*
+### pmm-detail-publishedstats
+req: qa-thread-001, qa-perf-001
+*/
+struct PublishedStats
+{
+    static constexpr size_t kFields = 6;
+    std::atomic<uint64_t>   seq{ 0 };
+    std::atomic<uint64_t>   fields[kFields]{};
+    void                    publish( const StatsSnapshot& s ) noexcept
+    {
+        const uint64_t v[kFields] = { s.image_size, s.total_size, s.used_size, s.block_count, s.free_count,
+                                      s.alloc_count };
+        uint64_t       before     = seq.load( std::memory_order_relaxed );
+        seq.store( before + 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+        for ( size_t i = 0; i < kFields; ++i )
+            fields[i].store( v[i], std::memory_order_relaxed );
+        seq.store( before + 2, std::memory_order_release );
+    }
+    StatsSnapshot read() const noexcept
+    {
+        uint64_t v[kFields];
+        for ( ;; )
+        {
+            uint64_t before = seq.load( std::memory_order_acquire );
+            for ( size_t i = 0; i < kFields; ++i )
+                v[i] = fields[i].load( std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if ( ( before & 1 ) == 0 && seq.load( std::memory_order_relaxed ) == before )
+                return StatsSnapshot{ v[0], v[1], v[2], v[3], v[4], v[5] };
+        }
+    }
+};
 inline constexpr uint8_t kLegacyUnversionedImageVersion = 0;
 inline constexpr uint8_t kCurrentImageVersion           = 2;
 inline constexpr bool    is_supported_image_version( uint8_t image_version ) noexcept
@@ -160,6 +235,14 @@ template <typename AT> inline const ManagerHeader<AT>* manager_header_at( const
 {
     return reinterpret_cast<const ManagerHeader<AT>*>( base + manager_header_offset_bytes_v<AT> );
 }
+template <typename AT> inline uint8_t* manager_header_reserve_at( ManagerHeader<AT>* hdr ) noexcept
+{
+    return reinterpret_cast<uint8_t*>( hdr + 1 );
+}
+template <typename AT> inline const uint8_t* manager_header_reserve_at( const ManagerHeader<AT>* hdr ) noexcept
+{
+    return reinterpret_cast<const uint8_t*>( hdr + 1 );
+}
 template <typename AT> inline uint32_t compute_image_crc32( const uint8_t* data, size_t length ) noexcept
 {
     constexpr size_t kHdrOffset = manager_header_offset_bytes_v<AT>;
@@ -337,9 +420,8 @@ inline bool is_canonical_allocated_block_header( const uint8_t* base, size_t tot
     const IndexT cand_idx = static_cast<IndexT>( cand_off / AT::granule_size );
     if ( !validate_block_index<AT>( total_size, cand_idx ) )
         return false;
-    const IndexT        weight    = BlockState::get_weight( cand_addr );
-    const pmm::NodeType node_type = BlockState::get_node_type( cand_addr );
-    if ( !pmm::is_allocated( node_type ) || BlockState::get_root_offset( cand_addr ) != cand_idx )
+    const IndexT weight = BlockState::get_weight( cand_addr );
+    if ( !BlockState::is_allocated_raw( cand_addr, cand_idx ) )
         return false;
     if ( weight == 0 )
         return false;
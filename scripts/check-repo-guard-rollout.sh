@@ -39,7 +39,7 @@ expected_profiles = {
     "release",
 }
 expected_size_rules = [
-    ("kernel-subtree-max-bytes", "directory", "bytes", "include/**", 270000),
+    ("kernel-subtree-max-bytes", "directory", "bytes", "include/**", 500000),
 ]
 required_governance_paths = {
     ".github/workflows/repo-guard.yml",
@@ -0,0 +1,173 @@
+/**
+ * @file test_address_ordered_free_tree.cpp
+ * @brief AddressOrderedFreeTree: address-keyed AVL with a subtree max-size augmentation.
+ *
+ *   - find_best_fit returns the lowest-addressed block that fits (first fit) in O(log n).
+ *   - Subtree maxima are kept in the free block payload and checked by verify(); load() rebuilds them.
+ */
+
+#include "pmm/io.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using AT          = pmm::DefaultAddressTraits;
+using AddrTree    = pmm::AddressOrderedFreeTree<AT>;
+using AddrConfig  = pmm::BasicConfig<AT, pmm::config::NoLock, 5, 4, 64, pmm::logging::NoLogging, AddrTree>;
+using MgrAddr     = pmm::PersistMemoryManager<AddrConfig, 440>;
+using MgrAddrMix  = pmm::PersistMemoryManager<AddrConfig, 441>;
+using MgrAddrSave = pmm::PersistMemoryManager<AddrConfig, 442>;
+using MgrAddrLoad = pmm::PersistMemoryManager<AddrConfig, 443>;
+using MgrAvlImage = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 444>;
+using MgrBestFit  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 445>;
+
+static const char* kAddrFile = "test_address_ordered_free_tree.dat";
+
+template <typename MgrT> static std::size_t listed_free_blocks()
+{
+    std::size_t    listed = 0;
+    std::ptrdiff_t last   = -1;
+    MgrT::for_each_free_block(
+        [&]( const pmm::FreeBlockView& v )
+        {
+            if ( v.avl_depth == 0 && v.offset > last )
+            {
+                ++listed;
+                last = v.offset;
+            }
+        } );
+    return listed;
+}
+
+template <typename MgrT> static std::vector<void*> punch_holes()
+{
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 40; ++i )
+        ptrs.push_back( MgrT::allocate( 64 ) );
+    MgrT::deallocate( ptrs[10] );
+    MgrT::deallocate( ptrs[11] );
+    MgrT::deallocate( ptrs[30] );
+    return ptrs;
+}
+
+TEST_CASE( "address-ordered tree returns the lowest fitting block", "[addr][free_tree]" )
+{
+    REQUIRE( MgrAddr::create( 64 * 1024 ) );
+    REQUIRE( MgrBestFit::create( 64 * 1024 ) );
+    std::vector<void*> first = punch_holes<MgrAddr>();
+    std::vector<void*> best  = punch_holes<MgrBestFit>();
+    REQUIRE( MgrAddr::verify().ok );
+    REQUIRE( listed_free_blocks<MgrAddr>() == MgrAddr::free_block_count() );
+
+    REQUIRE( MgrAddr::allocate( 40 ) == first[10] );
+    REQUIRE( MgrBestFit::allocate( 40 ) == best[30] );
+    void* tail = MgrAddr::allocate( 40 );
+    REQUIRE( tail > first[10] );
+    REQUIRE( tail < first[12] );
+    REQUIRE( MgrAddr::allocate( 40 ) == first[30] );
+    REQUIRE( MgrAddr::verify().ok );
+    MgrAddr::destroy();
+    MgrBestFit::destroy();
+}
+
+TEST_CASE( "address-ordered tree stays consistent under mixed workload", "[addr][free_tree]" )
+{
+    REQUIRE( MgrAddrMix::create( 64 * 1024 ) );
+    std::size_t                                 frees = MgrAddrMix::free_block_count();
+    std::vector<MgrAddrMix::pptr<std::uint8_t>> live;
+    std::uint32_t                               seed = 4242;
+    for ( int step = 0; step < 4000; ++step )
+    {
+        seed = seed * 1103515245U + 12345U;
+        if ( live.empty() || ( seed >> 16 ) % 3 != 0 )
+        {
+            std::size_t size = 16 + ( ( seed >> 8 ) % 300 ) * 8;
+            auto        p    = MgrAddrMix::allocate_typed<std::uint8_t>( size );
+            REQUIRE( !p.is_null() );
+            live.push_back( p );
+        }
+        else
+        {
+            std::size_t victim = ( seed >> 4 ) % live.size();
+            MgrAddrMix::deallocate_typed( live[victim] );
+            live[victim] = live.back();
+            live.pop_back();
+        }
+        if ( step % 500 == 0 )
+            REQUIRE( MgrAddrMix::verify().ok );
+    }
+    MgrAddrMix::deallocate_batch<std::uint8_t>( live );
+    REQUIRE( MgrAddrMix::verify().ok );
+    REQUIRE( MgrAddrMix::free_block_count() == frees );
+    MgrAddrMix::destroy();
+}
+
+TEST_CASE( "address-ordered tree survives save and load", "[addr][free_tree][persistence]" )
+{
+    REQUIRE( MgrAddrSave::create( 64 * 1024 ) );
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 16; ++i )
+        ptrs.push_back( MgrAddrSave::allocate( 100 + 64 * i ) );
+    for ( std::size_t i = 1; i < ptrs.size(); i += 2 )
+        MgrAddrSave::deallocate( ptrs[i] );
+    std::size_t free_blocks = MgrAddrSave::free_block_count();
+    REQUIRE( pmm::save_manager<MgrAddrSave>( kAddrFile ) );
+    MgrAddrSave::destroy();
+
+    REQUIRE( MgrAddrLoad::create( 64 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<MgrAddrLoad>( kAddrFile, vr ) );
+    REQUIRE( MgrAddrLoad::verify().ok );
+    REQUIRE( MgrAddrLoad::free_block_count() == free_blocks );
+    REQUIRE( listed_free_blocks<MgrAddrLoad>() == free_blocks );
+    REQUIRE( MgrAddrLoad::allocate( 100 ) != nullptr );
+    REQUIRE( MgrAddrLoad::verify().ok );
+    MgrAddrLoad::destroy();
+    std::remove( kAddrFile );
+}
+
+TEST_CASE( "address-ordered config rejects images without its reserve", "[addr][free_tree][persistence]" )
+{
+    REQUIRE( MgrAvlImage::create( 64 * 1024 ) );
+    REQUIRE( pmm::save_manager<MgrAvlImage>( kAddrFile ) );
+    MgrAvlImage::destroy();
+
+    REQUIRE( MgrAddrLoad::create( 64 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE_FALSE( pmm::load_manager_from_file<MgrAddrLoad>( kAddrFile, vr ) );
+    REQUIRE( MgrAddrLoad::last_error() == pmm::PmmError::UnsupportedImageVersion );
+    MgrAddrLoad::destroy();
+    std::remove( kAddrFile );
+}
+
+TEST_CASE( "verify reports a stale subtree maximum and load rebuilds it", "[addr][free_tree][verify]" )
+{
+    REQUIRE( MgrAddr::create( 64 * 1024 ) );
+    std::vector<void*> ptrs = punch_holes<MgrAddr>();
+    REQUIRE( MgrAddr::verify().ok );
+
+    std::uint8_t* base  = MgrAddr::backend().base_ptr();
+    auto*         hdr   = pmm::detail::manager_header_at<AT>( base );
+    auto*         table = reinterpret_cast<AddrTree::Table*>( pmm::detail::manager_header_reserve_at<AT>( hdr ) );
+    REQUIRE( table->root != AT::no_block );
+    auto* root = pmm::detail::block_at<AT>( base, table->root );
+    REQUIRE( AddrTree::subtree_max( root ) > 0 );
+    *static_cast<AT::index_type*>( pmm::detail::user_ptr<AT>( root ) ) = 0;
+
+    pmm::VerifyResult broken = MgrAddr::verify();
+    REQUIRE_FALSE( broken.ok );
+    bool stale = false;
+    for ( std::size_t i = 0; i < broken.entry_count; ++i )
+        stale = stale || broken.entries[i].type == pmm::ViolationType::FreeTreeStale;
+    REQUIRE( stale );
+
+    pmm::VerifyResult repaired;
+    REQUIRE( MgrAddr::load( repaired ) );
+    REQUIRE( MgrAddr::verify().ok );
+    REQUIRE( MgrAddr::allocate( 40 ) == ptrs[10] );
+    MgrAddr::destroy();
+}
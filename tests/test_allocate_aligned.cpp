@@ -0,0 +1,150 @@
+/**
+ * @file test_allocate_aligned.cpp
+ * @brief allocate_aligned() / allocate_typed_aligned<T>(): cache-line and page aligned blocks.
+ *
+ *   - A misaligned free block is split: the leading fragment stays free, so no space is lost.
+ *   - verify() accepts the layout; deallocation coalesces the fragment back.
+ */
+
+#include "pmm/io.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using MgrAlign      = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 450>;
+using MgrAlignTyped = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 451>;
+using MgrAlignLoad  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 452>;
+using MgrAlignArena = pmm::PersistMemoryManager<pmm::ArenaConfig<pmm::PersistentDataConfig, 2>, 453>;
+
+static const char* kAlignFile = "test_allocate_aligned.dat";
+
+static bool aligned_to( const void* p, std::size_t align )
+{
+    return reinterpret_cast<std::uintptr_t>( p ) % align == 0;
+}
+
+TEST_CASE( "allocate_aligned returns cache-line and page aligned blocks", "[aligned]" )
+{
+    REQUIRE( MgrAlign::create( 256 * 1024 ) );
+    std::size_t allocs = MgrAlign::alloc_block_count();
+    std::size_t frees  = MgrAlign::free_block_count();
+    std::size_t used   = MgrAlign::used_size();
+
+    constexpr std::size_t kHdr     = sizeof( pmm::Block<pmm::DefaultAddressTraits> );
+    std::size_t           expected = 0;
+    std::vector<void*>    ptrs;
+    for ( std::size_t align : { 32, 64, 256, 4096 } )
+    {
+        for ( int i = 0; i < 4; ++i )
+        {
+            ptrs.push_back( MgrAlign::allocate( 24 ) );
+            expected += kHdr + 32 + kHdr + ( 100 + 40 * i + 15 ) / 16 * 16;
+            void* p = MgrAlign::allocate_aligned( 100 + 40 * i, align );
+            REQUIRE( p != nullptr );
+            REQUIRE( aligned_to( p, align ) );
+            std::memset( p, 0x5A, 100 + 40 * i );
+            ptrs.push_back( p );
+        }
+    }
+    REQUIRE( MgrAlign::verify().ok );
+    // Leading fragments stay free: only their headers are accounted as used.
+    REQUIRE( MgrAlign::used_size() - used == expected + ( MgrAlign::free_block_count() - frees ) * kHdr );
+
+    for ( void* p : ptrs )
+        MgrAlign::deallocate( p );
+    REQUIRE( MgrAlign::alloc_block_count() == allocs );
+    REQUIRE( MgrAlign::free_block_count() == frees );
+    REQUIRE( MgrAlign::verify().ok );
+    MgrAlign::destroy();
+}
+
+TEST_CASE( "allocate_aligned by offset aligns the image offset", "[aligned]" )
+{
+    REQUIRE( MgrAlign::create( 256 * 1024 ) );
+    std::vector<void*> ptrs;
+    for ( std::size_t align : { 64, 1024, 16384 } )
+    {
+        ptrs.push_back( MgrAlign::allocate( 24 ) );
+        void* p = MgrAlign::allocate_aligned( 200, align, true );
+        REQUIRE( p != nullptr );
+        REQUIRE( static_cast<std::size_t>( static_cast<std::uint8_t*>( p ) - MgrAlign::backend().base_ptr() ) % align ==
+                 0 );
+        ptrs.push_back( p );
+    }
+    REQUIRE( MgrAlign::verify().ok );
+    for ( void* p : ptrs )
+        MgrAlign::deallocate( p );
+    REQUIRE( MgrAlign::verify().ok );
+    MgrAlign::destroy();
+}
+
+TEST_CASE( "allocate_aligned validates the alignment", "[aligned]" )
+{
+    REQUIRE( MgrAlign::create( 64 * 1024 ) );
+    REQUIRE( MgrAlign::allocate_aligned( 64, 0 ) == nullptr );
+    REQUIRE( MgrAlign::last_error() == pmm::PmmError::InvalidSize );
+    REQUIRE( MgrAlign::allocate_aligned( 64, 48 ) == nullptr );
+    REQUIRE( MgrAlign::last_error() == pmm::PmmError::InvalidSize );
+    REQUIRE( MgrAlign::allocate_aligned( 0, 64 ) == nullptr );
+    REQUIRE( MgrAlign::last_error() == pmm::PmmError::InvalidSize );
+
+    void* small = MgrAlign::allocate_aligned( 64, 8 );
+    REQUIRE( small != nullptr );
+    REQUIRE( aligned_to( small, 16 ) );
+    MgrAlign::deallocate( small );
+    REQUIRE( MgrAlign::verify().ok );
+    MgrAlign::destroy();
+}
+
+TEST_CASE( "allocate_typed_aligned keeps page alignment across save and load", "[aligned][persistence]" )
+{
+    REQUIRE( MgrAlignTyped::create( 64 * 1024 ) );
+    REQUIRE( MgrAlignTyped::allocate( 40 ) != nullptr );
+    auto page = MgrAlignTyped::allocate_typed_aligned<float>( 1024, 4096 );
+    REQUIRE( !page.is_null() );
+    REQUIRE( aligned_to( page.resolve(), 4096 ) );
+    for ( int i = 0; i < 1024; ++i )
+        page.resolve()[i] = static_cast<float>( i );
+    auto lines = MgrAlignTyped::allocate_typed_aligned<std::uint64_t>( 3, 64 );
+    REQUIRE( !lines.is_null() );
+    REQUIRE( aligned_to( lines.resolve(), 64 ) );
+    REQUIRE( MgrAlignTyped::allocate_typed_aligned<std::uint64_t>( 0, 64 ).is_null() );
+    REQUIRE( MgrAlignTyped::verify().ok );
+    REQUIRE( pmm::save_manager<MgrAlignTyped>( kAlignFile ) );
+    auto offset = page.offset();
+    MgrAlignTyped::destroy();
+
+    REQUIRE( MgrAlignLoad::create( 64 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<MgrAlignLoad>( kAlignFile, vr ) );
+    MgrAlignLoad::pptr<float> loaded( offset );
+    REQUIRE( aligned_to( loaded.resolve(), 4096 ) );
+    REQUIRE( loaded.resolve()[1023] == 1023.0f );
+    REQUIRE( MgrAlignLoad::verify().ok );
+    MgrAlignLoad::destroy();
+    std::remove( kAlignFile );
+}
+
+TEST_CASE( "allocate_aligned works with sub-arenas and heap growth", "[aligned][arena]" )
+{
+    REQUIRE( MgrAlignArena::create( 64 * 1024 ) );
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 64; ++i )
+    {
+        ptrs.push_back( MgrAlignArena::allocate( 16 + i ) );
+        void* p = MgrAlignArena::allocate_aligned( 1000, 4096 );
+        REQUIRE( p != nullptr );
+        REQUIRE( aligned_to( p, 4096 ) );
+        ptrs.push_back( p );
+    }
+    REQUIRE( MgrAlignArena::verify().ok );
+    for ( void* p : ptrs )
+        MgrAlignArena::deallocate( p );
+    REQUIRE( MgrAlignArena::verify().ok );
+    MgrAlignArena::destroy();
+}
@@ -0,0 +1,119 @@
+/**
+ * @file test_allocate_batch.cpp
+ * @brief allocate_batch<T>(): bulk allocation of same-size blocks under one lock.
+ *
+ *   - A run is carved from one free block with a single free-tree update.
+ *   - Fragmented heaps fall back to per-block allocation; failures release the partial batch.
+ */
+
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using MgrBatch     = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 410>;
+using MgrBatchFrag = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 411>;
+using MgrBatchErr  = pmm::PersistMemoryManager<pmm::EmbeddedStaticConfig<16384>, 412>;
+using MgrBatchMT   = pmm::PersistMemoryManager<pmm::ArenaConfig<pmm::PersistentDataConfig, 2>, 413>;
+
+struct Record
+{
+    std::uint64_t id;
+    std::uint32_t payload[5];
+};
+
+TEST_CASE( "allocate_batch carves a contiguous run from one free block", "[batch]" )
+{
+    REQUIRE( MgrBatch::create( 1024 * 1024 ) );
+    std::size_t allocs = MgrBatch::alloc_block_count();
+    std::size_t frees  = MgrBatch::free_block_count();
+
+    std::vector<MgrBatch::pptr<Record>> recs( 1000 );
+    REQUIRE( MgrBatch::allocate_batch<Record>( recs ) );
+    REQUIRE( MgrBatch::last_error() == pmm::PmmError::Ok );
+    REQUIRE( MgrBatch::alloc_block_count() == allocs + 1000 );
+    REQUIRE( MgrBatch::free_block_count() == frees );
+    for ( std::size_t i = 0; i < recs.size(); ++i )
+    {
+        REQUIRE( !recs[i].is_null() );
+        recs[i]->id = i;
+        if ( i > 0 )
+            REQUIRE( recs[i].offset() > recs[i - 1].offset() );
+    }
+    REQUIRE( MgrBatch::verify().ok );
+    for ( std::size_t i = 0; i < recs.size(); ++i )
+        REQUIRE( recs[i]->id == i );
+
+    for ( auto p : recs )
+        MgrBatch::deallocate_typed( p );
+    REQUIRE( MgrBatch::alloc_block_count() == allocs );
+    REQUIRE( MgrBatch::free_block_count() == frees );
+    REQUIRE( MgrBatch::verify().ok );
+    MgrBatch::destroy();
+}
+
+TEST_CASE( "allocate_batch falls back to single blocks when the heap is fragmented", "[batch]" )
+{
+    REQUIRE( MgrBatchFrag::create( 64 * 1024 ) );
+    std::vector<void*> pins;
+    for ( int i = 0; i < 200; ++i )
+        pins.push_back( MgrBatchFrag::allocate( 48 ) );
+    for ( std::size_t i = 0; i < pins.size(); i += 2 )
+        MgrBatchFrag::deallocate( pins[i] );
+    std::size_t allocs = MgrBatchFrag::alloc_block_count();
+
+    std::vector<MgrBatchFrag::pptr<std::uint8_t>> blocks( 4000 );
+    REQUIRE( MgrBatchFrag::allocate_batch<std::uint8_t>( blocks, 40 ) );
+    REQUIRE( MgrBatchFrag::alloc_block_count() == allocs + blocks.size() );
+    for ( auto p : blocks )
+    {
+        REQUIRE( !p.is_null() );
+        std::memset( p.resolve(), 0xAB, 40 );
+    }
+    REQUIRE( MgrBatchFrag::verify().ok );
+    for ( auto p : blocks )
+        MgrBatchFrag::deallocate_typed( p );
+    REQUIRE( MgrBatchFrag::alloc_block_count() == allocs );
+    REQUIRE( MgrBatchFrag::verify().ok );
+    MgrBatchFrag::destroy();
+}
+
+TEST_CASE( "allocate_batch reports errors and leaves every slot null", "[batch]" )
+{
+    std::vector<MgrBatchErr::pptr<int>> out( 8 );
+    REQUIRE_FALSE( MgrBatchErr::allocate_batch<int>( out ) );
+    REQUIRE( MgrBatchErr::last_error() == pmm::PmmError::NotInitialized );
+
+    REQUIRE( MgrBatchErr::create( 16384 ) );
+    REQUIRE_FALSE( MgrBatchErr::allocate_batch<int>( out, 0 ) );
+    REQUIRE( MgrBatchErr::last_error() == pmm::PmmError::InvalidSize );
+    REQUIRE( MgrBatchErr::allocate_batch<int>( std::span<MgrBatchErr::pptr<int>>() ) );
+
+    std::size_t                                  allocs = MgrBatchErr::alloc_block_count();
+    std::vector<MgrBatchErr::pptr<std::uint8_t>> big( 64 );
+    REQUIRE_FALSE( MgrBatchErr::allocate_batch<std::uint8_t>( big, 512 ) );
+    REQUIRE( MgrBatchErr::last_error() == pmm::PmmError::OutOfMemory );
+    for ( auto p : big )
+        REQUIRE( p.is_null() );
+    REQUIRE( MgrBatchErr::alloc_block_count() == allocs );
+    REQUIRE( MgrBatchErr::verify().ok );
+    MgrBatchErr::destroy();
+}
+
+TEST_CASE( "allocate_batch works with sub-arenas", "[batch][arena]" )
+{
+    REQUIRE( MgrBatchMT::create( 256 * 1024 ) );
+    std::size_t                           allocs = MgrBatchMT::alloc_block_count();
+    std::vector<MgrBatchMT::pptr<Record>> recs( 500 );
+    REQUIRE( MgrBatchMT::allocate_batch<Record>( recs ) );
+    REQUIRE( MgrBatchMT::alloc_block_count() == allocs + 500 );
+    REQUIRE( MgrBatchMT::verify().ok );
+    for ( auto p : recs )
+        MgrBatchMT::deallocate_typed( p );
+    REQUIRE( MgrBatchMT::alloc_block_count() == allocs );
+    REQUIRE( MgrBatchMT::verify().ok );
+    MgrBatchMT::destroy();
+}
@@ -0,0 +1,191 @@
+/**
+ * @file test_arena_mode.cpp
+ * @brief ArenaConfig: lock-striped sub-arenas inside one persistent image.
+ *
+ *   - The heap is split into N regions, each with its own free tree and lock.
+ *   - Frees are routed to the owning arena; counters, verify(), load() and growth see the whole image.
+ */
+
+#include "pmm/io.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using ArenaCfg       = pmm::ArenaConfig<pmm::PersistentDataConfig, 4>;
+using MgrArena       = pmm::PersistMemoryManager<ArenaCfg, 400>;
+using MgrArenaMT     = pmm::PersistMemoryManager<ArenaCfg, 401>;
+using MgrArenaSaved  = pmm::PersistMemoryManager<ArenaCfg, 402>;
+using MgrArenaLoaded = pmm::PersistMemoryManager<ArenaCfg, 403>;
+using MgrArenaGrow   = pmm::PersistMemoryManager<ArenaCfg, 404>;
+using MgrSingle      = pmm::PersistMemoryManager<pmm::PersistentDataConfig, 405>;
+
+static const char* kArenaFile = "test_arena_mode.dat";
+
+static_assert( MgrArena::kArenaMode && MgrArena::kArenaCount == 4 );
+static_assert( !MgrSingle::kArenaMode );
+
+TEST_CASE( "arena mode splits the heap into fenced regions", "[arena]" )
+{
+    REQUIRE( MgrArena::create( 64 * 1024 ) );
+    REQUIRE( MgrArena::verify().ok );
+    REQUIRE( MgrArena::free_block_count() >= 4 );
+    std::size_t locked = 0;
+    MgrArena::for_each_block(
+        [&]( const pmm::BlockView& v )
+        {
+            if ( v.used && v.user_size == pmm::DefaultAddressTraits::granule_size )
+                ++locked;
+        } );
+    REQUIRE( locked >= 3 );
+
+    std::size_t        baseline = MgrArena::alloc_block_count();
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 64; ++i )
+    {
+        void* p = MgrArena::allocate( 96 );
+        REQUIRE( p != nullptr );
+        std::memset( p, i, 96 );
+        ptrs.push_back( p );
+    }
+    REQUIRE( MgrArena::alloc_block_count() == baseline + 64 );
+    REQUIRE( MgrArena::verify().ok );
+    for ( void* p : ptrs )
+        MgrArena::deallocate( p );
+    REQUIRE( MgrArena::alloc_block_count() == baseline );
+    REQUIRE( MgrArena::verify().ok );
+    MgrArena::destroy();
+}
+
+TEST_CASE( "arena mode frees cross-thread blocks into the owning arena", "[arena][threads]" )
+{
+    REQUIRE( MgrArenaMT::create( 512 * 1024 ) );
+    std::size_t                             baseline = MgrArenaMT::alloc_block_count();
+    std::vector<MgrArenaMT::pptr<uint32_t>> handoff( 4 * 200 );
+    std::atomic<int>                        failures{ 0 };
+    std::vector<std::thread>                threads;
+    for ( int t = 0; t < 4; ++t )
+    {
+        threads.emplace_back(
+            [t, &handoff, &failures]()
+            {
+                std::uint32_t seed = 99U + static_cast<std::uint32_t>( t );
+                for ( int i = 0; i < 200; ++i )
+                {
+                    seed   = seed * 1103515245U + 12345U;
+                    auto p = MgrArenaMT::allocate_typed<uint32_t>( 1 + ( seed >> 8 ) % 48 );
+                    if ( p.is_null() )
+                    {
+                        ++failures;
+                        continue;
+                    }
+                    *p                   = static_cast<uint32_t>( t );
+                    handoff[t * 200 + i] = p;
+                    void* scratch        = MgrArenaMT::allocate( 16 + ( seed >> 4 ) % 200 );
+                    MgrArenaMT::deallocate( scratch );
+                }
+            } );
+    }
+    for ( auto& th : threads )
+        th.join();
+    threads.clear();
+    REQUIRE( failures.load() == 0 );
+    REQUIRE( MgrArenaMT::verify().ok );
+    for ( int t = 0; t < 4; ++t )
+    {
+        threads.emplace_back(
+            [t, &handoff]()
+            {
+                int victim = ( t + 1 ) % 4;
+                for ( int i = 0; i < 200; ++i )
+                    MgrArenaMT::deallocate_typed( handoff[victim * 200 + i] );
+            } );
+    }
+    for ( auto& th : threads )
+        th.join();
+    REQUIRE( MgrArenaMT::alloc_block_count() == baseline );
+    REQUIRE( MgrArenaMT::verify().ok );
+    MgrArenaMT::destroy();
+}
+
+TEST_CASE( "arena images survive save and load", "[arena][persistence]" )
+{
+    REQUIRE( MgrArenaSaved::create( 64 * 1024 ) );
+    auto keep = MgrArenaSaved::allocate_typed<uint64_t>( 8 );
+    REQUIRE( !keep.is_null() );
+    for ( int i = 0; i < 8; ++i )
+        keep.resolve()[i] = static_cast<uint64_t>( i * 7 );
+    MgrArenaSaved::set_root( keep );
+    std::size_t allocs = MgrArenaSaved::alloc_block_count();
+    std::size_t frees  = MgrArenaSaved::free_block_count();
+    REQUIRE( pmm::save_manager<MgrArenaSaved>( kArenaFile ) );
+    MgrArenaSaved::destroy();
+
+    REQUIRE( MgrArenaLoaded::create( 64 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<MgrArenaLoaded>( kArenaFile, vr ) );
+    REQUIRE( MgrArenaLoaded::verify().ok );
+    REQUIRE( MgrArenaLoaded::alloc_block_count() == allocs );
+    REQUIRE( MgrArenaLoaded::free_block_count() == frees );
+    auto root = MgrArenaLoaded::get_root<uint64_t>();
+    REQUIRE( !root.is_null() );
+    REQUIRE( root.resolve()[7] == 49 );
+    MgrArenaLoaded::deallocate( MgrArenaLoaded::allocate( 200 ) );
+    REQUIRE( MgrArenaLoaded::verify().ok );
+    MgrArenaLoaded::destroy();
+    std::remove( kArenaFile );
+}
+
+TEST_CASE( "arena config rejects single-arena images and repairs its own on load", "[arena][persistence][verify]" )
+{
+    REQUIRE( MgrSingle::create( 64 * 1024 ) );
+    REQUIRE( pmm::save_manager<MgrSingle>( kArenaFile ) );
+    MgrSingle::destroy();
+    REQUIRE( MgrArenaLoaded::create( 64 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE_FALSE( pmm::load_manager_from_file<MgrArenaLoaded>( kArenaFile, vr ) );
+    REQUIRE( MgrArenaLoaded::last_error() == pmm::PmmError::UnsupportedImageVersion );
+    MgrArenaLoaded::destroy();
+    std::remove( kArenaFile );
+
+    REQUIRE( MgrArena::create( 64 * 1024 ) );
+    void* p = MgrArena::allocate( 64 );
+    REQUIRE( p != nullptr );
+    auto* base = MgrArena::backend().base_ptr();
+    auto* hdr  = pmm::detail::manager_header_at<pmm::DefaultAddressTraits>( base );
+    auto* subs = reinterpret_cast<pmm::detail::ManagerHeader<pmm::DefaultAddressTraits>*>(
+        pmm::detail::manager_header_reserve_at<pmm::DefaultAddressTraits>( hdr ) );
+    subs[2].free_tree_root = pmm::DefaultAddressTraits::no_block;
+    REQUIRE_FALSE( MgrArena::verify().ok );
+    pmm::VerifyResult repaired;
+    REQUIRE( MgrArena::load( repaired ) );
+    REQUIRE( MgrArena::verify().ok );
+    MgrArena::deallocate( p );
+    REQUIRE( MgrArena::verify().ok );
+    MgrArena::destroy();
+}
+
+TEST_CASE( "arena mode grows the last arena", "[arena][expand]" )
+{
+    REQUIRE( MgrArenaGrow::create( 16 * 1024 ) );
+    std::size_t        initial = MgrArenaGrow::total_size();
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 64; ++i )
+    {
+        void* p = MgrArenaGrow::allocate( 512 );
+        REQUIRE( p != nullptr );
+        ptrs.push_back( p );
+    }
+    REQUIRE( MgrArenaGrow::total_size() > initial );
+    REQUIRE( MgrArenaGrow::verify().ok );
+    for ( void* p : ptrs )
+        MgrArenaGrow::deallocate( p );
+    REQUIRE( MgrArenaGrow::verify().ok );
+    MgrArenaGrow::destroy();
+}
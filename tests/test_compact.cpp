@@ -0,0 +1,274 @@
+/**
+ * @file test_compact.cpp
+ * @brief compact_step(): incremental sliding compaction with pptr fix-up for built-in containers.
+ *
+ *   - pmap nodes and parray/pstring data blocks slide down into lower holes; links and `_data_idx` are rewritten.
+ *   - Blocks without a known owner stay in place; the callback reports every move as a forwarding pair.
+ *   - Work is split into time-budgeted slices that resume where the previous one stopped; create() and
+ *     load() start a new pass.
+ *   - Container data owners are indexed once per slice, so zero-budget slices still make progress.
+ */
+
+#include "pmm/io.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+using MgrCompact      = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 460>;
+using MgrCompactArr   = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 461>;
+using MgrCompactSlice = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 462>;
+using MgrCompactSave  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 463>;
+using MgrCompactLoad  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 464>;
+using MgrCompactData  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 465>;
+
+static const char* kCompactFile = "test_compact.dat";
+
+static constexpr std::chrono::nanoseconds kUnbounded = std::chrono::seconds( 10 );
+
+template <typename MgrT> static std::size_t highest_used_offset()
+{
+    std::size_t highest = 0;
+    MgrT::for_each_block(
+        [&]( const pmm::BlockView& v )
+        {
+            if ( v.used )
+                highest = static_cast<std::size_t>( v.offset );
+        } );
+    return highest;
+}
+
+TEST_CASE( "compact_step slides pmap nodes down and keeps the tree intact", "[compact][pmap]" )
+{
+    REQUIRE( MgrCompact::create( 256 * 1024 ) );
+    MgrCompact::pmap<int, int> map( "compact" );
+    std::vector<void*>         fillers;
+    for ( int i = 0; i < 400; ++i )
+    {
+        fillers.push_back( MgrCompact::allocate( 48 + ( i % 5 ) * 16 ) );
+        REQUIRE( !map.insert( ( i * 7919 ) % 1000, i ).is_null() );
+    }
+    for ( void* p : fillers )
+        MgrCompact::deallocate( p );
+    MgrCompact::flush_thread_caches();
+    std::size_t frees   = MgrCompact::free_block_count();
+    std::size_t used    = MgrCompact::used_size();
+    std::size_t highest = highest_used_offset<MgrCompact>();
+    REQUIRE( frees > 100 );
+
+    std::map<std::size_t, std::size_t> forward;
+    pmm::CompactResult                 r = MgrCompact::compact_step(
+        kUnbounded, [&]( MgrCompact::index_type from, MgrCompact::index_type to ) { forward[from] = to; } );
+    REQUIRE( r.complete );
+    REQUIRE( r.moved_blocks == forward.size() );
+    REQUIRE( r.moved_blocks >= 300 );
+    REQUIRE( r.moved_bytes > 0 );
+    for ( const auto& [from, to] : forward )
+        REQUIRE( to < from );
+
+    REQUIRE( MgrCompact::verify().ok );
+    // Merged holes give their headers back; nothing else changes size.
+    constexpr std::size_t kHdr = sizeof( pmm::Block<pmm::DefaultAddressTraits> );
+    REQUIRE( MgrCompact::free_block_count() < frees / 10 );
+    REQUIRE( used - MgrCompact::used_size() == ( frees - MgrCompact::free_block_count() ) * kHdr );
+    REQUIRE( highest_used_offset<MgrCompact>() < highest );
+    REQUIRE( map.size() == 400 );
+    for ( int i = 0; i < 400; ++i )
+    {
+        auto node = map.find( ( i * 7919 ) % 1000 );
+        REQUIRE( !node.is_null() );
+        REQUIRE( node->value == i );
+    }
+    REQUIRE( map.erase( 0 ) );
+    REQUIRE( !map.insert( 5000, 1 ).is_null() );
+    REQUIRE( MgrCompact::verify().ok );
+
+    pmm::CompactResult again = MgrCompact::compact_step( kUnbounded );
+    REQUIRE( again.complete );
+    REQUIRE( again.moved_blocks == 0 );
+    MgrCompact::destroy();
+}
+
+TEST_CASE( "compact_step rewrites parray and pstring data offsets", "[compact][parray][pstring]" )
+{
+    REQUIRE( MgrCompactArr::create( 256 * 1024 ) );
+    std::vector<MgrCompactArr::pptr<MgrCompactArr::parray<int>>> arrays;
+    std::vector<MgrCompactArr::pptr<MgrCompactArr::pstring>>     strings;
+    std::vector<void*>                                           pinned;
+    std::vector<void*>                                           holes;
+    for ( int i = 0; i < 32; ++i )
+    {
+        holes.push_back( MgrCompactArr::allocate( 512 ) );
+        pinned.push_back( MgrCompactArr::allocate( 24 ) );
+        arrays.push_back( MgrCompactArr::create_typed<MgrCompactArr::parray<int>>() );
+        strings.push_back( MgrCompactArr::create_typed<MgrCompactArr::pstring>() );
+        holes.push_back( MgrCompactArr::allocate( 256 ) );
+        for ( int k = 0; k < 20 + i; ++k )
+            REQUIRE( arrays.back()->push_back( i * 100 + k ) );
+        REQUIRE( strings.back()->assign( "persistent string payload" ) );
+        REQUIRE( strings.back()->append( i % 2 == 0 ? "-even" : "-odd" ) );
+    }
+    for ( void* p : holes )
+        MgrCompactArr::deallocate( p );
+    std::vector<const void*> pinned_before( pinned.begin(), pinned.end() );
+
+    pmm::CompactResult r = MgrCompactArr::compact_step( kUnbounded );
+    REQUIRE( r.complete );
+    REQUIRE( r.moved_blocks >= 64 );
+    REQUIRE( MgrCompactArr::verify().ok );
+    for ( std::size_t i = 0; i < pinned.size(); ++i )
+        REQUIRE( pinned[i] == pinned_before[i] );
+    for ( int i = 0; i < 32; ++i )
+    {
+        REQUIRE( arrays[i]->size() == static_cast<std::size_t>( 20 + i ) );
+        for ( int k = 0; k < 20 + i; ++k )
+            REQUIRE( *arrays[i]->at( k ) == i * 100 + k );
+        REQUIRE( *strings[i] == ( i % 2 == 0 ? "persistent string payload-even" : "persistent string payload-odd" ) );
+        REQUIRE( arrays[i]->push_back( -1 ) );
+        REQUIRE( strings[i]->append( "!" ) );
+    }
+    REQUIRE( MgrCompactArr::verify().ok );
+    MgrCompactArr::destroy();
+}
+
+TEST_CASE( "compact_step resumes across budgeted slices", "[compact][slices]" )
+{
+    REQUIRE( MgrCompactSlice::create( 256 * 1024 ) );
+    MgrCompactSlice::pmap<int, std::uint64_t> map( "slices" );
+    std::vector<void*>                        fillers;
+    for ( int i = 0; i < 300; ++i )
+    {
+        fillers.push_back( MgrCompactSlice::allocate( 80 ) );
+        REQUIRE( !map.insert( i, static_cast<std::uint64_t>( i ) * 3 ).is_null() );
+    }
+    for ( void* p : fillers )
+        MgrCompactSlice::deallocate( p );
+
+    std::size_t slices = 0;
+    std::size_t moved  = 0;
+    for ( ;; )
+    {
+        pmm::CompactResult r = MgrCompactSlice::compact_step( std::chrono::nanoseconds( 0 ) );
+        moved += r.moved_blocks;
+        ++slices;
+        REQUIRE( MgrCompactSlice::verify().ok );
+        if ( r.complete )
+            break;
+        REQUIRE( r.moved_blocks <= 1 );
+        REQUIRE( slices < 10000 );
+    }
+    REQUIRE( slices > 1 );
+    REQUIRE( moved >= 299 );
+    for ( int i = 0; i < 300; ++i )
+        REQUIRE( map.find( i )->value == static_cast<std::uint64_t>( i ) * 3 );
+    REQUIRE( MgrCompactSlice::compact_step( kUnbounded ).moved_blocks == 0 );
+    MgrCompactSlice::destroy();
+}
+
+TEST_CASE( "create restarts an unfinished compaction pass", "[compact][slices]" )
+{
+    auto fill = []( MgrCompactSlice::pmap<int, int>& map )
+    {
+        std::vector<void*> fillers;
+        for ( int i = 0; i < 300; ++i )
+        {
+            fillers.push_back( MgrCompactSlice::allocate( 80 ) );
+            REQUIRE( !map.insert( i, i ).is_null() );
+        }
+        for ( void* p : fillers )
+            MgrCompactSlice::deallocate( p );
+    };
+    REQUIRE( MgrCompactSlice::create( 256 * 1024 ) );
+    {
+        MgrCompactSlice::pmap<int, int> map( "restart" );
+        fill( map );
+        std::size_t moved = 0;
+        while ( moved < 200 )
+        {
+            pmm::CompactResult r = MgrCompactSlice::compact_step( std::chrono::nanoseconds( 0 ) );
+            REQUIRE_FALSE( r.complete );
+            moved += r.moved_blocks;
+        }
+    }
+    MgrCompactSlice::destroy();
+
+    REQUIRE( MgrCompactSlice::create( 256 * 1024 ) );
+    MgrCompactSlice::pmap<int, int> map( "restart" );
+    fill( map );
+    REQUIRE( MgrCompactSlice::compact_step( kUnbounded ).moved_blocks >= 299 );
+    REQUIRE( MgrCompactSlice::verify().ok );
+    MgrCompactSlice::destroy();
+}
+
+TEST_CASE( "compact_step moves container data across zero-budget slices", "[compact][slices][parray]" )
+{
+    REQUIRE( MgrCompactData::create( 512 * 1024 ) );
+    std::vector<MgrCompactData::pptr<MgrCompactData::parray<int>>> arrays;
+    std::vector<void*>                                             holes;
+    for ( int i = 0; i < 200; ++i )
+    {
+        arrays.push_back( MgrCompactData::create_typed<MgrCompactData::parray<int>>() );
+        holes.push_back( MgrCompactData::allocate( 64 ) );
+        REQUIRE( arrays.back()->push_back( i ) );
+    }
+    for ( void* p : holes )
+        MgrCompactData::deallocate( p );
+
+    std::size_t slices = 0;
+    std::size_t moved  = 0;
+    for ( ;; )
+    {
+        pmm::CompactResult r = MgrCompactData::compact_step( std::chrono::nanoseconds( 0 ) );
+        moved += r.moved_blocks;
+        ++slices;
+        if ( r.complete )
+            break;
+        REQUIRE( r.moved_blocks <= 1 );
+        REQUIRE( slices < 10000 );
+    }
+    REQUIRE( moved >= 199 );
+    REQUIRE( MgrCompactData::verify().ok );
+    for ( int i = 0; i < 200; ++i )
+        REQUIRE( *arrays[i]->at( 0 ) == i );
+    MgrCompactData::destroy();
+}
+
+TEST_CASE( "compacted image survives save and load", "[compact][persistence]" )
+{
+    REQUIRE( MgrCompactSave::create( 128 * 1024 ) );
+    MgrCompactSave::pmap<int, int> map( "persisted" );
+    std::vector<void*>             fillers;
+    for ( int i = 0; i < 100; ++i )
+    {
+        fillers.push_back( MgrCompactSave::allocate( 200 ) );
+        REQUIRE( !map.insert( i, -i ).is_null() );
+    }
+    for ( void* p : fillers )
+        MgrCompactSave::deallocate( p );
+    REQUIRE( MgrCompactSave::compact_step( kUnbounded ).complete );
+    REQUIRE( pmm::save_manager<MgrCompactSave>( kCompactFile ) );
+    MgrCompactSave::destroy();
+
+    REQUIRE( MgrCompactLoad::create( 128 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<MgrCompactLoad>( kCompactFile, vr ) );
+    REQUIRE( MgrCompactLoad::verify().ok );
+    MgrCompactLoad::pmap<int, int> loaded( "persisted" );
+    REQUIRE( loaded.size() == 100 );
+    for ( int i = 0; i < 100; ++i )
+        REQUIRE( loaded.find( i )->value == -i );
+    MgrCompactLoad::destroy();
+    std::remove( kCompactFile );
+}
+
+TEST_CASE( "compact_step requires an initialized manager", "[compact]" )
+{
+    pmm::CompactResult r = MgrCompactLoad::compact_step( kUnbounded );
+    REQUIRE_FALSE( r.complete );
+    REQUIRE( MgrCompactLoad::last_error() == pmm::PmmError::NotInitialized );
+}
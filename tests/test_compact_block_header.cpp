@@ -0,0 +1,203 @@
+/**
+ * @file test_compact_block_header.cpp
+ * @brief CompactAddressTraits: 16-byte block headers with tree links kept in the block payload.
+ *
+ *   - A 16-byte allocation occupies 32 bytes instead of 48.
+ *   - Free-block trees keep their links at the start of the free payload; pmap/pstringview nodes reserve a
+ *     trailing slot through allocate_tree_node().
+ *   - Every free-tree policy, the built-in containers, compaction, shrink and save/load work unchanged.
+ *   - Tree-link setters never write into the payload of an allocated block, and the thread cache accepts
+ *     compact blocks whatever their trailing bytes hold.
+ */
+
+#include "pmm/io.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+using CAT = pmm::CompactAddressTraits;
+template <typename FreeTreeT>
+using CompactConfig = pmm::BasicConfig<CAT, pmm::config::NoLock, 5, 4, 64, pmm::logging::NoLogging, FreeTreeT>;
+using MgrCompactAvl   = pmm::PersistMemoryManager<CompactConfig<pmm::AvlFreeTree<CAT>>, 490>;
+using MgrCompactTlsf  = pmm::PersistMemoryManager<CompactConfig<pmm::TlsfFreeTree<CAT>>, 491>;
+using MgrCompactAddr  = pmm::PersistMemoryManager<CompactConfig<pmm::AddressOrderedFreeTree<CAT>>, 492>;
+using MgrCompactClass = pmm::PersistMemoryManager<CompactConfig<pmm::SizeClassFreeTree<CAT>>, 493>;
+using MgrCompactLoad  = pmm::PersistMemoryManager<CompactConfig<pmm::AvlFreeTree<CAT>>, 494>;
+using MgrFullLoad     = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 495>;
+using CompactCachedConfig = pmm::ThreadCachedConfig<pmm::BasicConfig<CAT, pmm::config::SharedMutexLock, 5, 4, 64>,
+                                                    pmm::config::ThreadCache<64, 8, 4>>;
+using MgrCompactCached    = pmm::PersistMemoryManager<CompactCachedConfig, 496>;
+
+const char* kCompactHeaderFile = "test_compact_block_header.dat";
+
+template <typename MgrT> std::ptrdiff_t small_block_stride()
+{
+    auto* a = static_cast<std::uint8_t*>( MgrT::allocate( 16 ) );
+    auto* b = static_cast<std::uint8_t*>( MgrT::allocate( 16 ) );
+    REQUIRE( a != nullptr );
+    REQUIRE( b != nullptr );
+    std::ptrdiff_t stride = b - a;
+    MgrT::deallocate( b );
+    MgrT::deallocate( a );
+    return stride;
+}
+
+template <typename MgrT> void exercise_compact_manager()
+{
+    REQUIRE( MgrT::create( 128 * 1024 ) );
+    typename MgrT::template pmap<int, std::uint64_t> map( "compact" );
+    std::vector<void*>                               fillers;
+    for ( int i = 0; i < 400; ++i )
+    {
+        REQUIRE( !map.insert( ( i * 37 ) % 400, static_cast<std::uint64_t>( i ) ).is_null() );
+        fillers.push_back( MgrT::allocate( 8 + static_cast<std::size_t>( i % 7 ) * 24 ) );
+    }
+    for ( std::size_t i = 0; i < fillers.size(); i += 2 )
+        MgrT::deallocate( fillers[i] );
+    for ( int i = 0; i < 400; i += 3 )
+        REQUIRE( map.erase( ( i * 37 ) % 400 ) );
+    for ( int i = 0; i < 400; ++i )
+    {
+        auto node = map.find( ( i * 37 ) % 400 );
+        REQUIRE( node.is_null() == ( i % 3 == 0 ) );
+        if ( !node.is_null() )
+            REQUIRE( node->value == static_cast<std::uint64_t>( i ) );
+    }
+
+    auto arr = MgrT::template create_typed<typename MgrT::template parray<std::uint32_t>>();
+    auto str = MgrT::template create_typed<typename MgrT::pstring>();
+    for ( std::uint32_t i = 0; i < 100; ++i )
+        REQUIRE( arr->push_back( i * 5 ) );
+    REQUIRE( str->assign( "compact block header" ) );
+    using psv_pptr = typename MgrT::template pptr<typename MgrT::pstringview>;
+    psv_pptr sym   = typename MgrT::pstringview( "compact-symbol" );
+    psv_pptr sym2  = typename MgrT::pstringview( "compact-symbol" );
+    REQUIRE( !sym.is_null() );
+    REQUIRE( sym == sym2 );
+    REQUIRE( std::string( sym->c_str() ) == "compact-symbol" );
+    REQUIRE( *arr->at( 99 ) == 495u );
+    REQUIRE( *str == "compact block header" );
+    REQUIRE( MgrT::verify().ok );
+
+    for ( std::size_t i = 1; i < fillers.size(); i += 2 )
+        MgrT::deallocate( fillers[i] );
+    REQUIRE( MgrT::verify().ok );
+    MgrT::destroy();
+}
+} // namespace
+
+TEST_CASE( "compact block header is 16 bytes", "[compact_header]" )
+{
+    STATIC_REQUIRE( sizeof( pmm::Block<CAT> ) == 16 );
+    STATIC_REQUIRE( sizeof( pmm::Block<pmm::DefaultAddressTraits> ) == 32 );
+    STATIC_REQUIRE( pmm::detail::block_tree_slot_bytes_v<CAT> == 3 * sizeof( CAT::index_type ) );
+    STATIC_REQUIRE( pmm::detail::block_tree_slot_bytes_v<pmm::DefaultAddressTraits> == 0 );
+
+    REQUIRE( MgrCompactAvl::create( 64 * 1024 ) );
+    REQUIRE( small_block_stride<MgrCompactAvl>() == 32 );
+    MgrCompactAvl::destroy();
+    REQUIRE( MgrFullLoad::create( 64 * 1024 ) );
+    REQUIRE( small_block_stride<MgrFullLoad>() == 48 );
+    MgrFullLoad::destroy();
+}
+
+TEST_CASE( "compact headers work with every free-tree policy", "[compact_header][pmap]" )
+{
+    exercise_compact_manager<MgrCompactAvl>();
+    exercise_compact_manager<MgrCompactTlsf>();
+    exercise_compact_manager<MgrCompactAddr>();
+    exercise_compact_manager<MgrCompactClass>();
+}
+
+TEST_CASE( "compact headers support compaction and shrink", "[compact_header][compact]" )
+{
+    REQUIRE( MgrCompactAvl::create( 128 * 1024 ) );
+    MgrCompactAvl::pmap<int, int> map( "slide" );
+    std::vector<void*>            fillers;
+    for ( int i = 0; i < 300; ++i )
+    {
+        fillers.push_back( MgrCompactAvl::allocate( 40 ) );
+        REQUIRE( !map.insert( i, -i ).is_null() );
+    }
+    for ( void* p : fillers )
+        MgrCompactAvl::deallocate( p );
+    pmm::CompactResult r = MgrCompactAvl::compact_step( std::chrono::seconds( 10 ) );
+    REQUIRE( r.complete );
+    REQUIRE( r.moved_blocks >= 250 );
+    REQUIRE( MgrCompactAvl::verify().ok );
+    REQUIRE( MgrCompactAvl::shrink_to_fit() );
+    REQUIRE( MgrCompactAvl::verify().ok );
+    for ( int i = 0; i < 300; ++i )
+        REQUIRE( map.find( i )->value == -i );
+    MgrCompactAvl::destroy();
+}
+
+TEST_CASE( "compact image round-trips and is rejected by a full-header manager", "[compact_header][persistence]" )
+{
+    REQUIRE( MgrCompactAvl::create( 64 * 1024 ) );
+    MgrCompactAvl::pmap<int, int> map( "persisted" );
+    for ( int i = 0; i < 64; ++i )
+        REQUIRE( !map.insert( i, i * i ).is_null() );
+    REQUIRE( pmm::save_manager<MgrCompactAvl>( kCompactHeaderFile ) );
+    MgrCompactAvl::destroy();
+
+    REQUIRE( MgrCompactLoad::create( 64 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<MgrCompactLoad>( kCompactHeaderFile, vr ) );
+    REQUIRE( MgrCompactLoad::verify().ok );
+    MgrCompactLoad::pmap<int, int> loaded( "persisted" );
+    REQUIRE( loaded.size() == 64 );
+    for ( int i = 0; i < 64; ++i )
+        REQUIRE( loaded.find( i )->value == i * i );
+    MgrCompactLoad::destroy();
+
+    REQUIRE( MgrFullLoad::create( 64 * 1024 ) );
+    pmm::VerifyResult full_vr;
+    REQUIRE_FALSE( pmm::load_manager_from_file<MgrFullLoad>( kCompactHeaderFile, full_vr ) );
+    MgrFullLoad::destroy();
+    std::remove( kCompactHeaderFile );
+}
+
+TEST_CASE( "compact tree-link setters leave allocated payload untouched", "[compact_header]" )
+{
+    using BlockState = pmm::BlockStateBase<CAT>;
+    REQUIRE( MgrCompactAvl::create( 64 * 1024 ) );
+    auto* user = static_cast<std::uint8_t*>( MgrCompactAvl::allocate( 16 ) );
+    REQUIRE( user != nullptr );
+    std::memset( user, 0x5A, 16 );
+    void* blk = user - sizeof( pmm::Block<CAT> );
+    BlockState::set_left_offset_of( blk, 1 );
+    BlockState::set_right_offset_of( blk, 2 );
+    BlockState::set_parent_offset_of( blk, 3 );
+    for ( std::size_t i = 0; i < 16; ++i )
+        REQUIRE( user[i] == 0x5A );
+    MgrCompactAvl::deallocate( user );
+    REQUIRE( MgrCompactAvl::verify().ok );
+    MgrCompactAvl::destroy();
+}
+
+TEST_CASE( "compact headers keep the thread cache for blocks with arbitrary payload", "[compact_header][thread_cache]" )
+{
+    STATIC_REQUIRE( MgrCompactCached::kThreadCacheEnabled );
+    REQUIRE( MgrCompactCached::create( 64 * 1024 ) );
+    auto* a = static_cast<std::uint8_t*>( MgrCompactCached::allocate( 24 ) );
+    REQUIRE( a != nullptr );
+    std::memset( a, 0x11, 24 );
+    MgrCompactCached::deallocate( a );
+    void* b = MgrCompactCached::allocate( 24 );
+    REQUIRE( b == a );
+    MgrCompactCached::deallocate( b );
+    MgrCompactCached::flush_thread_caches();
+    REQUIRE( MgrCompactCached::verify().ok );
+    MgrCompactCached::destroy();
+}
@@ -0,0 +1,122 @@
+/**
+ * @file test_deallocate_batch.cpp
+ * @brief deallocate_batch<T>(): bulk release with one address-ordered coalescing sweep.
+ *
+ *   - Blocks are freed in address order; adjacent runs are merged before the single free-tree insert.
+ *   - The resulting heap matches the one produced by per-block deallocate_typed().
+ *   - pmap::clear() releases its nodes through the batch path.
+ */
+
+#include "pmm/persist_memory_manager.h"
+#include "pmm/pmap.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using MgrFree      = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 420>;
+using MgrFreeBatch = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 421>;
+using MgrFreeOne   = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 422>;
+using MgrFreeMap   = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 423>;
+using MgrFreeArena = pmm::PersistMemoryManager<pmm::ArenaConfig<pmm::PersistentDataConfig, 2>, 424>;
+
+TEST_CASE( "deallocate_batch frees every block and restores the heap", "[batch]" )
+{
+    REQUIRE( MgrFree::create( 1024 * 1024 ) );
+    std::size_t allocs = MgrFree::alloc_block_count();
+    std::size_t frees  = MgrFree::free_block_count();
+
+    std::vector<MgrFree::pptr<std::uint32_t>> ptrs;
+    std::uint32_t                             seed = 17U;
+    for ( int i = 0; i < 1000; ++i )
+    {
+        seed = seed * 1103515245U + 12345U;
+        ptrs.push_back( MgrFree::allocate_typed<std::uint32_t>( 1 + ( seed >> 8 ) % 32 ) );
+        REQUIRE( !ptrs.back().is_null() );
+    }
+    for ( std::size_t i = ptrs.size() - 1; i > 0; --i )
+    {
+        seed = seed * 1103515245U + 12345U;
+        std::swap( ptrs[i], ptrs[( seed >> 8 ) % ( i + 1 )] );
+    }
+    ptrs.push_back( ptrs.front() );
+    ptrs.push_back( MgrFree::pptr<std::uint32_t>() );
+
+    MgrFree::deallocate_batch<std::uint32_t>( ptrs );
+    for ( auto p : ptrs )
+        REQUIRE( p.is_null() );
+    REQUIRE( MgrFree::alloc_block_count() == allocs );
+    REQUIRE( MgrFree::free_block_count() == frees );
+    REQUIRE( MgrFree::verify().ok );
+    MgrFree::destroy();
+}
+
+TEST_CASE( "deallocate_batch leaves the same heap as single deallocations", "[batch]" )
+{
+    REQUIRE( MgrFreeBatch::create( 256 * 1024 ) );
+    REQUIRE( MgrFreeOne::create( 256 * 1024 ) );
+    std::vector<MgrFreeBatch::pptr<std::uint8_t>> batch;
+    std::vector<MgrFreeOne::pptr<std::uint8_t>>   single;
+    for ( int i = 0; i < 600; ++i )
+    {
+        batch.push_back( MgrFreeBatch::allocate_typed<std::uint8_t>( 24 + ( i % 7 ) * 16 ) );
+        single.push_back( MgrFreeOne::allocate_typed<std::uint8_t>( 24 + ( i % 7 ) * 16 ) );
+    }
+
+    std::vector<MgrFreeBatch::pptr<std::uint8_t>> victims;
+    for ( std::size_t i = 0; i < batch.size(); ++i )
+    {
+        if ( i % 5 != 0 )
+        {
+            victims.push_back( batch[i] );
+            MgrFreeOne::deallocate_typed( single[i] );
+        }
+    }
+    MgrFreeBatch::deallocate_batch<std::uint8_t>( victims );
+
+    REQUIRE( MgrFreeBatch::alloc_block_count() == MgrFreeOne::alloc_block_count() );
+    REQUIRE( MgrFreeBatch::free_block_count() == MgrFreeOne::free_block_count() );
+    REQUIRE( MgrFreeBatch::free_size() == MgrFreeOne::free_size() );
+    REQUIRE( MgrFreeBatch::verify().ok );
+    void* big = MgrFreeBatch::allocate( 4 * 128 );
+    REQUIRE( big != nullptr );
+    MgrFreeBatch::deallocate( big );
+    REQUIRE( MgrFreeBatch::verify().ok );
+    MgrFreeBatch::destroy();
+    MgrFreeOne::destroy();
+}
+
+TEST_CASE( "pmap::clear releases nodes through deallocate_batch", "[batch][pmap]" )
+{
+    REQUIRE( MgrFreeMap::create( 1024 * 1024 ) );
+    MgrFreeMap::pmap<int, int> map;
+    REQUIRE( !map.insert( 0, 0 ).is_null() );
+    map.clear();
+    std::size_t allocs = MgrFreeMap::alloc_block_count();
+    std::size_t frees  = MgrFreeMap::free_block_count();
+
+    for ( int i = 0; i < 500; ++i )
+        REQUIRE( !map.insert( ( i * 7919 ) % 1000, i ).is_null() );
+    REQUIRE( map.size() == 500 );
+    map.clear();
+    REQUIRE( map.empty() );
+    REQUIRE( MgrFreeMap::alloc_block_count() == allocs );
+    REQUIRE( MgrFreeMap::free_block_count() == frees );
+    REQUIRE( MgrFreeMap::verify().ok );
+    MgrFreeMap::destroy();
+}
+
+TEST_CASE( "deallocate_batch routes blocks to their sub-arenas", "[batch][arena]" )
+{
+    REQUIRE( MgrFreeArena::create( 256 * 1024 ) );
+    std::size_t                                    allocs = MgrFreeArena::alloc_block_count();
+    std::vector<MgrFreeArena::pptr<std::uint64_t>> ptrs( 300 );
+    REQUIRE( MgrFreeArena::allocate_batch<std::uint64_t>( ptrs, 4 ) );
+    for ( int i = 0; i < 600; ++i )
+        ptrs.push_back( MgrFreeArena::allocate_typed<std::uint64_t>( 32 ) );
+    MgrFreeArena::deallocate_batch<std::uint64_t>( ptrs );
+    REQUIRE( MgrFreeArena::alloc_block_count() == allocs );
+    REQUIRE( MgrFreeArena::verify().ok );
+    MgrFreeArena::destroy();
+}
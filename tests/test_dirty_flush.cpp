@@ -0,0 +1,230 @@
+/**
+ * @file test_dirty_flush.cpp
+ * @brief Dirty-range tracking and incremental flush on MMapStorage.
+ *
+ *   - MMapStorage keeps a chunk bitmap over its reservation; allocator, container and header writes mark it.
+ *   - flush() msyncs only the marked runs and clears them; FlushMode::Async schedules write-back without waiting.
+ *   - mark_dirty() covers user writes through raw pointers; backends without tracking report flush() == false.
+ *   - Any number of images track at once; closing one never leaves a freed bitmap visible to writers.
+ */
+
+#include "pmm/mmap_storage.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+#if !defined( _WIN32 ) && !defined( _WIN64 )
+
+namespace
+{
+struct DirtyMMapConfig
+{
+    using address_traits                          = pmm::DefaultAddressTraits;
+    using storage_backend                         = pmm::MMapStorage<address_traits>;
+    using free_block_tree                         = pmm::AvlFreeTree<address_traits>;
+    using lock_policy                             = pmm::config::SharedMutexLock;
+    using logging_policy                          = pmm::logging::NoLogging;
+    static constexpr std::size_t granule_size     = address_traits::granule_size;
+    static constexpr std::size_t max_memory_gb    = 0;
+    static constexpr std::size_t grow_numerator   = pmm::config::kDefaultGrowNumerator;
+    static constexpr std::size_t grow_denominator = pmm::config::kDefaultGrowDenominator;
+};
+
+using MgrDirty = pmm::PersistMemoryManager<DirtyMMapConfig, 534>;
+
+const char* kDirtyFile = "test_dirty_flush.dat";
+} // namespace
+
+TEST_CASE( "only mmap storage tracks dirty ranges", "[mmap][flush]" )
+{
+    STATIC_REQUIRE( pmm::storage_tracks_dirty_v<pmm::MMapStorage<>> );
+    STATIC_REQUIRE_FALSE( pmm::storage_tracks_dirty_v<pmm::HeapStorage<>> );
+    STATIC_REQUIRE_FALSE( pmm::storage_tracks_dirty_v<pmm::ReservedHeapStorage<>> );
+}
+
+TEST_CASE( "mmap storage flushes only marked chunks", "[mmap][flush]" )
+{
+    std::remove( kDirtyFile );
+    pmm::MMapStorage<> s;
+    REQUIRE( s.open( kDirtyFile, 1024 * 1024 ) );
+    REQUIRE( s.flush() );
+    REQUIRE( s.dirty_bytes() == 0 );
+
+    s.base_ptr()[5000] = 0x5A;
+    s.mark_dirty( 5000, 1 );
+    std::size_t chunk = s.dirty_bytes();
+    REQUIRE( chunk >= 4096 );
+    s.mark_dirty( 5001, 1 );
+    REQUIRE( s.dirty_bytes() == chunk );
+    s.mark_dirty( 512 * 1024, 3 * chunk );
+    REQUIRE( s.dirty_bytes() == 4 * chunk );
+
+    REQUIRE( s.flush( pmm::FlushMode::Async ) );
+    REQUIRE( s.dirty_bytes() == 0 );
+    pmm::detail::note_dirty( s.base_ptr() + 100, 8 );
+    REQUIRE( s.dirty_bytes() == chunk );
+    REQUIRE( s.flush() );
+    REQUIRE( s.dirty_bytes() == 0 );
+    s.close();
+    REQUIRE_FALSE( s.flush() );
+    std::remove( kDirtyFile );
+}
+
+TEST_CASE( "manager writes mark the image and flush persists them", "[mmap][flush]" )
+{
+    std::remove( kDirtyFile );
+    REQUIRE( MgrDirty::backend().open( kDirtyFile, 256 * 1024 ) );
+    REQUIRE( MgrDirty::create() );
+    REQUIRE( MgrDirty::flush() );
+    REQUIRE( MgrDirty::backend().dirty_bytes() == 0 );
+
+    auto* raw = static_cast<std::uint8_t*>( MgrDirty::allocate( 64 ) );
+    REQUIRE( raw != nullptr );
+    REQUIRE( MgrDirty::backend().dirty_bytes() != 0 );
+    REQUIRE( MgrDirty::flush() );
+    REQUIRE( MgrDirty::backend().dirty_bytes() == 0 );
+
+    std::memset( raw, 0x6B, 64 );
+    MgrDirty::mark_dirty( raw, 64 );
+    REQUIRE( MgrDirty::backend().dirty_bytes() != 0 );
+    REQUIRE( MgrDirty::flush( pmm::FlushMode::Async ) );
+
+    MgrDirty::pptr<MgrDirty::pstring> str = MgrDirty::create_typed<MgrDirty::pstring>();
+    REQUIRE( !str.is_null() );
+    REQUIRE( MgrDirty::flush() );
+    REQUIRE( str.resolve()->assign( "dirty ranges" ) );
+    REQUIRE( MgrDirty::backend().dirty_bytes() != 0 );
+    MgrDirty::set_root( str );
+    REQUIRE( MgrDirty::flush() );
+    REQUIRE( MgrDirty::backend().dirty_bytes() == 0 );
+
+    MgrDirty::destroy();
+    MgrDirty::backend().close();
+    REQUIRE( MgrDirty::backend().open( kDirtyFile, 256 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE( MgrDirty::load( vr ) );
+    auto root = MgrDirty::get_root<MgrDirty::pstring>();
+    REQUIRE( !root.is_null() );
+    REQUIRE( *root.resolve() == "dirty ranges" );
+    MgrDirty::destroy();
+    MgrDirty::backend().close();
+    REQUIRE_FALSE( MgrDirty::flush() );
+    std::remove( kDirtyFile );
+}
+
+TEST_CASE( "tree lookups and verify leave the image clean", "[mmap][flush]" )
+{
+    std::remove( kDirtyFile );
+    REQUIRE( MgrDirty::backend().open( kDirtyFile, 256 * 1024 ) );
+    REQUIRE( MgrDirty::create() );
+    {
+        MgrDirty::pmap<int, int> map( "lookups" );
+        for ( int i = 0; i < 64; ++i )
+            REQUIRE( !map.insert( i, i * 3 ).is_null() );
+        for ( int i = 0; i < 64; i += 2 )
+            REQUIRE( map.erase( i ) );
+        REQUIRE( MgrDirty::flush() );
+        REQUIRE( MgrDirty::backend().dirty_bytes() == 0 );
+
+        for ( int i = 0; i < 64; ++i )
+            REQUIRE( map.contains( i ) == ( i % 2 == 1 ) );
+        REQUIRE( MgrDirty::verify().ok );
+        REQUIRE( MgrDirty::backend().dirty_bytes() == 0 );
+
+        REQUIRE( map.erase( 33 ) );
+        REQUIRE( MgrDirty::backend().dirty_bytes() != 0 );
+    }
+    MgrDirty::destroy();
+    MgrDirty::backend().close();
+    std::remove( kDirtyFile );
+}
+
+TEST_CASE( "more than eight open images each track their own dirty chunks", "[mmap][flush]" )
+{
+    constexpr int kImages = 12;
+    std::unique_ptr<pmm::MMapStorage<pmm::DefaultAddressTraits>> images[kImages];
+    for ( int i = 0; i < kImages; ++i )
+    {
+        std::string path = "test_dirty_many_" + std::to_string( i ) + ".dat";
+        std::remove( path.c_str() );
+        images[i] = std::make_unique<pmm::MMapStorage<pmm::DefaultAddressTraits>>();
+        REQUIRE( images[i]->open( path.c_str(), 64 * 1024 ) );
+    }
+    for ( auto& s : images )
+    {
+        REQUIRE( s->flush() );
+        REQUIRE( s->dirty_bytes() == 0 );
+        pmm::detail::note_dirty( s->base_ptr() + 64, 8 );
+        REQUIRE( s->dirty_bytes() != 0 );
+        REQUIRE( s->flush() );
+        REQUIRE( s->dirty_bytes() == 0 );
+    }
+    for ( int i = 0; i < kImages; ++i )
+    {
+        images[i]->close();
+        std::remove( ( "test_dirty_many_" + std::to_string( i ) + ".dat" ).c_str() );
+    }
+}
+
+TEST_CASE( "closing an image while another thread writes never touches a freed bitmap", "[mmap][flush]" )
+{
+    pmm::MMapStorage<pmm::DefaultAddressTraits> keep;
+    std::remove( kDirtyFile );
+    REQUIRE( keep.open( kDirtyFile, 64 * 1024 ) );
+    std::atomic<bool> stop{ false };
+    std::thread       writer(
+        [&]
+        {
+            while ( !stop.load( std::memory_order_relaxed ) )
+                pmm::detail::note_dirty( keep.base_ptr() + 128, 8 );
+        } );
+    for ( int i = 0; i < 200; ++i )
+    {
+        pmm::MMapStorage<pmm::DefaultAddressTraits> churn;
+        REQUIRE( churn.open( "test_dirty_churn.dat", 64 * 1024 ) );
+        churn.mark_dirty( 0, 8 );
+        churn.close();
+    }
+    stop.store( true );
+    writer.join();
+    REQUIRE( keep.dirty_bytes() != 0 );
+    REQUIRE( keep.flush() );
+    keep.close();
+    std::remove( kDirtyFile );
+    std::remove( "test_dirty_churn.dat" );
+}
+
+TEST_CASE( "reading compact tree links leaves the image clean", "[mmap][flush]" )
+{
+    using CAT   = pmm::CompactAddressTraits;
+    using State = pmm::BlockStateBase<CAT>;
+    pmm::MMapStorage<CAT> s;
+    std::remove( kDirtyFile );
+    REQUIRE( s.open( kDirtyFile, 64 * 1024 ) );
+    void* blk = s.base_ptr() + 4096;
+    State::init_fields( blk, CAT::no_block, CAT::no_block, 0, 4, 0, pmm::NodeType::Free );
+    REQUIRE( s.flush() );
+
+    REQUIRE( State::get_left_offset( blk ) == CAT::no_block );
+    REQUIRE( State::get_right_offset( blk ) == CAT::no_block );
+    REQUIRE( State::get_parent_offset( blk ) == CAT::no_block );
+    REQUIRE( s.dirty_bytes() == 0 );
+
+    State::set_left_offset_of( blk, 7 );
+    REQUIRE( s.dirty_bytes() != 0 );
+    REQUIRE( State::get_left_offset( blk ) == 7 );
+    REQUIRE( s.flush() );
+    s.close();
+    std::remove( kDirtyFile );
+}
+
+#endif
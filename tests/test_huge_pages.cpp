@@ -0,0 +1,123 @@
+/**
+ * @file test_huge_pages.cpp
+ * @brief Opt-in huge page backing for heap, reserved and mmap storage.
+ *
+ *   - HugePages backends align the image to 2 MiB and advise the kernel (MADV_HUGEPAGE) on every committed range.
+ *   - huge_page_bytes() reports how much of the image is huge-page backed; it may be 0 when THP is disabled.
+ *   - HugePageConfig switches the backend of any config and memory_stats_detailed() reports the same figure.
+ */
+
+#include "pmm/mmap_storage.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+constexpr std::size_t kHuge = pmm::detail::kHugePageSize;
+
+using HugeHeap     = pmm::HeapStorage<pmm::DefaultAddressTraits, true>;
+using HugeReserved = pmm::ReservedHeapStorage<pmm::DefaultAddressTraits, 1, true>;
+using MgrHuge      = pmm::PersistMemoryManager<pmm::HugePageConfig<pmm::PersistentDataConfig>, 533>;
+
+bool huge_aligned( const void* p )
+{
+    return reinterpret_cast<std::uintptr_t>( p ) % kHuge == 0;
+}
+} // namespace
+
+TEST_CASE( "huge page backends are opt-in", "[storage][hugepage]" )
+{
+    STATIC_REQUIRE_FALSE( pmm::storage_uses_huge_pages_v<pmm::HeapStorage<>> );
+    STATIC_REQUIRE_FALSE( pmm::storage_uses_huge_pages_v<pmm::ReservedHeapStorage<>> );
+    STATIC_REQUIRE( pmm::storage_uses_huge_pages_v<HugeHeap> );
+    STATIC_REQUIRE( pmm::storage_uses_huge_pages_v<HugeReserved> );
+    STATIC_REQUIRE( std::is_same_v<pmm::HugePageConfig<pmm::PersistentDataConfig>::storage_backend, HugeHeap> );
+    using ReservedHuge = pmm::HugePageConfig<pmm::ReservedHeapConfig<pmm::PersistentDataConfig>>;
+    STATIC_REQUIRE( std::is_same_v<ReservedHuge::storage_backend,
+                                   pmm::ReservedHeapStorage<pmm::DefaultAddressTraits, 64, true>> );
+}
+
+TEST_CASE( "huge page heap storage aligns to 2 MiB across growth", "[storage][hugepage]" )
+{
+    HugeHeap s( 64 * 1024 );
+    REQUIRE( s.base_ptr() != nullptr );
+    REQUIRE( huge_aligned( s.base_ptr() ) );
+    std::memset( s.base_ptr(), 0x3C, s.total_size() );
+    REQUIRE( s.resize_to( 3 * kHuge ) );
+    REQUIRE( huge_aligned( s.base_ptr() ) );
+    REQUIRE( s.base_ptr()[64 * 1024 - 1] == 0x3C );
+    std::memset( s.base_ptr(), 0x3C, s.total_size() );
+    REQUIRE( s.huge_page_bytes() <= 4 * kHuge );
+    REQUIRE( s.shrink_to( kHuge ) );
+    REQUIRE( huge_aligned( s.base_ptr() ) );
+}
+
+TEST_CASE( "huge page reserved storage commits whole huge pages", "[storage][hugepage]" )
+{
+    HugeReserved s( 64 * 1024 );
+    REQUIRE( huge_aligned( s.base_ptr() ) );
+    REQUIRE( s.committed_size() == kHuge );
+    std::uint8_t* base = s.base_ptr();
+    REQUIRE( s.resize_to( 4 * kHuge + 4096 ) );
+    REQUIRE( s.base_ptr() == base );
+    REQUIRE( s.committed_size() == 5 * kHuge );
+    std::memset( base, 0x5A, s.total_size() );
+    REQUIRE( s.huge_page_bytes() <= s.committed_size() );
+    REQUIRE( s.shrink_to( 64 * 1024 ) );
+    REQUIRE( s.committed_size() == kHuge );
+    REQUIRE( base[64 * 1024 - 1] == 0x5A );
+}
+
+#if !defined( _WIN32 ) && !defined( _WIN64 )
+TEST_CASE( "huge page mmap storage falls back cleanly on regular files", "[storage][hugepage][mmap]" )
+{
+    const char* path = "test_huge_pages.dat";
+    std::remove( path );
+    {
+        pmm::MMapStorage<pmm::DefaultAddressTraits, 1, true> s;
+        REQUIRE( s.open( path, 64 * 1024 ) );
+        std::uint8_t* base = s.base_ptr();
+        REQUIRE( huge_aligned( base ) );
+        REQUIRE( s.resize_to( 2 * kHuge ) );
+        REQUIRE( s.base_ptr() == base );
+        base[2 * kHuge - 1] = 0x44;
+        REQUIRE( s.huge_page_bytes() <= s.total_size() );
+    }
+    {
+        pmm::MMapStorage<> s;
+        REQUIRE( s.open( path, 2 * kHuge ) );
+        REQUIRE( s.base_ptr()[2 * kHuge - 1] == 0x44 );
+    }
+    std::remove( path );
+}
+#endif
+
+TEST_CASE( "detailed stats report huge page backing", "[storage][hugepage]" )
+{
+    REQUIRE( MgrHuge::create( 4 * kHuge ) );
+    REQUIRE( huge_aligned( MgrHuge::backend().base_ptr() ) );
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 256; ++i )
+    {
+        void* p = MgrHuge::allocate( 16 * 1024 );
+        REQUIRE( p != nullptr );
+        std::memset( p, i & 0xFF, 16 * 1024 );
+        ptrs.push_back( p );
+    }
+    auto stats = MgrHuge::memory_stats_detailed();
+    REQUIRE( stats.total_size == MgrHuge::total_size() );
+    REQUIRE( stats.huge_page_bytes <= ( stats.total_size + kHuge - 1 ) / kHuge * kHuge );
+    for ( void* p : ptrs )
+        MgrHuge::deallocate( p );
+    REQUIRE( MgrHuge::verify().ok );
+    MgrHuge::destroy();
+    REQUIRE( MgrHuge::memory_stats_detailed().huge_page_bytes == 0 );
+}
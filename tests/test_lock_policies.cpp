@@ -0,0 +1,123 @@
+/**
+ * @file test_lock_policies.cpp
+ * @brief SpinLock, TicketLock and AdaptiveLock lock policies.
+ *
+ *   - Each policy's mutex_type gives mutual exclusion for unique locks; SpinLock and AdaptiveLock admit
+ *     concurrent shared holders, TicketLock serializes them in FIFO order.
+ *   - A manager configured with each policy stays consistent under concurrent allocate/deallocate.
+ */
+
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+template <typename LockT>
+using LockConfig = pmm::BasicConfig<pmm::DefaultAddressTraits, LockT, 5, 4, 64, pmm::logging::NoLogging>;
+using MgrSpin     = pmm::PersistMemoryManager<LockConfig<pmm::config::SpinLock>, 526>;
+using MgrTicket   = pmm::PersistMemoryManager<LockConfig<pmm::config::TicketLock>, 527>;
+using MgrAdaptive = pmm::PersistMemoryManager<LockConfig<pmm::config::AdaptiveLock>, 528>;
+
+template <typename LockT> void require_mutual_exclusion()
+{
+    typename LockT::mutex_type m;
+    std::size_t                counter = 0;
+    std::vector<std::thread>   threads;
+    for ( int t = 0; t < 4; ++t )
+        threads.emplace_back(
+            [&]
+            {
+                for ( int i = 0; i < 5000; ++i )
+                {
+                    typename LockT::unique_lock_type lock( m );
+                    ++counter;
+                }
+            } );
+    for ( auto& t : threads )
+        t.join();
+    REQUIRE( counter == 20000 );
+
+    {
+        typename LockT::unique_lock_type lock( m );
+        REQUIRE_FALSE( m.try_lock() );
+        REQUIRE_FALSE( m.try_lock_shared() );
+    }
+    REQUIRE( m.try_lock() );
+    m.unlock();
+}
+
+template <typename MgrT> void exercise_manager()
+{
+    REQUIRE( MgrT::create( 512 * 1024 ) );
+    std::size_t              allocs = MgrT::alloc_block_count();
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < 4; ++t )
+        threads.emplace_back(
+            []
+            {
+                std::vector<void*> ptrs;
+                for ( int i = 0; i < 1000; ++i )
+                {
+                    ptrs.push_back( MgrT::allocate( 16 + static_cast<std::size_t>( i % 16 ) * 16 ) );
+                    if ( i % 3 == 0 )
+                    {
+                        MgrT::deallocate( ptrs.back() );
+                        ptrs.pop_back();
+                    }
+                }
+                for ( void* p : ptrs )
+                    MgrT::deallocate( p );
+            } );
+    for ( auto& t : threads )
+        t.join();
+    REQUIRE( MgrT::alloc_block_count() == allocs );
+    REQUIRE( MgrT::verify().ok );
+    MgrT::destroy();
+}
+} // namespace
+
+TEST_CASE( "lock policies provide mutual exclusion", "[thread][lock]" )
+{
+    require_mutual_exclusion<pmm::config::SpinLock>();
+    require_mutual_exclusion<pmm::config::TicketLock>();
+    require_mutual_exclusion<pmm::config::AdaptiveLock>();
+}
+
+TEST_CASE( "spin and adaptive locks admit concurrent readers", "[thread][lock]" )
+{
+    pmm::config::SpinLock::mutex_type spin;
+    spin.lock_shared();
+    REQUIRE( spin.try_lock_shared() );
+    REQUIRE_FALSE( spin.try_lock() );
+    spin.unlock_shared();
+    spin.unlock_shared();
+    REQUIRE( spin.try_lock() );
+    spin.unlock();
+
+    pmm::config::AdaptiveLock::mutex_type adaptive;
+    adaptive.lock_shared();
+    REQUIRE( adaptive.try_lock_shared() );
+    REQUIRE_FALSE( adaptive.try_lock() );
+    adaptive.unlock_shared();
+    adaptive.unlock_shared();
+
+    pmm::config::TicketLock::mutex_type ticket;
+    ticket.lock_shared();
+    REQUIRE_FALSE( ticket.try_lock_shared() );
+    ticket.unlock_shared();
+}
+
+TEST_CASE( "managers run on every lock policy", "[thread][lock]" )
+{
+    exercise_manager<MgrSpin>();
+    exercise_manager<MgrTicket>();
+    exercise_manager<MgrAdaptive>();
+}
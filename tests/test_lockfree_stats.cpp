@@ -0,0 +1,122 @@
+/**
+ * @file test_lockfree_stats.cpp
+ * @brief Statistics reads do not touch the manager mutex.
+ *
+ *   - Every write section publishes the header counters into a seqlock-protected snapshot on unlock;
+ *     total_size/used_size/free_size/block_count/free_block_count/alloc_block_count read that snapshot.
+ *   - A monitoring thread sees a consistent snapshot while writers allocate and free.
+ */
+
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct CountingLock
+{
+    static inline std::atomic<std::size_t> shared_locks{ 0 };
+    static inline std::atomic<std::size_t> unique_locks{ 0 };
+    struct mutex_type
+    {
+        void lock() { unique_locks.fetch_add( 1 ); }
+        void unlock() {}
+        void lock_shared() { shared_locks.fetch_add( 1 ); }
+        void unlock_shared() {}
+    };
+    struct shared_lock_type
+    {
+        explicit shared_lock_type( mutex_type& m ) { m.lock_shared(); }
+    };
+    struct unique_lock_type
+    {
+        explicit unique_lock_type( mutex_type& m ) { m.lock(); }
+    };
+};
+
+using MgrCounted = pmm::PersistMemoryManager<
+    pmm::BasicConfig<pmm::DefaultAddressTraits, CountingLock, 5, 4, 64, pmm::logging::NoLogging>, 524>;
+using MgrShared = pmm::PersistMemoryManager<pmm::PersistentDataConfig, 525>;
+} // namespace
+
+TEST_CASE( "stats reads take no lock", "[stats][thread]" )
+{
+    REQUIRE( MgrCounted::create( 64 * 1024 ) );
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 50; ++i )
+        ptrs.push_back( MgrCounted::allocate( 64 ) );
+    MgrCounted::deallocate( ptrs[10] );
+
+    std::size_t shared_before = CountingLock::shared_locks.load();
+    std::size_t unique_before = CountingLock::unique_locks.load();
+    std::size_t total         = MgrCounted::total_size();
+    std::size_t used          = MgrCounted::used_size();
+    std::size_t free_bytes    = MgrCounted::free_size();
+    std::size_t blocks        = MgrCounted::block_count();
+    std::size_t frees         = MgrCounted::free_block_count();
+    std::size_t allocs        = MgrCounted::alloc_block_count();
+    REQUIRE( CountingLock::shared_locks.load() == shared_before );
+    REQUIRE( CountingLock::unique_locks.load() == unique_before );
+
+    REQUIRE( total == 64 * 1024 );
+    REQUIRE( used + free_bytes == total );
+    REQUIRE( blocks == frees + allocs );
+    std::size_t walked = 0;
+    REQUIRE( MgrCounted::for_each_block( [&]( const pmm::BlockView& ) { ++walked; } ) );
+    REQUIRE( walked == blocks );
+
+    MgrCounted::deallocate( ptrs[20] );
+    REQUIRE( MgrCounted::alloc_block_count() == allocs - 1 );
+    MgrCounted::destroy();
+    REQUIRE( MgrCounted::total_size() == 0 );
+    REQUIRE( MgrCounted::block_count() == 0 );
+}
+
+TEST_CASE( "stats snapshot stays consistent under concurrent writers", "[stats][thread]" )
+{
+    REQUIRE( MgrShared::create( 256 * 1024 ) );
+    std::atomic<bool>        stop{ false };
+    std::atomic<std::size_t> torn{ 0 };
+    std::thread              monitor(
+        [&]
+        {
+            while ( !stop.load() )
+            {
+                std::size_t blocks = MgrShared::block_count();
+                std::size_t total  = MgrShared::total_size();
+                if ( MgrShared::used_size() > total || blocks == 0 )
+                    torn.fetch_add( 1 );
+            }
+        } );
+    std::vector<std::thread> writers;
+    for ( int t = 0; t < 4; ++t )
+        writers.emplace_back(
+            []
+            {
+                std::vector<void*> ptrs;
+                for ( int i = 0; i < 2000; ++i )
+                {
+                    ptrs.push_back( MgrShared::allocate( 16 + static_cast<std::size_t>( i % 32 ) * 8 ) );
+                    if ( ptrs.size() > 64 )
+                    {
+                        MgrShared::deallocate( ptrs.front() );
+                        ptrs.erase( ptrs.begin() );
+                    }
+                }
+                for ( void* p : ptrs )
+                    MgrShared::deallocate( p );
+            } );
+    for ( auto& w : writers )
+        w.join();
+    stop.store( true );
+    monitor.join();
+    REQUIRE( torn.load() == 0 );
+    REQUIRE( MgrShared::block_count() == MgrShared::free_block_count() + MgrShared::alloc_block_count() );
+    REQUIRE( MgrShared::verify().ok );
+    MgrShared::destroy();
+}
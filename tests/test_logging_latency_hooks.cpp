@@ -0,0 +1,189 @@
+/**
+ * @file test_logging_latency_hooks.cpp
+ * @brief Latency hooks of the logging policy and the HistogramLogging policy.
+ *
+ *   - on_allocate / on_deallocate / on_realloc / on_lock_wait are optional: a policy that declares them
+ *     receives the request size, the granted size and the elapsed nanoseconds.
+ *   - Batch calls report one hook per block, and slab-pooled types report their slots like ordinary blocks.
+ *   - NoLogging keeps the plain lock types and an empty timer, so the hooks cost nothing when unused.
+ *   - HistogramLogging aggregates per-thread log-linear histograms that answer percentile queries.
+ */
+
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+struct HookPoint
+{
+    std::uint32_t x;
+    std::uint32_t y;
+};
+} // namespace
+
+template <> struct pmm::slab_pool_for<HookPoint>
+{
+    static constexpr const char* name = "test/hook_point";
+};
+
+namespace
+{
+using AT = pmm::DefaultAddressTraits;
+
+struct CountingLogging : pmm::logging::NoLogging
+{
+    static inline size_t allocs = 0, deallocs = 0, reallocs = 0, lock_waits = 0;
+    static inline size_t last_size = 0, last_granted = 0, freed_bytes = 0, realloc_old = 0, realloc_new = 0;
+    static void          on_allocate( size_t size, size_t granted, std::uint64_t ) noexcept
+    {
+        ++allocs;
+        last_size    = size;
+        last_granted = granted;
+    }
+    static void on_deallocate( size_t size, std::uint64_t ) noexcept
+    {
+        ++deallocs;
+        freed_bytes += size;
+    }
+    static void on_realloc( size_t old_size, size_t new_size, std::uint64_t ) noexcept
+    {
+        ++reallocs;
+        realloc_old = old_size;
+        realloc_new = new_size;
+    }
+    static void on_lock_wait( std::uint64_t ) noexcept { ++lock_waits; }
+};
+
+using MgrCounting =
+    pmm::PersistMemoryManager<pmm::BasicConfig<AT, pmm::config::NoLock, 5, 4, 64, CountingLogging>, 520>;
+using MgrHistogram = pmm::PersistMemoryManager<
+    pmm::BasicConfig<AT, pmm::config::SharedMutexLock, 5, 4, 64, pmm::logging::HistogramLogging>, 521>;
+using MgrPlain = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 522>;
+} // namespace
+
+TEST_CASE( "latency hooks are compiled out for NoLogging", "[logging]" )
+{
+    STATIC_REQUIRE( std::is_empty_v<pmm::detail::LatencyTimer<false>> );
+    STATIC_REQUIRE_FALSE( pmm::detail::logs_allocate_v<pmm::logging::NoLogging> );
+    STATIC_REQUIRE_FALSE( pmm::detail::logs_lock_wait_v<pmm::logging::StderrLogging> );
+    STATIC_REQUIRE( std::is_same_v<pmm::detail::logged_lock_t<MgrPlain::thread_policy::unique_lock_type,
+                                                              MgrPlain::logging_policy>,
+                                   MgrPlain::thread_policy::unique_lock_type> );
+    STATIC_REQUIRE( pmm::detail::logs_realloc_v<CountingLogging> );
+    STATIC_REQUIRE( pmm::detail::logs_lock_wait_v<pmm::logging::HistogramLogging> );
+}
+
+TEST_CASE( "latency histogram buckets cover their values", "[logging]" )
+{
+    using H = pmm::logging::LatencyHistogram;
+    STATIC_REQUIRE( H::bucket_of( 0 ) == 0 );
+    STATIC_REQUIRE( H::bucket_of( 7 ) == 7 );
+    STATIC_REQUIRE( H::bucket_of( ~std::uint64_t( 0 ) ) == H::kBuckets - 1 );
+    STATIC_REQUIRE( H::bucket_upper( H::kBuckets - 1 ) == ~std::uint64_t( 0 ) );
+    for ( std::uint64_t ns : { 1ull, 8ull, 9ull, 15ull, 16ull, 1000ull, 123456789ull, 1ull << 40 } )
+    {
+        size_t b = H::bucket_of( ns );
+        REQUIRE( ns <= H::bucket_upper( b ) );
+        if ( b > 0 )
+            REQUIRE( ns > H::bucket_upper( b - 1 ) );
+        REQUIRE( H::bucket_upper( b ) - ns <= ns / H::kSubBuckets );
+    }
+}
+
+TEST_CASE( "custom policy receives allocate, deallocate and realloc hooks", "[logging]" )
+{
+    REQUIRE( MgrCounting::create( 64 * 1024 ) );
+    CountingLogging::lock_waits = 0;
+    void* p                     = MgrCounting::allocate( 100 );
+    REQUIRE( p != nullptr );
+    REQUIRE( CountingLogging::allocs == 1 );
+    REQUIRE( CountingLogging::last_size == 100 );
+    REQUIRE( CountingLogging::last_granted == 112 );
+    REQUIRE( MgrCounting::allocate_aligned( 64, 256 ) != nullptr );
+    REQUIRE( CountingLogging::allocs == 2 );
+    REQUIRE( CountingLogging::lock_waits >= 2 );
+
+    MgrCounting::deallocate( p );
+    REQUIRE( CountingLogging::deallocs == 1 );
+    REQUIRE( CountingLogging::freed_bytes == 112 );
+    MgrCounting::deallocate( nullptr );
+    REQUIRE( CountingLogging::freed_bytes == 112 );
+
+    auto arr = MgrCounting::allocate_typed<std::uint32_t>( 4 );
+    arr      = MgrCounting::reallocate_typed<std::uint32_t>( arr, 4, 400 );
+    REQUIRE( !arr.is_null() );
+    REQUIRE( CountingLogging::reallocs == 1 );
+    REQUIRE( CountingLogging::realloc_old == 16 );
+    REQUIRE( CountingLogging::realloc_new == 1600 );
+    MgrCounting::destroy();
+}
+
+TEST_CASE( "batch and slab paths report allocate and deallocate hooks", "[logging][slab]" )
+{
+    REQUIRE( MgrCounting::create( 64 * 1024 ) );
+    std::vector<MgrCounting::pptr<std::uint64_t>> batch( 4 );
+    size_t                                        allocs = CountingLogging::allocs;
+    REQUIRE( MgrCounting::allocate_batch<std::uint64_t>( batch ) );
+    REQUIRE( CountingLogging::allocs == allocs + 4 );
+    REQUIRE( CountingLogging::last_size == sizeof( std::uint64_t ) );
+
+    size_t deallocs = CountingLogging::deallocs;
+    size_t freed    = CountingLogging::freed_bytes;
+    MgrCounting::deallocate_batch<std::uint64_t>( batch );
+    REQUIRE( CountingLogging::deallocs == deallocs + 4 );
+    REQUIRE( CountingLogging::freed_bytes == freed + 4 * AT::granule_size );
+
+    auto slot = MgrCounting::create_typed<HookPoint>( HookPoint{ 1, 2 } );
+    REQUIRE( !slot.is_null() );
+    REQUIRE( CountingLogging::last_size == sizeof( HookPoint ) );
+    REQUIRE( CountingLogging::last_granted == AT::granule_size );
+    allocs   = CountingLogging::allocs;
+    deallocs = CountingLogging::deallocs;
+    auto two = MgrCounting::allocate_typed<HookPoint>();
+    REQUIRE( CountingLogging::allocs == allocs + 1 );
+    MgrCounting::deallocate_typed( two );
+    MgrCounting::destroy_typed( slot );
+    REQUIRE( CountingLogging::deallocs == deallocs + 2 );
+    MgrCounting::destroy();
+}
+
+TEST_CASE( "HistogramLogging aggregates latencies across threads", "[logging][thread]" )
+{
+    using pmm::logging::HistogramLogging;
+    using pmm::logging::LatencyOp;
+    HistogramLogging::reset();
+    REQUIRE( MgrHistogram::create( 1024 * 1024 ) );
+    std::vector<std::thread> workers;
+    for ( int t = 0; t < 4; ++t )
+        workers.emplace_back(
+            []
+            {
+                for ( int i = 0; i < 250; ++i )
+                    MgrHistogram::deallocate( MgrHistogram::allocate( 16 + static_cast<size_t>( i % 8 ) * 16 ) );
+            } );
+    for ( auto& w : workers )
+        w.join();
+
+    pmm::logging::LatencyHistogram alloc = HistogramLogging::snapshot( LatencyOp::Allocate );
+    REQUIRE( alloc.count == 1000 );
+    REQUIRE( HistogramLogging::snapshot( LatencyOp::Deallocate ).count == 1000 );
+    REQUIRE( HistogramLogging::snapshot( LatencyOp::LockWait ).count >= 2000 );
+    REQUIRE( alloc.percentile( 0.5 ) <= alloc.percentile( 0.99 ) );
+    REQUIRE( alloc.percentile( 1.0 ) == alloc.max_ns );
+    MgrHistogram::destroy();
+
+    HistogramLogging::reset();
+    REQUIRE( HistogramLogging::snapshot( LatencyOp::Allocate ).count == 0 );
+    HistogramLogging::record( LatencyOp::Realloc, 3 );
+    HistogramLogging::record( LatencyOp::Realloc, 1000 );
+    pmm::logging::LatencyHistogram r = HistogramLogging::snapshot( LatencyOp::Realloc );
+    REQUIRE( r.percentile( 0.5 ) == 3 );
+    REQUIRE( r.percentile( 0.99 ) == 1000 );
+}
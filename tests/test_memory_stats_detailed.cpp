@@ -0,0 +1,155 @@
+/**
+ * @file test_memory_stats_detailed.cpp
+ * @brief memory_stats_detailed(): size histograms, largest free block and fragmentation.
+ *
+ *   - The free/allocated histograms are maintained incrementally by the free-tree wrapper and the allocator;
+ *     after any mix of operations they match a full for_each_block() walk.
+ *   - largest_free comes from the free-tree policy, external_fragmentation = 1 - largest_free / free_bytes.
+ *   - Counters are rebuilt after load() and survive arena, batch and realloc paths.
+ */
+
+#include "pmm/io.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+using AT = pmm::DefaultAddressTraits;
+template <typename FreeTreeT>
+using StatsConfig = pmm::BasicConfig<AT, pmm::config::NoLock, 5, 4, 64, pmm::logging::NoLogging, FreeTreeT>;
+using MgrStatsAvl   = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 510>;
+using MgrStatsTlsf  = pmm::PersistMemoryManager<StatsConfig<pmm::TlsfFreeTree<AT>>, 511>;
+using MgrStatsAddr  = pmm::PersistMemoryManager<StatsConfig<pmm::AddressOrderedFreeTree<AT>>, 512>;
+using MgrStatsClass = pmm::PersistMemoryManager<StatsConfig<pmm::SizeClassFreeTree<AT>>, 513>;
+using MgrStatsArena = pmm::PersistMemoryManager<pmm::ArenaConfig<pmm::PersistentDataConfig, 2>, 514>;
+using MgrStatsLoad  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 515>;
+
+const char* kStatsFile = "test_memory_stats_detailed.dat";
+
+template <typename MgrT> void require_stats_match_walk()
+{
+    pmm::DetailedMemoryStats s = MgrT::memory_stats_detailed();
+    size_t                   free_hist[pmm::kSizeHistogramBuckets]{};
+    size_t                   alloc_hist[pmm::kSizeHistogramBuckets]{};
+    size_t                   free_bytes = 0, alloc_bytes = 0, largest = 0, blocks = 0;
+    REQUIRE( MgrT::for_each_block(
+        [&]( const pmm::BlockView& v )
+        {
+            ++blocks;
+            if ( v.used )
+            {
+                alloc_bytes += v.user_size;
+                alloc_hist[pmm::detail::size_histogram_bucket( v.user_size / AT::granule_size )]++;
+            }
+            else
+            {
+                free_bytes += v.total_size;
+                largest = ( v.total_size > largest ) ? v.total_size : largest;
+                free_hist[pmm::detail::size_histogram_bucket( v.total_size / AT::granule_size )]++;
+            }
+        } ) );
+    REQUIRE( s.total_size == MgrT::total_size() );
+    REQUIRE( s.free_bytes == free_bytes );
+    REQUIRE( s.allocated_bytes == alloc_bytes );
+    REQUIRE( s.largest_free == largest );
+    REQUIRE( s.free_blocks == MgrT::free_block_count() );
+    REQUIRE( s.allocated_blocks == MgrT::alloc_block_count() );
+    REQUIRE( s.header_overhead == blocks * sizeof( pmm::Block<AT> ) );
+    for ( size_t b = 0; b < pmm::kSizeHistogramBuckets; ++b )
+    {
+        REQUIRE( s.free_histogram[b] == free_hist[b] );
+        REQUIRE( s.alloc_histogram[b] == alloc_hist[b] );
+    }
+    if ( free_bytes > 0 )
+        REQUIRE( s.external_fragmentation == 1.0 - static_cast<double>( largest ) / static_cast<double>( free_bytes ) );
+}
+
+template <typename MgrT> void exercise_stats()
+{
+    REQUIRE( MgrT::create( 64 * 1024 ) );
+    require_stats_match_walk<MgrT>();
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 300; ++i )
+        ptrs.push_back( MgrT::allocate( 8 + static_cast<size_t>( i % 13 ) * 40 ) );
+    require_stats_match_walk<MgrT>();
+    for ( size_t i = 0; i < ptrs.size(); i += 3 )
+        MgrT::deallocate( ptrs[i] );
+    require_stats_match_walk<MgrT>();
+    REQUIRE( MgrT::memory_stats_detailed().external_fragmentation > 0.0 );
+
+    auto grown = MgrT::template allocate_typed<std::uint8_t>( 64 );
+    grown      = MgrT::template reallocate_typed<std::uint8_t>( grown, 64, 2000 );
+    REQUIRE( !grown.is_null() );
+    grown = MgrT::template reallocate_typed<std::uint8_t>( grown, 2000, 100 );
+    REQUIRE( !grown.is_null() );
+    std::vector<typename MgrT::template pptr<std::uint64_t>> batch( 40 );
+    REQUIRE( MgrT::template allocate_batch<std::uint64_t>( batch ) );
+    require_stats_match_walk<MgrT>();
+    MgrT::template deallocate_batch<std::uint64_t>( batch );
+    for ( size_t i = 1; i < ptrs.size(); i += 3 )
+        MgrT::deallocate( ptrs[i] );
+    require_stats_match_walk<MgrT>();
+    REQUIRE( MgrT::verify().ok );
+    MgrT::destroy();
+}
+} // namespace
+
+TEST_CASE( "size histogram buckets are log2 of the granule count", "[stats]" )
+{
+    REQUIRE( pmm::detail::size_histogram_bucket( 0 ) == 0 );
+    REQUIRE( pmm::detail::size_histogram_bucket( 1 ) == 0 );
+    REQUIRE( pmm::detail::size_histogram_bucket( 2 ) == 1 );
+    REQUIRE( pmm::detail::size_histogram_bucket( 3 ) == 1 );
+    REQUIRE( pmm::detail::size_histogram_bucket( 1024 ) == 10 );
+    REQUIRE( pmm::detail::size_histogram_bucket( ~std::uint64_t( 0 ) ) == pmm::kSizeHistogramBuckets - 1 );
+}
+
+TEST_CASE( "detailed stats track every free-tree policy incrementally", "[stats]" )
+{
+    exercise_stats<MgrStatsAvl>();
+    exercise_stats<MgrStatsTlsf>();
+    exercise_stats<MgrStatsAddr>();
+    exercise_stats<MgrStatsClass>();
+}
+
+TEST_CASE( "detailed stats cover sub-arenas", "[stats][arena]" )
+{
+    exercise_stats<MgrStatsArena>();
+}
+
+TEST_CASE( "detailed stats are rebuilt after load and empty when uninitialized", "[stats][persistence]" )
+{
+    pmm::DetailedMemoryStats none = MgrStatsLoad::memory_stats_detailed();
+    REQUIRE( none.total_size == 0 );
+    REQUIRE( none.free_blocks == 0 );
+
+    REQUIRE( MgrStatsAvl::create( 64 * 1024 ) );
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 100; ++i )
+        ptrs.push_back( MgrStatsAvl::allocate( 24 + static_cast<size_t>( i ) * 8 ) );
+    for ( size_t i = 0; i < ptrs.size(); i += 2 )
+        MgrStatsAvl::deallocate( ptrs[i] );
+    pmm::DetailedMemoryStats before = MgrStatsAvl::memory_stats_detailed();
+    std::size_t              image  = MgrStatsAvl::total_size();
+    REQUIRE( pmm::save_manager<MgrStatsAvl>( kStatsFile ) );
+    MgrStatsAvl::destroy();
+
+    REQUIRE( MgrStatsLoad::create( image ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<MgrStatsLoad>( kStatsFile, vr ) );
+    pmm::DetailedMemoryStats after = MgrStatsLoad::memory_stats_detailed();
+    REQUIRE( after.free_bytes == before.free_bytes );
+    REQUIRE( after.allocated_bytes == before.allocated_bytes );
+    REQUIRE( after.largest_free == before.largest_free );
+    require_stats_match_walk<MgrStatsLoad>();
+    REQUIRE( MgrStatsLoad::allocate( 4096 ) != nullptr );
+    require_stats_match_walk<MgrStatsLoad>();
+    MgrStatsLoad::destroy();
+    std::remove( kStatsFile );
+}
@@ -0,0 +1,144 @@
+/**
+ * @file test_mmap_readonly.cpp
+ * @brief Read-only shared mapping of an image written by another manager.
+ *
+ *   - MMapStorage::open_readonly() maps an existing file PROT_READ at its current size; growth and shrink fail.
+ *   - load_readonly() validates the header without repair and serves get_root, pmap::find and resolve in place.
+ *   - Mutating calls fail with PmmError::ReadOnlyImage and leave the image untouched; load() rejects the mapping.
+ *   - Calling load_readonly() again picks up growth done by the writer; the reader's base address does not move.
+ */
+
+#include "pmm/mmap_storage.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if !defined( _WIN32 ) && !defined( _WIN64 )
+
+namespace
+{
+struct SharedMMapConfig
+{
+    using address_traits                          = pmm::DefaultAddressTraits;
+    using storage_backend                         = pmm::MMapStorage<address_traits>;
+    using free_block_tree                         = pmm::AvlFreeTree<address_traits>;
+    using lock_policy                             = pmm::config::SharedMutexLock;
+    using logging_policy                          = pmm::logging::NoLogging;
+    static constexpr std::size_t granule_size     = address_traits::granule_size;
+    static constexpr std::size_t max_memory_gb    = 0;
+    static constexpr std::size_t grow_numerator   = pmm::config::kDefaultGrowNumerator;
+    static constexpr std::size_t grow_denominator = pmm::config::kDefaultGrowDenominator;
+};
+
+using MgrWriter = pmm::PersistMemoryManager<SharedMMapConfig, 535>;
+using MgrReader = pmm::PersistMemoryManager<SharedMMapConfig, 536>;
+
+const char* kSharedFile = "test_mmap_readonly.dat";
+} // namespace
+
+TEST_CASE( "read-only mmap storage maps the existing file", "[mmap][readonly]" )
+{
+    std::remove( kSharedFile );
+    pmm::MMapStorage<> missing;
+    REQUIRE_FALSE( missing.open_readonly( kSharedFile ) );
+    {
+        pmm::MMapStorage<> w;
+        REQUIRE( w.open( kSharedFile, 64 * 1024 ) );
+        w.base_ptr()[100] = 0x42;
+    }
+    pmm::MMapStorage<> r;
+    REQUIRE( r.open_readonly( kSharedFile ) );
+    REQUIRE( r.is_readonly() );
+    REQUIRE( r.total_size() == 64 * 1024 );
+    REQUIRE( r.base_ptr()[100] == 0x42 );
+    REQUIRE_FALSE( r.resize_to( 128 * 1024 ) );
+    REQUIRE_FALSE( r.shrink_to( 32 * 1024 ) );
+    REQUIRE_FALSE( r.flush() );
+    {
+        pmm::MMapStorage<> w;
+        REQUIRE( w.open( kSharedFile, 256 * 1024 ) );
+        w.base_ptr()[200 * 1024] = 0x43;
+    }
+    const std::uint8_t* base = r.base_ptr();
+    REQUIRE( r.refresh() );
+    REQUIRE( r.total_size() == 256 * 1024 );
+    REQUIRE( r.base_ptr() == base );
+    REQUIRE( r.base_ptr()[200 * 1024] == 0x43 );
+    r.close();
+    std::remove( kSharedFile );
+}
+
+TEST_CASE( "load_readonly serves lookups and rejects mutation", "[mmap][readonly]" )
+{
+    std::remove( kSharedFile );
+    REQUIRE( MgrWriter::backend().open( kSharedFile, 64 * 1024 ) );
+    REQUIRE( MgrWriter::create() );
+    MgrWriter::pmap<int, int> wmap( "index" );
+    for ( int i = 0; i < 50; ++i )
+        REQUIRE( !wmap.insert( i, i * 10 ).is_null() );
+    MgrWriter::pptr<MgrWriter::pstring> wstr = MgrWriter::create_typed<MgrWriter::pstring>();
+    REQUIRE( wstr.resolve()->assign( "shared image" ) );
+    MgrWriter::set_root( wstr );
+    REQUIRE( MgrWriter::flush() );
+
+    REQUIRE( MgrReader::backend().open_readonly( kSharedFile ) );
+    pmm::VerifyResult vr;
+    REQUIRE_FALSE( MgrReader::load( vr ) );
+    REQUIRE( MgrReader::last_error() == pmm::PmmError::BackendError );
+    REQUIRE( MgrReader::load_readonly( vr ) );
+    REQUIRE( vr.ok );
+    auto root = MgrReader::get_root<MgrReader::pstring>();
+    REQUIRE( !root.is_null() );
+    REQUIRE( *root.resolve() == "shared image" );
+    MgrReader::pmap<int, int> rmap( "index" );
+    REQUIRE( rmap.size() == 50 );
+    auto node = rmap.find( 7 );
+    REQUIRE( !node.is_null() );
+    REQUIRE( node.resolve()->value == 70 );
+
+    std::size_t used = MgrReader::used_size();
+    REQUIRE( MgrReader::allocate( 64 ) == nullptr );
+    REQUIRE( MgrReader::last_error() == pmm::PmmError::ReadOnlyImage );
+    REQUIRE( MgrReader::create_typed<int>( 5 ).is_null() );
+    REQUIRE( rmap.insert( 100, 1 ).is_null() );
+    REQUIRE_FALSE( rmap.erase( 7 ) );
+    MgrReader::deallocate( root.resolve() );
+    MgrReader::set_root( MgrReader::pptr<MgrReader::pstring>() );
+    REQUIRE_FALSE( MgrReader::register_domain( "reader/domain" ) );
+    REQUIRE_FALSE( MgrReader::shrink_to_fit() );
+    REQUIRE( MgrReader::last_error() == pmm::PmmError::ReadOnlyImage );
+    REQUIRE( MgrReader::get_root<MgrReader::pstring>() == root );
+    REQUIRE( MgrReader::used_size() == used );
+    REQUIRE( MgrReader::verify().ok );
+
+    const std::uint8_t* base = MgrReader::backend().base_ptr();
+    std::vector<void*>  ptrs;
+    for ( int i = 0; i < 200; ++i )
+        ptrs.push_back( MgrWriter::allocate( 4096 ) );
+    for ( int i = 50; i < 60; ++i )
+        REQUIRE( !wmap.insert( i, i * 10 ).is_null() );
+    REQUIRE( MgrWriter::total_size() > MgrReader::total_size() );
+    REQUIRE( MgrReader::load_readonly( vr ) );
+    REQUIRE( MgrReader::backend().base_ptr() == base );
+    REQUIRE( MgrReader::total_size() == MgrWriter::total_size() );
+    REQUIRE( rmap.size() == 60 );
+    REQUIRE( rmap.find( 55 ).resolve()->value == 550 );
+    REQUIRE( *root.resolve() == "shared image" );
+
+    MgrReader::destroy();
+    MgrReader::backend().close();
+    for ( void* p : ptrs )
+        MgrWriter::deallocate( p );
+    REQUIRE( MgrWriter::verify().ok );
+    MgrWriter::destroy();
+    MgrWriter::backend().close();
+    std::remove( kSharedFile );
+}
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * @file test_mmap_stable_base.cpp
+ * @brief MMapStorage grows and shrinks inside a reserved address range.
+ *
+ *   - open() reserves address space once and maps the file at its start; growth maps only the file extension with
+ *     MAP_FIXED, so base_ptr() never moves and existing pages are not re-faulted.
+ *   - shrink_to() returns the tail pages to the reservation; the image grows back at the same address.
+ *   - A shrink whose file truncation fails leaves the mapping untouched, so the manager can keep using the tail.
+ *   - Data written through the mapping reaches the file.
+ */
+
+#include "pmm/mmap_storage.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if !defined( _WIN32 ) && !defined( _WIN64 )
+
+#if defined( __linux__ )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+struct MMapGrowConfig
+{
+    using address_traits                          = pmm::DefaultAddressTraits;
+    using storage_backend                         = pmm::MMapStorage<address_traits>;
+    using free_block_tree                         = pmm::AvlFreeTree<address_traits>;
+    using lock_policy                             = pmm::config::SharedMutexLock;
+    using logging_policy                          = pmm::logging::NoLogging;
+    static constexpr std::size_t granule_size     = address_traits::granule_size;
+    static constexpr std::size_t max_memory_gb    = 0;
+    static constexpr std::size_t grow_numerator   = pmm::config::kDefaultGrowNumerator;
+    static constexpr std::size_t grow_denominator = pmm::config::kDefaultGrowDenominator;
+};
+
+using MgrMMapGrow   = pmm::PersistMemoryManager<MMapGrowConfig, 532>;
+using MgrMMapSealed = pmm::PersistMemoryManager<MMapGrowConfig, 539>;
+
+const char* kGrowFile = "test_mmap_stable_base.dat";
+} // namespace
+
+TEST_CASE( "mmap storage keeps its base across growth and shrink", "[mmap][storage]" )
+{
+    STATIC_REQUIRE( pmm::storage_has_stable_base_v<pmm::MMapStorage<>> );
+    std::remove( kGrowFile );
+    {
+        pmm::MMapStorage<> s;
+        REQUIRE( s.open( kGrowFile, 64 * 1024 ) );
+        std::uint8_t* base = s.base_ptr();
+        std::memset( base, 0x11, 64 * 1024 );
+
+        REQUIRE( s.resize_to( 64 * 1024 + 16 ) );
+        REQUIRE( s.base_ptr() == base );
+        REQUIRE( s.resize_to( 4 * 1024 * 1024 ) );
+        REQUIRE( s.base_ptr() == base );
+        REQUIRE( base[64 * 1024 - 1] == 0x11 );
+        base[4 * 1024 * 1024 - 1] = 0x22;
+
+        REQUIRE( s.shrink_to( 128 * 1024 ) );
+        REQUIRE( s.base_ptr() == base );
+        REQUIRE( s.total_size() == 128 * 1024 );
+        REQUIRE( s.resize_to( 1024 * 1024 ) );
+        REQUIRE( s.base_ptr() == base );
+        REQUIRE( base[1024 * 1024 - 1] == 0 );
+        base[1024 * 1024 - 1] = 0x33;
+    }
+    {
+        pmm::MMapStorage<> s;
+        REQUIRE( s.open( kGrowFile, 1024 * 1024 ) );
+        REQUIRE( s.base_ptr()[0] == 0x11 );
+        REQUIRE( s.base_ptr()[1024 * 1024 - 1] == 0x33 );
+    }
+    std::remove( kGrowFile );
+}
+
+TEST_CASE( "mmap storage growth stops at the reservation", "[mmap][storage]" )
+{
+    std::remove( kGrowFile );
+    pmm::MMapStorage<pmm::SmallAddressTraits> s;
+    REQUIRE( s.open( kGrowFile, 64 * 1024 ) );
+    std::uint8_t* base = s.base_ptr();
+    REQUIRE_FALSE( s.resize_to( 64 * 1024 * 1024 ) );
+    REQUIRE( s.base_ptr() == base );
+    REQUIRE( s.total_size() == 64 * 1024 );
+    s.close();
+    std::remove( kGrowFile );
+}
+
+TEST_CASE( "manager on mmap storage keeps raw pointers across growth", "[mmap][storage]" )
+{
+    std::remove( kGrowFile );
+    REQUIRE( MgrMMapGrow::backend().open( kGrowFile, 64 * 1024 ) );
+    REQUIRE( MgrMMapGrow::create() );
+    const std::uint8_t* base  = MgrMMapGrow::backend().base_ptr();
+    auto*               first = static_cast<std::uint8_t*>( MgrMMapGrow::allocate( 64 ) );
+    REQUIRE( first != nullptr );
+    first[0] = 0x7E;
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 500; ++i )
+        ptrs.push_back( MgrMMapGrow::allocate( 4096 ) );
+    REQUIRE( MgrMMapGrow::total_size() > 2 * 1024 * 1024 );
+    REQUIRE( MgrMMapGrow::backend().base_ptr() == base );
+    REQUIRE( first[0] == 0x7E );
+    for ( void* p : ptrs )
+        MgrMMapGrow::deallocate( p );
+    REQUIRE( MgrMMapGrow::verify().ok );
+    MgrMMapGrow::destroy();
+    MgrMMapGrow::backend().close();
+    std::remove( kGrowFile );
+}
+
+#if defined( __linux__ )
+TEST_CASE( "failed mmap shrink leaves the tail usable", "[mmap][storage]" )
+{
+    int fd = ::memfd_create( "pmm_sealed_shrink", MFD_ALLOW_SEALING );
+    REQUIRE( fd >= 0 );
+    REQUIRE( ::ftruncate( fd, 1024 * 1024 ) == 0 );
+    char path[64];
+    std::snprintf( path, sizeof( path ), "/proc/self/fd/%d", fd );
+    REQUIRE( MgrMMapSealed::backend().open( path, 1024 * 1024 ) );
+    REQUIRE( MgrMMapSealed::create() );
+    REQUIRE( ::fcntl( fd, F_ADD_SEALS, F_SEAL_SHRINK ) == 0 );
+
+    std::size_t total = MgrMMapSealed::total_size();
+    REQUIRE_FALSE( MgrMMapSealed::shrink_to_fit() );
+    REQUIRE( MgrMMapSealed::total_size() == total );
+    REQUIRE( MgrMMapSealed::backend().total_size() == total );
+    auto* big = static_cast<std::uint8_t*>( MgrMMapSealed::allocate( 512 * 1024 ) );
+    REQUIRE( big != nullptr );
+    std::memset( big, 0x5C, 512 * 1024 );
+    REQUIRE( big[512 * 1024 - 1] == 0x5C );
+    MgrMMapSealed::deallocate( big );
+    REQUIRE( MgrMMapSealed::verify().ok );
+    MgrMMapSealed::destroy();
+    MgrMMapSealed::backend().close();
+    ::close( fd );
+}
+#endif
+
+#endif
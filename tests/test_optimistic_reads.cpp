@@ -0,0 +1,172 @@
+/**
+ * @file test_optimistic_reads.cpp
+ * @brief Optimistic (version-validated) root and domain lookups.
+ *
+ *   - Write sections bump a manager version counter on entry and exit; get_root, find_domain_by_name and
+ *     get_domain_root_offset read without the mutex and retry when the version moved.
+ *   - Enabled only when the storage base never moves (StaticStorage), so a reader cannot touch freed memory.
+ *   - Readers see stable roots while writers allocate and free concurrently.
+ */
+
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct CountingSharedLock
+{
+    static inline std::atomic<std::size_t> shared_locks{ 0 };
+    struct mutex_type
+    {
+        std::shared_mutex m;
+        void              lock() { m.lock(); }
+        void              unlock() { m.unlock(); }
+        void              lock_shared()
+        {
+            shared_locks.fetch_add( 1 );
+            m.lock_shared();
+        }
+        void unlock_shared() { m.unlock_shared(); }
+    };
+    using shared_lock_type = std::shared_lock<mutex_type>;
+    using unique_lock_type = std::unique_lock<mutex_type>;
+};
+
+template <typename LockT> struct LockedStaticConfig : pmm::StaticConfig<pmm::DefaultAddressTraits, 256 * 1024>
+{
+    using lock_policy = LockT;
+};
+
+using MgrCounted = pmm::PersistMemoryManager<LockedStaticConfig<CountingSharedLock>, 529>;
+using MgrShared  = pmm::PersistMemoryManager<LockedStaticConfig<pmm::config::SharedMutexLock>, 530>;
+} // namespace
+
+TEST_CASE( "only stable-base storage enables optimistic reads", "[thread][optimistic]" )
+{
+    STATIC_REQUIRE( pmm::storage_has_stable_base_v<pmm::StaticStorage<4096>> );
+    STATIC_REQUIRE_FALSE( pmm::storage_has_stable_base_v<pmm::HeapStorage<>> );
+}
+
+TEST_CASE( "root and domain lookups take no shared lock", "[thread][optimistic]" )
+{
+    REQUIRE( MgrCounted::create() );
+    auto value = MgrCounted::allocate_typed<std::uint64_t>();
+    REQUIRE( !value.is_null() );
+    MgrCounted::set_root( value );
+    REQUIRE( MgrCounted::register_domain( "app/index" ) );
+    REQUIRE( MgrCounted::set_domain_root( "app/index", value ) );
+
+    std::size_t before  = CountingSharedLock::shared_locks.load();
+    auto        root    = MgrCounted::get_root<std::uint64_t>();
+    auto        binding = MgrCounted::find_domain_by_name( "app/index" );
+    auto        by_name = MgrCounted::get_domain_root_offset( "app/index" );
+    auto        by_id   = MgrCounted::get_domain_root_offset( binding );
+    REQUIRE( CountingSharedLock::shared_locks.load() == before );
+
+    REQUIRE( root == value );
+    REQUIRE( binding != 0 );
+    REQUIRE( by_name == value.offset() );
+    REQUIRE( by_id == value.offset() );
+    REQUIRE( MgrCounted::find_domain_by_name( "app/missing" ) == 0 );
+
+    MgrCounted::set_root( MgrCounted::pptr<std::uint64_t>() );
+    REQUIRE( MgrCounted::get_root<std::uint64_t>().is_null() );
+    MgrCounted::destroy();
+    REQUIRE( MgrCounted::get_root<std::uint64_t>().is_null() );
+    REQUIRE( MgrCounted::get_domain_root_offset( "app/index" ) == 0 );
+}
+
+TEST_CASE( "optimistic readers see stable roots under concurrent writers", "[thread][optimistic]" )
+{
+    REQUIRE( MgrShared::create() );
+    auto value = MgrShared::allocate_typed<std::uint64_t>();
+    REQUIRE( !value.is_null() );
+    MgrShared::set_root( value );
+    REQUIRE( MgrShared::register_domain( "app/index" ) );
+    REQUIRE( MgrShared::set_domain_root( "app/index", value ) );
+    const auto binding = MgrShared::find_domain_by_name( "app/index" );
+
+    std::atomic<bool>        stop{ false };
+    std::atomic<std::size_t> wrong{ 0 };
+    std::vector<std::thread> readers;
+    for ( int t = 0; t < 2; ++t )
+        readers.emplace_back(
+            [&]
+            {
+                while ( !stop.load() )
+                {
+                    if ( MgrShared::get_root<std::uint64_t>() != value ||
+                         MgrShared::get_domain_root_offset( binding ) != value.offset() ||
+                         MgrShared::find_domain_by_name( "app/index" ) != binding )
+                        wrong.fetch_add( 1 );
+                }
+            } );
+    std::vector<std::thread> writers;
+    for ( int t = 0; t < 2; ++t )
+        writers.emplace_back(
+            []
+            {
+                std::vector<void*> ptrs;
+                for ( int i = 0; i < 2000; ++i )
+                {
+                    ptrs.push_back( MgrShared::allocate( 16 + static_cast<std::size_t>( i % 16 ) * 8 ) );
+                    if ( ptrs.size() > 32 )
+                    {
+                        MgrShared::deallocate( ptrs.front() );
+                        ptrs.erase( ptrs.begin() );
+                    }
+                }
+                for ( void* p : ptrs )
+                    MgrShared::deallocate( p );
+            } );
+    for ( auto& w : writers )
+        w.join();
+    stop.store( true );
+    for ( auto& r : readers )
+        r.join();
+    REQUIRE( wrong.load() == 0 );
+    REQUIRE( MgrShared::verify().ok );
+    MgrShared::destroy();
+}
+
+TEST_CASE( "optimistic lookups stay inside the registry while domains are registered", "[thread][optimistic]" )
+{
+    REQUIRE( MgrShared::create() );
+    REQUIRE( MgrShared::register_domain( "app/index" ) );
+    const auto binding = MgrShared::find_domain_by_name( "app/index" );
+    REQUIRE( binding != 0 );
+
+    std::atomic<bool>        stop{ false };
+    std::atomic<std::size_t> wrong{ 0 };
+    std::thread              reader(
+        [&]
+        {
+            while ( !stop.load() )
+            {
+                if ( MgrShared::find_domain_by_name( "app/index" ) != binding ||
+                     MgrShared::get_domain_root_offset( "app/missing" ) != 0 )
+                    wrong.fetch_add( 1 );
+                (void)MgrShared::find_domain_by_name( "app/late" );
+            }
+        } );
+    for ( int i = 0; i < 16; ++i )
+    {
+        const std::string name = "app/extra" + std::to_string( i );
+        REQUIRE( MgrShared::register_domain( name.c_str() ) );
+    }
+    REQUIRE( MgrShared::register_domain( "app/late" ) );
+    stop.store( true );
+    reader.join();
+    REQUIRE( wrong.load() == 0 );
+    REQUIRE( MgrShared::find_domain_by_name( "app/late" ) != 0 );
+    MgrShared::destroy();
+}
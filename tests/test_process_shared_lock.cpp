@@ -0,0 +1,242 @@
+/**
+ * @file test_process_shared_lock.cpp
+ * @brief Several processes allocating from one mmap'd image under config::ProcessSharedLock.
+ *
+ *   - The robust, process-shared pthread mutex lives in the ManagerHeader reserve; create() initializes it, load() binds.
+ *   - A process that dies holding the lock is detected via EOWNERDEAD: the next owner repairs the image.
+ *   - Growth done by another process is picked up when the lock is acquired (the mapping is refreshed).
+ *   - A mutex that cannot be recovered fails manager calls with PmmError::LockFailed instead of terminating.
+ */
+
+#include "pmm/mmap_storage.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#if !defined( _WIN32 ) && !defined( _WIN64 )
+#include <cerrno>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+struct SharedProcessConfig
+{
+    using address_traits                          = pmm::DefaultAddressTraits;
+    using storage_backend                         = pmm::MMapStorage<address_traits>;
+    using free_block_tree                         = pmm::AvlFreeTree<address_traits>;
+    using lock_policy                             = pmm::config::ProcessSharedLock;
+    using logging_policy                          = pmm::logging::NoLogging;
+    static constexpr std::size_t granule_size     = address_traits::granule_size;
+    static constexpr std::size_t max_memory_gb    = 0;
+    static constexpr std::size_t grow_numerator   = pmm::config::kDefaultGrowNumerator;
+    static constexpr std::size_t grow_denominator = pmm::config::kDefaultGrowDenominator;
+};
+
+using MgrOwner = pmm::PersistMemoryManager<SharedProcessConfig, 537>;
+using MgrPeer  = pmm::PersistMemoryManager<SharedProcessConfig, 538>;
+
+const char* kProcessFile = "test_process_shared_lock.dat";
+
+int  g_acquired   = 0;
+int  g_owner_dead = 0;
+void record_acquire( bool owner_dead ) noexcept
+{
+    ++g_acquired;
+    if ( owner_dead )
+        ++g_owner_dead;
+}
+
+template <typename Fn> int run_child( Fn fn )
+{
+    pid_t pid = ::fork();
+    if ( pid == 0 )
+        ::_exit( fn() );
+    int status = -1;
+    ::waitpid( pid, &status, 0 );
+    return WIFEXITED( status ) ? WEXITSTATUS( status ) : -1;
+}
+
+int peer_attach()
+{
+    if ( !MgrPeer::backend().open( kProcessFile, 64 * 1024 ) )
+        return 10;
+    pmm::VerifyResult vr;
+    return MgrPeer::load( vr ) ? 0 : 11;
+}
+} // namespace
+
+TEST_CASE( "process-shared lock recovers from a dead owner", "[process][lock]" )
+{
+    using Lock = pmm::config::ProcessSharedLock;
+    STATIC_REQUIRE( pmm::detail::lock_is_process_shared_v<Lock> );
+    STATIC_REQUIRE_FALSE( pmm::detail::lock_is_process_shared_v<pmm::config::SharedMutexLock> );
+    void* mem = ::mmap( nullptr, sizeof( Lock::area_type ), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0 );
+    REQUIRE( mem != MAP_FAILED );
+    auto*           area = static_cast<Lock::area_type*>( mem );
+    Lock::mutex_type m;
+    REQUIRE( m.bind( area, true, &record_acquire ) );
+    m.unlock();
+    g_acquired = 0;
+
+    m.lock();
+    m.unlock();
+    REQUIRE( g_acquired == 0 );
+    REQUIRE( run_child(
+                 [&]
+                 {
+                     m.lock();
+                     m.unlock();
+                     return 0;
+                 } ) == 0 );
+    m.lock_shared();
+    m.unlock_shared();
+    REQUIRE( g_acquired == 1 );
+    REQUIRE( g_owner_dead == 0 );
+
+    REQUIRE( run_child(
+                 [&]
+                 {
+                     m.lock();
+                     return 0;
+                 } ) == 0 );
+    m.lock();
+    m.unlock();
+    REQUIRE( g_owner_dead == 1 );
+    REQUIRE( m.try_lock() );
+    m.unlock();
+    REQUIRE( g_owner_dead == 1 );
+    m.unbind();
+    ::munmap( mem, sizeof( Lock::area_type ) );
+}
+
+TEST_CASE( "processes share one image and see each other's growth", "[process][lock]" )
+{
+    std::remove( kProcessFile );
+    REQUIRE( MgrOwner::backend().open( kProcessFile, 64 * 1024 ) );
+    REQUIRE( MgrOwner::create() );
+    MgrOwner::pmap<int, int> jobs( "jobs" );
+    for ( int i = 0; i < 10; ++i )
+        REQUIRE( !jobs.insert( i, i ).is_null() );
+    std::size_t before = MgrOwner::total_size();
+
+    int rc = run_child(
+        []
+        {
+            int err = peer_attach();
+            if ( err != 0 )
+                return err;
+            MgrPeer::pmap<int, int> peer_jobs( "jobs" );
+            if ( peer_jobs.size() != 10 )
+                return 12;
+            for ( int i = 10; i < 200; ++i )
+                if ( peer_jobs.insert( i, i * 2 ).is_null() )
+                    return 13;
+            auto* big = static_cast<std::uint8_t*>( MgrPeer::allocate( 256 * 1024 ) );
+            if ( big == nullptr )
+                return 14;
+            std::memset( big, 0x5C, 256 * 1024 );
+            MgrPeer::pptr<MgrPeer::pstring> str = MgrPeer::create_typed<MgrPeer::pstring>();
+            if ( str.is_null() || !str.resolve()->assign( "written by peer" ) )
+                return 15;
+            MgrPeer::set_root( str );
+            MgrPeer::destroy();
+            MgrPeer::backend().close();
+            return 0;
+        } );
+    REQUIRE( rc == 0 );
+
+    REQUIRE( MgrOwner::total_size() > before + 256 * 1024 );
+    REQUIRE( MgrOwner::total_size() == MgrOwner::backend().total_size() );
+    REQUIRE( jobs.size() == 200 );
+    REQUIRE( jobs.find( 150 ).resolve()->value == 300 );
+    auto root = MgrOwner::get_root<MgrOwner::pstring>();
+    REQUIRE( !root.is_null() );
+    REQUIRE( *root.resolve() == "written by peer" );
+    REQUIRE( MgrOwner::allocate( 1024 ) != nullptr );
+    REQUIRE( MgrOwner::verify().ok );
+
+    MgrOwner::destroy();
+    MgrOwner::backend().close();
+    std::remove( kProcessFile );
+}
+
+TEST_CASE( "a peer dying inside the lock leaves a repairable image", "[process][lock]" )
+{
+    std::remove( kProcessFile );
+    REQUIRE( MgrOwner::backend().open( kProcessFile, 64 * 1024 ) );
+    REQUIRE( MgrOwner::create() );
+    REQUIRE( MgrOwner::allocate( 128 ) != nullptr );
+    std::size_t used   = MgrOwner::used_size();
+    std::size_t blocks = MgrOwner::block_count();
+
+    int rc = run_child(
+        []
+        {
+            int err = peer_attach();
+            if ( err != 0 )
+                return err;
+            MgrPeer::for_each_block(
+                []( const auto& )
+                {
+                    auto* hdr = pmm::detail::manager_header_at<pmm::DefaultAddressTraits>(
+                        MgrPeer::backend().base_ptr() );
+                    hdr->used_size   = 1;
+                    hdr->block_count = 1;
+                    ::_exit( 0 );
+                } );
+            return 16;
+        } );
+    REQUIRE( rc == 0 );
+
+    REQUIRE( MgrOwner::used_size() == used );
+    REQUIRE( MgrOwner::block_count() == blocks );
+    REQUIRE( MgrOwner::verify().ok );
+    REQUIRE( MgrOwner::allocate( 64 ) != nullptr );
+
+    MgrOwner::destroy();
+    MgrOwner::backend().close();
+    std::remove( kProcessFile );
+}
+
+TEST_CASE( "an unrecoverable image mutex fails manager calls with LockFailed", "[process][lock]" )
+{
+    std::remove( kProcessFile );
+    REQUIRE( MgrOwner::backend().open( kProcessFile, 64 * 1024 ) );
+    REQUIRE( MgrOwner::create() );
+    REQUIRE( MgrOwner::allocate( 64 ) != nullptr );
+
+    using AT                 = pmm::DefaultAddressTraits;
+    using area_type          = pmm::detail::ProcessLockArea;
+    constexpr size_t kAlign  = alignof( area_type );
+    constexpr size_t kOffset =
+        ( pmm::detail::free_block_tree_reserve_bytes_v<SharedProcessConfig::free_block_tree> + kAlign - 1 ) / kAlign *
+        kAlign;
+    auto* hdr  = pmm::detail::manager_header_at<AT>( MgrOwner::backend().base_ptr() );
+    auto* area = reinterpret_cast<area_type*>( pmm::detail::manager_header_reserve_at<AT>( hdr ) + kOffset );
+    std::thread( [area] { pthread_mutex_lock( &area->mutex ); } ).join();
+    REQUIRE( pthread_mutex_lock( &area->mutex ) == EOWNERDEAD );
+    pthread_mutex_unlock( &area->mutex );
+
+    REQUIRE( MgrOwner::allocate( 64 ) == nullptr );
+    REQUIRE( MgrOwner::last_error() == pmm::PmmError::LockFailed );
+    REQUIRE_FALSE( MgrOwner::is_initialized() );
+    REQUIRE( MgrOwner::used_size() == 0 );
+
+    MgrOwner::destroy();
+    REQUIRE( MgrOwner::create() );
+    REQUIRE( MgrOwner::allocate( 64 ) != nullptr );
+    MgrOwner::destroy();
+    MgrOwner::backend().close();
+    std::remove( kProcessFile );
+}
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * @file test_reserved_heap_storage.cpp
+ * @brief ReservedHeapStorage: growth in place inside a reserved virtual range.
+ *
+ *   - The backend reserves address space once and commits pages as the image grows, so base_ptr() never moves
+ *     and growth copies nothing.
+ *   - shrink_to() decommits the tail pages; growing again hands back zeroed pages at the same address.
+ *   - ReservedHeapConfig swaps the backend into any BasicConfig and caps the reservation at max_memory_gb.
+ */
+
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+using Storage      = pmm::ReservedHeapStorage<pmm::DefaultAddressTraits, 1>;
+using ReservedCfg  = pmm::ReservedHeapConfig<pmm::PersistentDataConfig>;
+using MgrReserved  = pmm::PersistMemoryManager<ReservedCfg, 531>;
+using SmallStorage = pmm::ReservedHeapStorage<pmm::SmallAddressTraits, 64>;
+} // namespace
+
+TEST_CASE( "reserved storage grows without moving the base", "[storage][reserved]" )
+{
+    STATIC_REQUIRE( pmm::storage_has_stable_base_v<Storage> );
+    Storage s;
+    REQUIRE( s.base_ptr() == nullptr );
+    REQUIRE( s.resize_to( 64 * 1024 ) );
+    REQUIRE( s.reserved_size() == std::size_t( 1 ) << 30 );
+    std::uint8_t* base = s.base_ptr();
+    REQUIRE( base != nullptr );
+    std::memset( base, 0xAB, 64 * 1024 );
+
+    REQUIRE( s.resize_to( 8 * 1024 * 1024 ) );
+    REQUIRE( s.base_ptr() == base );
+    REQUIRE( s.total_size() == 8 * 1024 * 1024 );
+    REQUIRE( s.committed_size() >= s.total_size() );
+    REQUIRE( base[64 * 1024 - 1] == 0xAB );
+    REQUIRE( base[8 * 1024 * 1024 - 1] == 0 );
+
+    REQUIRE_FALSE( s.resize_to( 4 * 1024 * 1024 ) );
+    REQUIRE_FALSE( s.resize_to( s.reserved_size() + 4096 ) );
+    REQUIRE( s.base_ptr() == base );
+}
+
+TEST_CASE( "reserved storage shrinks by decommitting the tail", "[storage][reserved]" )
+{
+    Storage s( 4 * 1024 * 1024 );
+    std::uint8_t* base = s.base_ptr();
+    REQUIRE( base != nullptr );
+    std::memset( base, 0x5A, s.total_size() );
+    REQUIRE( s.shrink_to( 64 * 1024 ) );
+    REQUIRE( s.total_size() == 64 * 1024 );
+    REQUIRE( s.committed_size() < 4 * 1024 * 1024 );
+    REQUIRE( base[64 * 1024 - 1] == 0x5A );
+
+    REQUIRE( s.resize_to( 4 * 1024 * 1024 ) );
+    REQUIRE( s.base_ptr() == base );
+    REQUIRE( base[2 * 1024 * 1024] == 0 );
+}
+
+TEST_CASE( "reservation is capped by the index range", "[storage][reserved]" )
+{
+    SmallStorage s;
+    REQUIRE( s.resize_to( 4096 ) );
+    REQUIRE( s.reserved_size() <= ( std::size_t( 1 ) << 16 ) * pmm::SmallAddressTraits::granule_size );
+}
+
+TEST_CASE( "manager on reserved storage keeps its base across growth", "[storage][reserved]" )
+{
+    REQUIRE( MgrReserved::create( 64 * 1024 ) );
+    const std::uint8_t* base = MgrReserved::backend().base_ptr();
+    std::vector<void*>  ptrs;
+    for ( int i = 0; i < 2000; ++i )
+    {
+        void* p = MgrReserved::allocate( 4096 );
+        REQUIRE( p != nullptr );
+        std::memset( p, i & 0xFF, 4096 );
+        ptrs.push_back( p );
+    }
+    REQUIRE( MgrReserved::total_size() > 8 * 1024 * 1024 );
+    REQUIRE( MgrReserved::backend().base_ptr() == base );
+    for ( std::size_t i = 0; i < ptrs.size(); ++i )
+        REQUIRE( static_cast<std::uint8_t*>( ptrs[i] )[4095] == static_cast<std::uint8_t>( i & 0xFF ) );
+    for ( void* p : ptrs )
+        MgrReserved::deallocate( p );
+    REQUIRE( MgrReserved::verify().ok );
+    MgrReserved::destroy();
+}
@@ -0,0 +1,175 @@
+/**
+ * @file test_shrink_to_fit.cpp
+ * @brief shrink_to_fit() / AutoShrinkConfig: returning the trailing free block to the storage backend.
+ *
+ *   - HeapStorage reallocates a smaller buffer; MMapStorage returns the tail pages to its reservation and truncates the file.
+ *   - The shrunken image verifies, keeps its data, grows again on demand and survives reload.
+ *   - AutoShrinkConfig shrinks after deallocation once the free tail exceeds the configured fraction.
+ */
+
+#include "pmm/mmap_storage.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+#include <vector>
+
+namespace
+{
+struct MMapShrinkConfig
+{
+    using address_traits                          = pmm::DefaultAddressTraits;
+    using storage_backend                         = pmm::MMapStorage<address_traits>;
+    using free_block_tree                         = pmm::AvlFreeTree<address_traits>;
+    using lock_policy                             = pmm::config::NoLock;
+    using logging_policy                          = pmm::logging::NoLogging;
+    static constexpr std::size_t granule_size     = address_traits::granule_size;
+    static constexpr std::size_t max_memory_gb    = 0;
+    static constexpr std::size_t grow_numerator   = pmm::config::kDefaultGrowNumerator;
+    static constexpr std::size_t grow_denominator = pmm::config::kDefaultGrowDenominator;
+};
+
+using MgrShrink       = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 470>;
+using MgrShrinkMMap   = pmm::PersistMemoryManager<MMapShrinkConfig, 471>;
+using MgrShrinkAuto   = pmm::PersistMemoryManager<pmm::AutoShrinkConfig<pmm::CacheManagerConfig, 1, 2>, 472>;
+using MgrShrinkArena  = pmm::PersistMemoryManager<pmm::ArenaConfig<pmm::PersistentDataConfig, 2>, 473>;
+using MgrShrinkStatic = pmm::PersistMemoryManager<pmm::EmbeddedStaticConfig<16384>, 474>;
+
+const char* kShrinkFile = "test_shrink_to_fit.dat";
+
+std::size_t file_size( const char* path )
+{
+    struct stat st
+    {
+    };
+    return ::stat( path, &st ) == 0 ? static_cast<std::size_t>( st.st_size ) : 0;
+}
+} // namespace
+
+TEST_CASE( "shrink_to_fit releases the trailing free block of a heap image", "[shrink]" )
+{
+    REQUIRE( MgrShrink::create( 256 * 1024 ) );
+    std::vector<MgrShrink::pptr<std::uint8_t>> ptrs;
+    for ( int i = 0; i < 64; ++i )
+    {
+        auto p = MgrShrink::allocate_typed<std::uint8_t>( 1024 );
+        REQUIRE( !p.is_null() );
+        std::memset( p.resolve(), i, 1024 );
+        ptrs.push_back( p );
+    }
+    for ( std::size_t i = 16; i < ptrs.size(); ++i )
+        MgrShrink::deallocate_typed( ptrs[i] );
+    std::size_t before = MgrShrink::total_size();
+    std::size_t allocs = MgrShrink::alloc_block_count();
+
+    REQUIRE( MgrShrink::shrink_to_fit() );
+    REQUIRE( MgrShrink::total_size() < before / 4 );
+    REQUIRE( MgrShrink::backend().total_size() == MgrShrink::total_size() );
+    REQUIRE( MgrShrink::alloc_block_count() == allocs );
+    REQUIRE( MgrShrink::verify().ok );
+    for ( int i = 0; i < 16; ++i )
+    {
+        REQUIRE( ptrs[i].resolve()[0] == i );
+        REQUIRE( ptrs[i].resolve()[1023] == i );
+    }
+    REQUIRE_FALSE( MgrShrink::shrink_to_fit() );
+    REQUIRE( MgrShrink::verify().ok );
+
+    auto big = MgrShrink::allocate_typed<std::uint8_t>( 64 * 1024 );
+    REQUIRE( !big.is_null() );
+    REQUIRE( MgrShrink::total_size() > 64 * 1024 );
+    REQUIRE( ptrs[15].resolve()[512] == 15 );
+    REQUIRE( MgrShrink::verify().ok );
+    MgrShrink::destroy();
+}
+
+TEST_CASE( "shrink_to_fit truncates a memory-mapped file", "[shrink][mmap]" )
+{
+    std::remove( kShrinkFile );
+    REQUIRE( MgrShrinkMMap::backend().open( kShrinkFile, 512 * 1024 ) );
+    REQUIRE( MgrShrinkMMap::create() );
+    auto keep = MgrShrinkMMap::create_typed<std::uint64_t>( 0x5348524E4B5F4F4BULL );
+    REQUIRE( !keep.is_null() );
+    REQUIRE( file_size( kShrinkFile ) == 512 * 1024 );
+
+    REQUIRE( MgrShrinkMMap::shrink_to_fit() );
+    std::size_t shrunk = MgrShrinkMMap::total_size();
+    REQUIRE( shrunk < 4096 );
+    REQUIRE( file_size( kShrinkFile ) == shrunk );
+    REQUIRE( MgrShrinkMMap::verify().ok );
+    REQUIRE( *keep == 0x5348524E4B5F4F4BULL );
+    auto offset = keep.offset();
+    MgrShrinkMMap::destroy();
+    MgrShrinkMMap::backend().close();
+
+    REQUIRE( MgrShrinkMMap::backend().open( kShrinkFile, shrunk ) );
+    pmm::VerifyResult vr;
+    REQUIRE( MgrShrinkMMap::load( vr ) );
+    REQUIRE( *MgrShrinkMMap::pptr<std::uint64_t>( offset ) == 0x5348524E4B5F4F4BULL );
+    REQUIRE( MgrShrinkMMap::allocate( 16 * 1024 ) != nullptr );
+    REQUIRE( file_size( kShrinkFile ) == MgrShrinkMMap::total_size() );
+    REQUIRE( MgrShrinkMMap::verify().ok );
+    MgrShrinkMMap::destroy();
+    MgrShrinkMMap::backend().close();
+    std::remove( kShrinkFile );
+}
+
+TEST_CASE( "AutoShrinkConfig shrinks once the free tail passes the threshold", "[shrink][auto]" )
+{
+    REQUIRE( MgrShrinkAuto::create( 64 * 1024 ) );
+    auto small = MgrShrinkAuto::allocate_typed<std::uint32_t>( 64 );
+    REQUIRE( !small.is_null() );
+    void* a = MgrShrinkAuto::allocate( 512 * 1024 );
+    REQUIRE( a != nullptr );
+    std::size_t grown = MgrShrinkAuto::total_size();
+    REQUIRE( grown > 512 * 1024 );
+
+    MgrShrinkAuto::deallocate( a );
+    std::size_t shrunk = MgrShrinkAuto::total_size();
+    REQUIRE( shrunk < grown / 4 );
+    REQUIRE( MgrShrinkAuto::verify().ok );
+
+    std::vector<MgrShrinkAuto::pptr<std::uint8_t>> batch;
+    for ( int i = 0; i < 8; ++i )
+        batch.push_back( MgrShrinkAuto::allocate_typed<std::uint8_t>( 64 * 1024 ) );
+    REQUIRE( MgrShrinkAuto::total_size() > shrunk );
+    MgrShrinkAuto::deallocate_batch<std::uint8_t>( batch );
+    REQUIRE( MgrShrinkAuto::total_size() < grown / 4 );
+    REQUIRE( MgrShrinkAuto::verify().ok );
+    REQUIRE( !small.is_null() );
+    MgrShrinkAuto::destroy();
+}
+
+TEST_CASE( "shrink_to_fit keeps sub-arena headers consistent", "[shrink][arena]" )
+{
+    REQUIRE( MgrShrinkArena::create( 64 * 1024 ) );
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 32; ++i )
+        ptrs.push_back( MgrShrinkArena::allocate( 8 * 1024 ) );
+    std::size_t grown = MgrShrinkArena::total_size();
+    for ( std::size_t i = 4; i < ptrs.size(); ++i )
+        MgrShrinkArena::deallocate( ptrs[i] );
+    REQUIRE( MgrShrinkArena::shrink_to_fit() );
+    REQUIRE( MgrShrinkArena::total_size() < grown );
+    REQUIRE( MgrShrinkArena::verify().ok );
+    for ( int i = 0; i < 32; ++i )
+        REQUIRE( MgrShrinkArena::allocate( 4 * 1024 ) != nullptr );
+    REQUIRE( MgrShrinkArena::verify().ok );
+    MgrShrinkArena::destroy();
+}
+
+TEST_CASE( "shrink_to_fit reports unsupported and uninitialized managers", "[shrink]" )
+{
+    REQUIRE_FALSE( MgrShrinkStatic::shrink_to_fit() );
+    REQUIRE( MgrShrinkStatic::last_error() == pmm::PmmError::NotInitialized );
+    REQUIRE( MgrShrinkStatic::create( 16384 ) );
+    REQUIRE_FALSE( MgrShrinkStatic::shrink_to_fit() );
+    REQUIRE( MgrShrinkStatic::last_error() == pmm::PmmError::BackendError );
+    REQUIRE( MgrShrinkStatic::verify().ok );
+    MgrShrinkStatic::destroy();
+}
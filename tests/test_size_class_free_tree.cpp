@@ -0,0 +1,167 @@
+/**
+ * @file test_size_class_free_tree.cpp
+ * @brief SizeClassFreeTree: segregated small-block free lists in front of the AVL free tree.
+ *
+ *   - Small free blocks are kept on per-class lists stored in the image reserve after ManagerHeader.
+ *   - Exact-size reuse, best-fit fallback to the AVL tree, verify()/load() round-trips.
+ */
+
+#include "pmm/io.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using AT          = pmm::DefaultAddressTraits;
+using SizeTree    = pmm::SizeClassFreeTree<AT>;
+using SizeConfig  = pmm::BasicConfig<AT, pmm::config::NoLock, 5, 4, 64, pmm::logging::NoLogging, SizeTree>;
+using MgrSC       = pmm::PersistMemoryManager<SizeConfig, 380>;
+using MgrSCMixed  = pmm::PersistMemoryManager<SizeConfig, 381>;
+using MgrSCSaved  = pmm::PersistMemoryManager<SizeConfig, 382>;
+using MgrSCLoaded = pmm::PersistMemoryManager<SizeConfig, 383>;
+using MgrAvl      = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 384>;
+
+static const char* kSizeClassFile = "test_size_class_free_tree.dat";
+
+template <typename MgrT> static std::size_t listed_free_blocks()
+{
+    std::size_t listed = 0;
+    MgrT::for_each_free_block(
+        [&]( const pmm::FreeBlockView& v )
+        {
+            if ( v.avl_height == 0 )
+                ++listed;
+        } );
+    return listed;
+}
+
+TEST_CASE( "size-class lists hold small holes and reuse them exactly", "[size_class][free_tree]" )
+{
+    REQUIRE( MgrSC::create( 64 * 1024 ) );
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 32; ++i )
+    {
+        void* p = MgrSC::allocate( 48 );
+        REQUIRE( p != nullptr );
+        ptrs.push_back( p );
+    }
+    for ( std::size_t i = 0; i < ptrs.size(); i += 2 )
+        MgrSC::deallocate( ptrs[i] );
+    REQUIRE( listed_free_blocks<MgrSC>() == 16 );
+    REQUIRE( MgrSC::verify().ok );
+
+    void* reused = MgrSC::allocate( 40 );
+    REQUIRE( reused != nullptr );
+    bool found = false;
+    for ( std::size_t i = 0; i < ptrs.size(); i += 2 )
+        found = found || ( ptrs[i] == reused );
+    REQUIRE( found );
+    REQUIRE( listed_free_blocks<MgrSC>() == 15 );
+
+    void* larger = MgrSC::allocate( 64 );
+    REQUIRE( larger != nullptr );
+    REQUIRE( MgrSC::verify().ok );
+    MgrSC::destroy();
+}
+
+TEST_CASE( "size-class lists stay consistent under mixed workload", "[size_class][free_tree]" )
+{
+    REQUIRE( MgrSCMixed::create( 64 * 1024 ) );
+    std::vector<MgrSCMixed::pptr<std::uint8_t>> live;
+    std::uint32_t                               seed = 12345;
+    for ( int step = 0; step < 4000; ++step )
+    {
+        seed = seed * 1103515245U + 12345U;
+        if ( live.empty() || ( seed >> 16 ) % 3 != 0 )
+        {
+            std::size_t size = 16 + ( ( seed >> 8 ) % 24 ) * 16;
+            auto        p    = MgrSCMixed::allocate_typed<std::uint8_t>( size );
+            REQUIRE( !p.is_null() );
+            live.push_back( p );
+        }
+        else
+        {
+            std::size_t victim = ( seed >> 4 ) % live.size();
+            MgrSCMixed::deallocate_typed( live[victim] );
+            live[victim] = live.back();
+            live.pop_back();
+        }
+        if ( step % 500 == 0 )
+            REQUIRE( MgrSCMixed::verify().ok );
+    }
+    for ( auto p : live )
+        MgrSCMixed::deallocate_typed( p );
+    REQUIRE( MgrSCMixed::verify().ok );
+    REQUIRE( listed_free_blocks<MgrSCMixed>() == 0 );
+    MgrSCMixed::destroy();
+}
+
+TEST_CASE( "size-class lists survive save and load", "[size_class][free_tree][persistence]" )
+{
+    REQUIRE( MgrSCSaved::create( 64 * 1024 ) );
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 16; ++i )
+        ptrs.push_back( MgrSCSaved::allocate( 100 ) );
+    for ( std::size_t i = 1; i < ptrs.size(); i += 2 )
+        MgrSCSaved::deallocate( ptrs[i] );
+    std::size_t free_blocks = MgrSCSaved::free_block_count();
+    REQUIRE( pmm::save_manager<MgrSCSaved>( kSizeClassFile ) );
+    MgrSCSaved::destroy();
+
+    REQUIRE( MgrSCLoaded::create( 64 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<MgrSCLoaded>( kSizeClassFile, vr ) );
+    REQUIRE( MgrSCLoaded::verify().ok );
+    REQUIRE( MgrSCLoaded::free_block_count() == free_blocks );
+    void* p = MgrSCLoaded::allocate( 100 );
+    REQUIRE( p != nullptr );
+    REQUIRE( MgrSCLoaded::free_block_count() == free_blocks - 1 );
+    REQUIRE( MgrSCLoaded::verify().ok );
+    MgrSCLoaded::destroy();
+    std::remove( kSizeClassFile );
+}
+
+TEST_CASE( "size-class config rejects images without the list reserve", "[size_class][free_tree][persistence]" )
+{
+    REQUIRE( MgrAvl::create( 64 * 1024 ) );
+    REQUIRE( pmm::save_manager<MgrAvl>( kSizeClassFile ) );
+    MgrAvl::destroy();
+
+    REQUIRE( MgrSCLoaded::create( 64 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE_FALSE( pmm::load_manager_from_file<MgrSCLoaded>( kSizeClassFile, vr ) );
+    REQUIRE( MgrSCLoaded::last_error() == pmm::PmmError::UnsupportedImageVersion );
+    MgrSCLoaded::destroy();
+    std::remove( kSizeClassFile );
+}
+
+TEST_CASE( "verify reports a stale size-class head and load rebuilds it", "[size_class][free_tree][verify]" )
+{
+    REQUIRE( MgrSC::create( 64 * 1024 ) );
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 8; ++i )
+        ptrs.push_back( MgrSC::allocate( 32 ) );
+    MgrSC::deallocate( ptrs[2] );
+    MgrSC::deallocate( ptrs[5] );
+    REQUIRE( MgrSC::verify().ok );
+
+    auto* hdr       = pmm::detail::manager_header_at<AT>( MgrSC::backend().base_ptr() );
+    auto* table     = reinterpret_cast<SizeTree::Table*>( pmm::detail::manager_header_reserve_at<AT>( hdr ) );
+    table->heads[1] = AT::no_block;
+
+    pmm::VerifyResult broken = MgrSC::verify();
+    REQUIRE_FALSE( broken.ok );
+    bool stale = false;
+    for ( std::size_t i = 0; i < broken.entry_count; ++i )
+        stale = stale || broken.entries[i].type == pmm::ViolationType::FreeTreeStale;
+    REQUIRE( stale );
+
+    pmm::VerifyResult repaired;
+    REQUIRE( MgrSC::load( repaired ) );
+    REQUIRE( MgrSC::verify().ok );
+    REQUIRE( listed_free_blocks<MgrSC>() == 2 );
+    MgrSC::destroy();
+}
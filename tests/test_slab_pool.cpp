@@ -0,0 +1,217 @@
+/**
+ * @file test_slab_pool.cpp
+ * @brief pslab / slab_pool_for: headerless fixed-size slots carved out of bitmap-tracked PAP chunks.
+ *
+ *   - pslab<T> hands out granule-aligned slots; a chunk keeps a single block header for all of its slots.
+ *   - Types that specialize slab_pool_for<T> route allocate_typed/create_typed/deallocate_typed through a
+ *     per-type pool registered as a "container/slab/<name>" forest domain.
+ *   - A slot's chunk is found by masking its offset, and chunks with free slots are kept on their own list.
+ *   - Full validation resolves a slot only while its bitmap bit is set.
+ *   - Ordinary blocks of a pooled type (arrays, aligned, batch and reallocated blocks) are told apart from
+ *     pool slots by address and freed through the regular heap.
+ */
+
+#include "pmm/io.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+struct SlabPoint
+{
+    std::uint32_t x;
+    std::uint32_t y;
+};
+struct PlainPoint
+{
+    std::uint32_t x;
+    std::uint32_t y;
+};
+} // namespace
+
+template <> struct pmm::slab_pool_for<SlabPoint>
+{
+    static constexpr const char* name = "test/point";
+};
+
+namespace
+{
+using MgrSlab     = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 500>;
+using MgrSlabSave = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 501>;
+using MgrSlabLoad = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 502>;
+
+const char* kSlabFile = "test_slab_pool.dat";
+} // namespace
+
+TEST_CASE( "pslab packs fixed-size slots without per-object headers", "[slab]" )
+{
+    REQUIRE( MgrSlab::create( 256 * 1024 ) );
+    auto pool = MgrSlab::create_typed<MgrSlab::pslab<PlainPoint>>();
+    REQUIRE( !pool.is_null() );
+    std::size_t                            used_before = MgrSlab::used_size();
+    std::vector<MgrSlab::pptr<PlainPoint>> slots;
+    for ( std::uint32_t i = 0; i < 1000; ++i )
+    {
+        auto p = pool->allocate();
+        REQUIRE( !p.is_null() );
+        PlainPoint* obj = pool->resolve( p );
+        REQUIRE( obj != nullptr );
+        obj->x = i;
+        obj->y = i * 2;
+        slots.push_back( p );
+    }
+    REQUIRE( pool->size() == 1000 );
+    REQUIRE( pool->capacity() >= 1000 );
+    // 1000 separate blocks would need 1000 * 48 bytes; slots cost 16 bytes each plus a few chunk headers.
+    REQUIRE( MgrSlab::used_size() - used_before < 1000 * 24 );
+    for ( std::uint32_t i = 0; i < 1000; ++i )
+        REQUIRE( pool->resolve( slots[i] )->y == i * 2 );
+
+    for ( std::size_t i = 0; i < slots.size(); i += 2 )
+        REQUIRE( pool->deallocate( slots[i] ) );
+    REQUIRE_FALSE( pool->deallocate( slots[0] ) );
+    REQUIRE_FALSE( pool->owns( slots[0] ) );
+    REQUIRE( pool->resolve( slots[0] ) == nullptr );
+    REQUIRE( pool->size() == 500 );
+    auto reused = pool->allocate();
+    REQUIRE( pool->owns( reused ) );
+    REQUIRE( pool->resolve( reused )->x == 0 );
+    REQUIRE( MgrSlab::verify().ok );
+
+    pool->free_all();
+    REQUIRE( pool->empty() );
+    REQUIRE( pool->capacity() == 0 );
+    MgrSlab::destroy_typed( pool );
+    REQUIRE( MgrSlab::used_size() < used_before );
+    REQUIRE( MgrSlab::verify().ok );
+    MgrSlab::destroy();
+}
+
+TEST_CASE( "pslab finds a slot's chunk from the slot offset", "[slab]" )
+{
+    using Pool = MgrSlab::pslab<PlainPoint>;
+    REQUIRE( MgrSlab::create( 1024 * 1024 ) );
+    auto pool = MgrSlab::create_typed<Pool>();
+    REQUIRE( !pool.is_null() );
+    std::vector<MgrSlab::pptr<PlainPoint>> slots;
+    for ( std::uint32_t i = 0; i < 3 * Pool::kChunkSlots + 1; ++i )
+        slots.push_back( pool->allocate() );
+    REQUIRE( pool->capacity() == 4 * Pool::kChunkSlots );
+    for ( auto p : slots )
+    {
+        REQUIRE( !p.is_null() );
+        REQUIRE( p.offset() % Pool::kChunkGranules >= Pool::kDataGranules );
+        REQUIRE( pool->owns( p ) );
+    }
+    auto plain = MgrSlab::allocate_typed<PlainPoint>();
+    REQUIRE_FALSE( pool->contains( plain ) );
+    MgrSlab::deallocate_typed( plain );
+
+    // A freed slot in a full chunk is handed out again without scanning the other chunks.
+    auto last = slots[2 * Pool::kChunkSlots - 1];
+    REQUIRE( pool->deallocate( last ) );
+    REQUIRE( pool->allocate() == last );
+
+    for ( std::uint32_t i = 0; i < Pool::kChunkSlots; ++i )
+        REQUIRE( pool->deallocate( slots[i] ) );
+    REQUIRE( pool->capacity() == 3 * Pool::kChunkSlots );
+    REQUIRE_FALSE( pool->contains( slots[0] ) );
+    REQUIRE( pool->size() == 2 * Pool::kChunkSlots + 1 );
+    REQUIRE( MgrSlab::verify().ok );
+    pool->free_all();
+    MgrSlab::destroy_typed( pool );
+    MgrSlab::destroy();
+}
+
+TEST_CASE( "slab_pool_for routes typed allocation through a per-type pool", "[slab][typed]" )
+{
+    REQUIRE( MgrSlab::create( 256 * 1024 ) );
+    std::size_t                           blocks = MgrSlab::alloc_block_count();
+    std::vector<MgrSlab::pptr<SlabPoint>> points;
+    for ( std::uint32_t i = 0; i < 500; ++i )
+    {
+        auto p = MgrSlab::create_typed<SlabPoint>( SlabPoint{ i, i + 1 } );
+        REQUIRE( !p.is_null() );
+        points.push_back( p );
+    }
+    REQUIRE( MgrSlab::has_domain( "container/slab/test/point" ) );
+    REQUIRE( MgrSlab::alloc_block_count() - blocks < 10 );
+    for ( std::uint32_t i = 0; i < 500; ++i )
+    {
+        REQUIRE( points[i]->x == i );
+        REQUIRE( ( *points[i] ).y == i + 1 );
+    }
+
+    MgrSlab::destroy_typed( points[7] );
+    REQUIRE( points[7].resolve() == nullptr );
+    REQUIRE( MgrSlab::last_error() == pmm::PmmError::InvalidPointer );
+    REQUIRE_FALSE( MgrSlab::is_valid_ptr( points[7] ) );
+    auto again = MgrSlab::allocate_typed<SlabPoint>();
+    REQUIRE( MgrSlab::is_valid_ptr( again ) );
+    REQUIRE( again->x == 0 );
+    MgrSlab::deallocate_typed( again );
+    REQUIRE( MgrSlab::verify().ok );
+    MgrSlab::destroy();
+}
+
+TEST_CASE( "pool slots and ordinary blocks of a pooled type are freed by kind", "[slab][typed]" )
+{
+    REQUIRE( MgrSlab::create( 256 * 1024 ) );
+    auto first = MgrSlab::create_typed<SlabPoint>( SlabPoint{ 1, 2 } );
+    REQUIRE( !first.is_null() );
+    std::size_t blocks = MgrSlab::alloc_block_count();
+
+    auto slot    = MgrSlab::create_typed<SlabPoint>( SlabPoint{ 3, 4 } );
+    auto array   = MgrSlab::allocate_typed<SlabPoint>( 4 );
+    auto aligned = MgrSlab::allocate_typed_aligned<SlabPoint>( 2, 64 );
+    auto grown   = MgrSlab::reallocate_typed( MgrSlab::allocate_typed<SlabPoint>( 2 ), 2, 8 );
+    std::vector<MgrSlab::pptr<SlabPoint>> batch( 3 );
+    REQUIRE( MgrSlab::allocate_batch<SlabPoint>( batch, 2 ) );
+    REQUIRE( MgrSlab::alloc_block_count() == blocks + 6 );
+    for ( auto p : { slot, array, aligned, grown, batch[0], batch[1], batch[2] } )
+    {
+        REQUIRE( !p.is_null() );
+        REQUIRE( MgrSlab::is_valid_ptr( p ) );
+    }
+    REQUIRE( slot->y == 4 );
+
+    MgrSlab::deallocate_typed( array );
+    MgrSlab::deallocate_typed( aligned );
+    MgrSlab::deallocate_typed( slot );
+    MgrSlab::destroy_typed( grown );
+    MgrSlab::deallocate_batch<SlabPoint>( batch );
+    REQUIRE( MgrSlab::alloc_block_count() == blocks );
+    REQUIRE_FALSE( MgrSlab::is_valid_ptr( slot ) );
+    REQUIRE( first->x == 1 );
+    MgrSlab::destroy_typed( first );
+    REQUIRE( MgrSlab::verify().ok );
+    MgrSlab::destroy();
+}
+
+TEST_CASE( "slab-pooled objects survive save and load", "[slab][persistence]" )
+{
+    REQUIRE( MgrSlabSave::create( 128 * 1024 ) );
+    std::vector<MgrSlabSave::index_type> offsets;
+    for ( std::uint32_t i = 0; i < 200; ++i )
+        offsets.push_back( MgrSlabSave::create_typed<SlabPoint>( SlabPoint{ i * 3, i } ).offset() );
+    REQUIRE( pmm::save_manager<MgrSlabSave>( kSlabFile ) );
+    MgrSlabSave::destroy();
+
+    REQUIRE( MgrSlabLoad::create( 128 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<MgrSlabLoad>( kSlabFile, vr ) );
+    for ( std::uint32_t i = 0; i < 200; ++i )
+        REQUIRE( MgrSlabLoad::pptr<SlabPoint>( offsets[i] )->x == i * 3 );
+    auto extra = MgrSlabLoad::create_typed<SlabPoint>( SlabPoint{ 9, 9 } );
+    REQUIRE( !extra.is_null() );
+    for ( auto off : offsets )
+        REQUIRE( extra.offset() != off );
+    REQUIRE( MgrSlabLoad::verify().ok );
+    MgrSlabLoad::destroy();
+    std::remove( kSlabFile );
+}
@@ -398,3 +398,23 @@ TEST_CASE( "grow factor >= 25%", "[test_stress_auto_grow]" )
 
     MgrT::destroy();
 }
+
+TEST_CASE( "expand after an allocated tail keeps the header counters", "[test_stress_auto_grow]" )
+{
+    using MgrT = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 705>;
+
+    REQUIRE( MgrT::create( 8UL * 1024 ) );
+    std::size_t grows = 0;
+    for ( int i = 0; i < 4000 && grows < 6; ++i )
+    {
+        std::size_t size_before = MgrT::total_size();
+        REQUIRE( MgrT::allocate( 48 ) != nullptr );
+        if ( MgrT::total_size() == size_before )
+            continue;
+        ++grows;
+        REQUIRE( MgrT::verify().ok );
+    }
+    REQUIRE( grows == 6 );
+
+    MgrT::destroy();
+}
@@ -0,0 +1,161 @@
+/**
+ * @file test_thread_cache.cpp
+ * @brief Per-thread allocation caches for ThreadCachedConfig managers.
+ *
+ *   - Small Generic blocks are recycled through a thread-local cache without the exclusive lock.
+ *   - Caches are returned to the image on flush_thread_caches(), thread exit, destroy() and save_manager().
+ *   - A cached block is marked in its header, so freeing it again is rejected like any double free.
+ */
+
+#include "pmm/io.h"
+#include "pmm/persist_memory_manager.h"
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using CachedConfig = pmm::ThreadCachedConfig<pmm::PersistentDataConfig, pmm::config::ThreadCache<128, 8, 4>>;
+using MgrTC        = pmm::PersistMemoryManager<CachedConfig, 390>;
+using MgrTCThreads = pmm::PersistMemoryManager<CachedConfig, 391>;
+using MgrTCSaved   = pmm::PersistMemoryManager<CachedConfig, 392>;
+using MgrTCLoaded  = pmm::PersistMemoryManager<CachedConfig, 393>;
+using MgrTCCycle   = pmm::PersistMemoryManager<CachedConfig, 394>;
+
+static const char* kThreadCacheFile = "test_thread_cache.dat";
+
+static_assert( MgrTC::kThreadCacheEnabled );
+static_assert( pmm::presets::MultiThreadedCachedHeap::kThreadCacheEnabled );
+static_assert( !pmm::presets::MultiThreadedHeap::kThreadCacheEnabled );
+
+TEST_CASE( "thread cache recycles small blocks and flushes them back", "[thread_cache]" )
+{
+    REQUIRE( MgrTC::create( 64 * 1024 ) );
+    std::size_t baseline = MgrTC::alloc_block_count();
+
+    void* a = MgrTC::allocate( 48 );
+    REQUIRE( a != nullptr );
+    REQUIRE( MgrTC::alloc_block_count() > baseline + 1 );
+    MgrTC::deallocate( a );
+    void* b = MgrTC::allocate( 40 );
+    REQUIRE( b == a );
+    MgrTC::deallocate( b );
+
+    void* big = MgrTC::allocate( 1024 );
+    REQUIRE( big != nullptr );
+    MgrTC::deallocate( big );
+    REQUIRE( MgrTC::verify().ok );
+
+    MgrTC::flush_thread_caches();
+    REQUIRE( MgrTC::alloc_block_count() == baseline );
+    REQUIRE( MgrTC::verify().ok );
+    MgrTC::destroy();
+}
+
+TEST_CASE( "a repeated free of a cached block is rejected", "[thread_cache]" )
+{
+    REQUIRE( MgrTC::create( 64 * 1024 ) );
+    std::size_t baseline = MgrTC::alloc_block_count();
+
+    void* a = MgrTC::allocate( 48 );
+    REQUIRE( a != nullptr );
+    MgrTC::deallocate( a );
+    MgrTC::deallocate( a );
+    std::thread( [a]() { MgrTC::deallocate( a ); } ).join();
+
+    void* b = MgrTC::allocate( 48 );
+    void* c = MgrTC::allocate( 48 );
+    REQUIRE( b != nullptr );
+    REQUIRE( c != nullptr );
+    REQUIRE( b != c );
+    MgrTC::deallocate( b );
+    MgrTC::deallocate( c );
+    MgrTC::deallocate( c );
+
+    MgrTC::flush_thread_caches();
+    REQUIRE( MgrTC::alloc_block_count() == baseline );
+    REQUIRE( MgrTC::verify().ok );
+    MgrTC::destroy();
+}
+
+TEST_CASE( "thread caches are returned when threads exit", "[thread_cache][threads]" )
+{
+    REQUIRE( MgrTCThreads::create( 256 * 1024 ) );
+    std::size_t              baseline = MgrTCThreads::alloc_block_count();
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < 4; ++t )
+    {
+        threads.emplace_back(
+            [t]()
+            {
+                std::vector<MgrTCThreads::pptr<std::uint8_t>> live;
+                std::uint32_t                                 seed = 777U + static_cast<std::uint32_t>( t );
+                for ( int step = 0; step < 2000; ++step )
+                {
+                    seed = seed * 1103515245U + 12345U;
+                    if ( live.size() < 16 && ( seed >> 16 ) % 3 != 0 )
+                    {
+                        auto p = MgrTCThreads::allocate_typed<std::uint8_t>( 8 + ( seed >> 8 ) % 160 );
+                        if ( !p.is_null() )
+                            live.push_back( p );
+                    }
+                    else if ( !live.empty() )
+                    {
+                        MgrTCThreads::deallocate_typed( live.back() );
+                        live.pop_back();
+                    }
+                }
+                for ( auto p : live )
+                    MgrTCThreads::deallocate_typed( p );
+            } );
+    }
+    for ( auto& th : threads )
+        th.join();
+    REQUIRE( MgrTCThreads::alloc_block_count() == baseline );
+    REQUIRE( MgrTCThreads::verify().ok );
+    MgrTCThreads::destroy();
+}
+
+TEST_CASE( "save_manager writes an image without cached blocks", "[thread_cache][persistence]" )
+{
+    REQUIRE( MgrTCSaved::create( 64 * 1024 ) );
+    std::size_t baseline = MgrTCSaved::alloc_block_count();
+    auto        keep     = MgrTCSaved::allocate_typed<std::uint32_t>( 4 );
+    REQUIRE( !keep.is_null() );
+    for ( int i = 0; i < 6; ++i )
+        MgrTCSaved::deallocate( MgrTCSaved::allocate( 32 ) );
+    REQUIRE( pmm::save_manager<MgrTCSaved>( kThreadCacheFile ) );
+    REQUIRE( MgrTCSaved::alloc_block_count() == baseline + 1 );
+    MgrTCSaved::destroy();
+
+    REQUIRE( MgrTCLoaded::create( 64 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<MgrTCLoaded>( kThreadCacheFile, vr ) );
+    REQUIRE( MgrTCLoaded::alloc_block_count() == baseline + 1 );
+    REQUIRE( MgrTCLoaded::verify().ok );
+    MgrTCLoaded::destroy();
+    std::remove( kThreadCacheFile );
+}
+
+TEST_CASE( "destroy and create do not leak stale cache entries", "[thread_cache]" )
+{
+    REQUIRE( MgrTCCycle::create( 64 * 1024 ) );
+    std::size_t baseline = MgrTCCycle::alloc_block_count();
+    MgrTCCycle::deallocate( MgrTCCycle::allocate( 64 ) );
+    MgrTCCycle::destroy();
+    REQUIRE( MgrTCCycle::allocate( 64 ) == nullptr );
+    REQUIRE( MgrTCCycle::last_error() == pmm::PmmError::NotInitialized );
+
+    REQUIRE( MgrTCCycle::create( 64 * 1024 ) );
+    REQUIRE( MgrTCCycle::alloc_block_count() == baseline );
+    void* p = MgrTCCycle::allocate( 64 );
+    REQUIRE( p != nullptr );
+    MgrTCCycle::deallocate( p );
+    MgrTCCycle::flush_thread_caches();
+    REQUIRE( MgrTCCycle::alloc_block_count() == baseline );
+    REQUIRE( MgrTCCycle::verify().ok );
+    MgrTCCycle::destroy();
+}
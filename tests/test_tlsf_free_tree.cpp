@@ -0,0 +1,187 @@
+/**
+ * @file test_tlsf_free_tree.cpp
+ * @brief TlsfFreeTree: two-level segregated fit free lists with bitmaps in the image reserve.
+ *
+ *   - Every free block sits on a (first-level, second-level) list; lookups use two bit scans.
+ *   - Rounded-up search, same-class fallback, verify()/load() round-trips.
+ */
+
+#include "pmm/io.h"
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using AT          = pmm::DefaultAddressTraits;
+using TlsfTree    = pmm::TlsfFreeTree<AT>;
+using TlsfConfig  = pmm::BasicConfig<AT, pmm::config::NoLock, 5, 4, 64, pmm::logging::NoLogging, TlsfTree>;
+using MgrTlsf     = pmm::PersistMemoryManager<TlsfConfig, 430>;
+using MgrTlsfMix  = pmm::PersistMemoryManager<TlsfConfig, 431>;
+using MgrTlsfSave = pmm::PersistMemoryManager<TlsfConfig, 432>;
+using MgrTlsfLoad = pmm::PersistMemoryManager<TlsfConfig, 433>;
+using MgrAvlImage = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 434>;
+
+struct TlsfStaticConfig : pmm::EmbeddedStaticConfig<64 * 1024>
+{
+    using free_block_tree = TlsfTree;
+};
+using MgrTlsfStatic = pmm::PersistMemoryManager<TlsfStaticConfig, 435>;
+
+static const char* kTlsfFile = "test_tlsf_free_tree.dat";
+
+template <typename MgrT> static std::size_t listed_free_blocks()
+{
+    std::size_t listed = 0;
+    MgrT::for_each_free_block(
+        [&]( const pmm::FreeBlockView& v )
+        {
+            if ( v.avl_height == 0 )
+                ++listed;
+        } );
+    return listed;
+}
+
+TEST_CASE( "tlsf lists hold every free block and reuse holes", "[tlsf][free_tree]" )
+{
+    REQUIRE( MgrTlsf::create( 64 * 1024 ) );
+    REQUIRE( listed_free_blocks<MgrTlsf>() == MgrTlsf::free_block_count() );
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 32; ++i )
+    {
+        void* p = MgrTlsf::allocate( 48 + 16 * ( i % 4 ) );
+        REQUIRE( p != nullptr );
+        ptrs.push_back( p );
+    }
+    for ( std::size_t i = 0; i < ptrs.size(); i += 2 )
+        MgrTlsf::deallocate( ptrs[i] );
+    REQUIRE( listed_free_blocks<MgrTlsf>() == MgrTlsf::free_block_count() );
+    REQUIRE( MgrTlsf::verify().ok );
+
+    void* reused = MgrTlsf::allocate( 40 );
+    REQUIRE( reused != nullptr );
+    bool found = false;
+    for ( std::size_t i = 0; i < ptrs.size(); i += 2 )
+        found = found || ( ptrs[i] == reused );
+    REQUIRE( found );
+    REQUIRE( MgrTlsf::verify().ok );
+    MgrTlsf::destroy();
+}
+
+TEST_CASE( "tlsf lists stay consistent under mixed workload", "[tlsf][free_tree]" )
+{
+    REQUIRE( MgrTlsfMix::create( 64 * 1024 ) );
+    std::size_t                                 frees = MgrTlsfMix::free_block_count();
+    std::vector<MgrTlsfMix::pptr<std::uint8_t>> live;
+    std::uint32_t                               seed = 4242;
+    for ( int step = 0; step < 4000; ++step )
+    {
+        seed = seed * 1103515245U + 12345U;
+        if ( live.empty() || ( seed >> 16 ) % 3 != 0 )
+        {
+            std::size_t size = 16 + ( ( seed >> 8 ) % 300 ) * 8;
+            auto        p    = MgrTlsfMix::allocate_typed<std::uint8_t>( size );
+            REQUIRE( !p.is_null() );
+            live.push_back( p );
+        }
+        else
+        {
+            std::size_t victim = ( seed >> 4 ) % live.size();
+            MgrTlsfMix::deallocate_typed( live[victim] );
+            live[victim] = live.back();
+            live.pop_back();
+        }
+        if ( step % 500 == 0 )
+            REQUIRE( MgrTlsfMix::verify().ok );
+    }
+    for ( auto p : live )
+        MgrTlsfMix::deallocate_typed( p );
+    REQUIRE( MgrTlsfMix::verify().ok );
+    REQUIRE( MgrTlsfMix::free_block_count() == frees );
+    MgrTlsfMix::destroy();
+}
+
+TEST_CASE( "tlsf falls back to the request's own class before failing", "[tlsf][free_tree]" )
+{
+    REQUIRE( MgrTlsfStatic::create( 64 * 1024 ) );
+    std::vector<void*> ptrs;
+    for ( void* p = MgrTlsfStatic::allocate( 1600 ); p != nullptr; p = MgrTlsfStatic::allocate( 1600 ) )
+        ptrs.push_back( p );
+    REQUIRE( ptrs.size() > 4 );
+    void* hole = ptrs[ptrs.size() / 2];
+    MgrTlsfStatic::deallocate( hole );
+    REQUIRE( MgrTlsfStatic::verify().ok );
+
+    void* p = MgrTlsfStatic::allocate( 1584 );
+    REQUIRE( p == hole );
+    REQUIRE( MgrTlsfStatic::verify().ok );
+    MgrTlsfStatic::destroy();
+}
+
+TEST_CASE( "tlsf lists survive save and load", "[tlsf][free_tree][persistence]" )
+{
+    REQUIRE( MgrTlsfSave::create( 64 * 1024 ) );
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 16; ++i )
+        ptrs.push_back( MgrTlsfSave::allocate( 100 + 64 * i ) );
+    for ( std::size_t i = 1; i < ptrs.size(); i += 2 )
+        MgrTlsfSave::deallocate( ptrs[i] );
+    std::size_t free_blocks = MgrTlsfSave::free_block_count();
+    REQUIRE( pmm::save_manager<MgrTlsfSave>( kTlsfFile ) );
+    MgrTlsfSave::destroy();
+
+    REQUIRE( MgrTlsfLoad::create( 64 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<MgrTlsfLoad>( kTlsfFile, vr ) );
+    REQUIRE( MgrTlsfLoad::verify().ok );
+    REQUIRE( MgrTlsfLoad::free_block_count() == free_blocks );
+    REQUIRE( listed_free_blocks<MgrTlsfLoad>() == free_blocks );
+    REQUIRE( MgrTlsfLoad::allocate( 100 ) != nullptr );
+    REQUIRE( MgrTlsfLoad::verify().ok );
+    MgrTlsfLoad::destroy();
+    std::remove( kTlsfFile );
+}
+
+TEST_CASE( "tlsf config rejects images without the bitmap reserve", "[tlsf][free_tree][persistence]" )
+{
+    REQUIRE( MgrAvlImage::create( 64 * 1024 ) );
+    REQUIRE( pmm::save_manager<MgrAvlImage>( kTlsfFile ) );
+    MgrAvlImage::destroy();
+
+    REQUIRE( MgrTlsfLoad::create( 64 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE_FALSE( pmm::load_manager_from_file<MgrTlsfLoad>( kTlsfFile, vr ) );
+    REQUIRE( MgrTlsfLoad::last_error() == pmm::PmmError::UnsupportedImageVersion );
+    MgrTlsfLoad::destroy();
+    std::remove( kTlsfFile );
+}
+
+TEST_CASE( "verify reports a stale tlsf bitmap and load rebuilds it", "[tlsf][free_tree][verify]" )
+{
+    REQUIRE( MgrTlsf::create( 64 * 1024 ) );
+    std::vector<void*> ptrs;
+    for ( int i = 0; i < 8; ++i )
+        ptrs.push_back( MgrTlsf::allocate( 32 ) );
+    MgrTlsf::deallocate( ptrs[2] );
+    MgrTlsf::deallocate( ptrs[5] );
+    REQUIRE( MgrTlsf::verify().ok );
+
+    auto* hdr        = pmm::detail::manager_header_at<AT>( MgrTlsf::backend().base_ptr() );
+    auto* table      = reinterpret_cast<TlsfTree::Table*>( pmm::detail::manager_header_reserve_at<AT>( hdr ) );
+    table->fl_bitmap = 0;
+
+    pmm::VerifyResult broken = MgrTlsf::verify();
+    REQUIRE_FALSE( broken.ok );
+    bool stale = false;
+    for ( std::size_t i = 0; i < broken.entry_count; ++i )
+        stale = stale || broken.entries[i].type == pmm::ViolationType::FreeTreeStale;
+    REQUIRE( stale );
+
+    pmm::VerifyResult repaired;
+    REQUIRE( MgrTlsf::load( repaired ) );
+    REQUIRE( MgrTlsf::verify().ok );
+    REQUIRE( listed_free_blocks<MgrTlsf>() == MgrTlsf::free_block_count() );
+    MgrTlsf::destroy();
+}
@@ -0,0 +1,172 @@
+/**
+ * @file test_trace_logging.cpp
+ * @brief TraceLogging: binary allocation traces for offline replay.
+ *
+ *   - Every allocate / deallocate / reallocate (single and batch) appends one 24-byte record.
+ *   - Handles are assigned per allocation and survive reallocation, so a replay can follow an object.
+ *   - Frees are recorded inside the locked release, so concurrent threads never see a freed offset reused
+ *     before its Deallocate record; slab-pooled slots are traced like ordinary blocks.
+ *   - read_trace_file() rejects files without the trace header.
+ */
+
+#include "pmm/persist_memory_manager.h"
+#include "pmm/trace_logging.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct TracedPoint
+{
+    std::uint32_t x;
+    std::uint32_t y;
+};
+} // namespace
+
+template <> struct pmm::slab_pool_for<TracedPoint>
+{
+    static constexpr const char* name = "test/traced_point";
+};
+
+namespace
+{
+using pmm::logging::TraceOp;
+using pmm::logging::TraceRecord;
+using MgrTrace = pmm::PersistMemoryManager<
+    pmm::BasicConfig<pmm::DefaultAddressTraits, pmm::config::NoLock, 5, 4, 64, pmm::logging::TraceLogging>, 523>;
+using MgrTraceShared = pmm::PersistMemoryManager<
+    pmm::BasicConfig<pmm::DefaultAddressTraits, pmm::config::SharedMutexLock, 5, 4, 64, pmm::logging::TraceLogging>,
+    524>;
+
+const char* kTraceFile = "test_trace_logging.trace";
+} // namespace
+
+TEST_CASE( "trace hooks are detected only on recording policies", "[trace]" )
+{
+    STATIC_REQUIRE( pmm::detail::logs_trace_v<pmm::logging::TraceLogging> );
+    STATIC_REQUIRE_FALSE( pmm::detail::logs_trace_v<pmm::logging::NoLogging> );
+    STATIC_REQUIRE_FALSE( pmm::detail::logs_trace_v<pmm::logging::HistogramLogging> );
+}
+
+TEST_CASE( "TraceLogging records allocations, reallocations and frees", "[trace]" )
+{
+    REQUIRE( MgrTrace::create( 64 * 1024 ) );
+    void* before = MgrTrace::allocate( 16 );
+    REQUIRE( pmm::logging::TraceLogging::open( kTraceFile ) );
+    REQUIRE_FALSE( pmm::logging::TraceLogging::open( kTraceFile ) );
+
+    void* a = MgrTrace::allocate( 32 );
+    auto  b = MgrTrace::allocate_typed<std::uint8_t>( 64 );
+    b       = MgrTrace::reallocate_typed<std::uint8_t>( b, 64, 4000 );
+    REQUIRE( !b.is_null() );
+    MgrTrace::deallocate( a );
+    MgrTrace::deallocate( before );
+    std::vector<MgrTrace::pptr<std::uint64_t>> batch( 3 );
+    REQUIRE( MgrTrace::allocate_batch<std::uint64_t>( batch ) );
+    MgrTrace::deallocate_batch<std::uint64_t>( batch );
+    MgrTrace::deallocate_typed( b );
+    REQUIRE( pmm::logging::TraceLogging::recorded() == 11 );
+    REQUIRE( pmm::logging::TraceLogging::close() );
+    MgrTrace::destroy();
+
+    std::vector<TraceRecord> trace;
+    REQUIRE( pmm::logging::read_trace_file( kTraceFile, trace ) );
+    REQUIRE( trace.size() == 11 );
+    REQUIRE( trace[0].op == TraceOp::Allocate );
+    REQUIRE( trace[0].size == 32 );
+    REQUIRE( trace[1].op == TraceOp::Allocate );
+    REQUIRE( trace[2].op == TraceOp::Realloc );
+    REQUIRE( trace[2].handle == trace[1].handle );
+    REQUIRE( trace[2].size == 4000 );
+    REQUIRE( trace[3].op == TraceOp::Deallocate );
+    REQUIRE( trace[3].handle == trace[0].handle );
+    std::set<std::uint64_t> batch_handles;
+    for ( size_t i = 4; i < 7; ++i )
+    {
+        REQUIRE( trace[i].op == TraceOp::Allocate );
+        REQUIRE( trace[i].size == sizeof( std::uint64_t ) );
+        batch_handles.insert( trace[i].handle );
+    }
+    for ( size_t i = 7; i < 10; ++i )
+    {
+        REQUIRE( trace[i].op == TraceOp::Deallocate );
+        REQUIRE( batch_handles.count( trace[i].handle ) == 1 );
+    }
+    REQUIRE( trace[10].op == TraceOp::Deallocate );
+    REQUIRE( trace[10].handle == trace[1].handle );
+    for ( size_t i = 1; i < trace.size(); ++i )
+        REQUIRE( trace[i].timestamp_ns >= trace[i - 1].timestamp_ns );
+    std::remove( kTraceFile );
+}
+
+TEST_CASE( "slab-pooled slots are traced like ordinary blocks", "[trace][slab]" )
+{
+    REQUIRE( MgrTrace::create( 64 * 1024 ) );
+    MgrTrace::destroy_typed( MgrTrace::create_typed<TracedPoint>( TracedPoint{ 0, 0 } ) );
+    REQUIRE( pmm::logging::TraceLogging::open( kTraceFile ) );
+    auto p = MgrTrace::create_typed<TracedPoint>( TracedPoint{ 1, 2 } );
+    REQUIRE( !p.is_null() );
+    MgrTrace::destroy_typed( p );
+    REQUIRE( pmm::logging::TraceLogging::close() );
+    MgrTrace::destroy();
+
+    std::vector<TraceRecord> trace;
+    REQUIRE( pmm::logging::read_trace_file( kTraceFile, trace ) );
+    REQUIRE( trace.size() == 2 );
+    REQUIRE( trace[0].op == TraceOp::Allocate );
+    REQUIRE( trace[0].size == sizeof( TracedPoint ) );
+    REQUIRE( trace[1].op == TraceOp::Deallocate );
+    REQUIRE( trace[1].handle == trace[0].handle );
+    std::remove( kTraceFile );
+}
+
+TEST_CASE( "concurrent frees are recorded before their offsets are reused", "[trace][thread]" )
+{
+    REQUIRE( MgrTraceShared::create( 256 * 1024 ) );
+    REQUIRE( pmm::logging::TraceLogging::open( kTraceFile ) );
+    std::vector<std::thread> workers;
+    for ( int t = 0; t < 4; ++t )
+        workers.emplace_back(
+            []
+            {
+                for ( int i = 0; i < 250; ++i )
+                    MgrTraceShared::deallocate( MgrTraceShared::allocate( 32 ) );
+            } );
+    for ( auto& w : workers )
+        w.join();
+    REQUIRE( pmm::logging::TraceLogging::close() );
+    MgrTraceShared::destroy();
+
+    std::vector<TraceRecord> trace;
+    REQUIRE( pmm::logging::read_trace_file( kTraceFile, trace ) );
+    REQUIRE( trace.size() == 2000 );
+    std::map<std::uint64_t, int> state;
+    for ( const TraceRecord& r : trace )
+    {
+        int& s = state[r.handle];
+        REQUIRE( s == ( r.op == TraceOp::Allocate ? 0 : 1 ) );
+        ++s;
+    }
+    REQUIRE( state.size() == 1000 );
+    std::remove( kTraceFile );
+}
+
+TEST_CASE( "read_trace_file rejects foreign files", "[trace]" )
+{
+    std::vector<TraceRecord> trace;
+    REQUIRE_FALSE( pmm::logging::read_trace_file( "missing.trace", trace ) );
+    std::FILE* f = std::fopen( kTraceFile, "wb" );
+    REQUIRE( f != nullptr );
+    std::fputs( "not a trace file at all", f );
+    std::fclose( f );
+    REQUIRE_FALSE( pmm::logging::read_trace_file( kTraceFile, trace ) );
+    REQUIRE( trace.empty() );
+    std::remove( kTraceFile );
+}
@@ -0,0 +1,92 @@
+/**
+ * @file test_validation_policy.cpp
+ * @brief validation_policy: full, debug-only or no block checks when a pptr is dereferenced.
+ *
+ *   - FullValidation (default) rejects pointers that do not address a live block.
+ *   - DebugValidation / NoValidation resolve with a single offset computation; resolve_checked() and
+ *     is_valid_ptr() keep the full checks for callers that need them.
+ */
+
+#include "pmm/persist_memory_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace
+{
+using AT = pmm::DefaultAddressTraits;
+template <typename Policy>
+using ValidationConfig = pmm::BasicConfig<AT, pmm::config::NoLock, 5, 4, 64, pmm::logging::NoLogging,
+                                          pmm::AvlFreeTree<AT>, Policy>;
+using MgrFull  = pmm::PersistMemoryManager<ValidationConfig<pmm::config::FullValidation>, 480>;
+using MgrDebug = pmm::PersistMemoryManager<ValidationConfig<pmm::config::DebugValidation>, 481>;
+using MgrNone  = pmm::PersistMemoryManager<ValidationConfig<pmm::config::NoValidation>, 482>;
+
+template <typename MgrT> void exercise_containers()
+{
+    REQUIRE( MgrT::create( 256 * 1024 ) );
+    typename MgrT::template pmap<int, int> map( "validation" );
+    for ( int i = 0; i < 500; ++i )
+        REQUIRE( !map.insert( i, i * 3 ).is_null() );
+    for ( int i = 0; i < 500; ++i )
+    {
+        auto node = map.find( i );
+        REQUIRE( !node.is_null() );
+        REQUIRE( node->value == i * 3 );
+    }
+    REQUIRE( map.find( 1000 ).is_null() );
+    auto arr = MgrT::template create_typed<typename MgrT::template parray<std::uint32_t>>();
+    for ( std::uint32_t i = 0; i < 64; ++i )
+        REQUIRE( arr->push_back( i ) );
+    REQUIRE( *arr->at( 63 ) == 63u );
+    REQUIRE( MgrT::verify().ok );
+    MgrT::destroy();
+}
+} // namespace
+
+TEST_CASE( "configs default to full validation", "[validation]" )
+{
+    STATIC_REQUIRE( std::is_same_v<pmm::PersistMemoryManager<pmm::CacheManagerConfig, 480>::validation_policy,
+                                   pmm::config::FullValidation> );
+    STATIC_REQUIRE( std::is_same_v<pmm::PersistMemoryManager<pmm::EmbeddedStaticConfig<>, 480>::validation_policy,
+                                   pmm::config::FullValidation> );
+    STATIC_REQUIRE( std::is_same_v<MgrNone::validation_policy, pmm::config::NoValidation> );
+}
+
+TEST_CASE( "every validation policy resolves live containers", "[validation][pmap]" )
+{
+    exercise_containers<MgrFull>();
+    exercise_containers<MgrDebug>();
+    exercise_containers<MgrNone>();
+}
+
+TEST_CASE( "full validation rejects a pointer into a freed block", "[validation]" )
+{
+    REQUIRE( MgrFull::create( 64 * 1024 ) );
+    auto p = MgrFull::allocate_typed<std::uint64_t>();
+    REQUIRE( !p.is_null() );
+    MgrFull::deallocate_typed( p );
+    REQUIRE( p.resolve() == nullptr );
+    REQUIRE( MgrFull::last_error() == pmm::PmmError::InvalidPointer );
+    MgrFull::destroy();
+}
+
+TEST_CASE( "no validation resolves by offset and keeps explicit checks", "[validation]" )
+{
+    REQUIRE( MgrNone::create( 64 * 1024 ) );
+    auto p = MgrNone::allocate_typed<std::uint64_t>();
+    REQUIRE( !p.is_null() );
+    *p = 0x4E4F434845434BULL;
+    std::uint8_t* expected = MgrNone::backend().base_ptr() + static_cast<std::size_t>( p.offset() ) * AT::granule_size;
+    REQUIRE( reinterpret_cast<std::uint8_t*>( p.resolve() ) == expected );
+    REQUIRE( MgrNone::resolve_checked( p ) == p.resolve() );
+    REQUIRE( MgrNone::pptr<std::uint64_t>().resolve() == nullptr );
+
+    MgrNone::deallocate_typed( p );
+    REQUIRE( reinterpret_cast<std::uint8_t*>( p.resolve() ) == expected );
+    REQUIRE_FALSE( MgrNone::is_valid_ptr( p ) );
+    REQUIRE( MgrNone::resolve_checked( p ) == nullptr );
+    MgrNone::destroy();
+}